@@ -1,12 +1,13 @@
 #include "board_init.h"
 #include "config/spi_config.h"
 #include "config/pins.h"
+#include "board/spi_bus.h"
 
 BoardBringupReport board_init() {
   BoardBringupReport r;
 
   r.i2c_ok = board_i2c_begin_with_pins(PIN_I2C_SDA, PIN_I2C_SCL, I2C_FREQ);
-  r.spi_ok = board_spi_begin(44, 43, 14, -1);
+  r.spi_ok = board_spi_begin(PIN_SPI_SCK, PIN_SPI_MISO, PIN_SPI_MOSI, -1);
 
   // Make sure all SPI devices are deselected BEFORE SPI starts
   pinMode(PIN_CS_BMI270, OUTPUT);
@@ -59,15 +60,10 @@ BoardBringupReport board_i2c_scan(TwoWire& bus, uint8_t addr_min, uint8_t addr_m
   return r;
 }
 
-bool board_spi_begin(int sck, int miso, int mosi, int ss) {
+bool board_spi_begin(int sck, int miso, int mosi, int /*ss*/) {
   // If pins are left as -1, use default SPI pins for the selected board.
-  // For StampFly you may need to provide explicit pins later.
-  if (sck >= 0 && miso >= 0 && mosi >= 0) {
-    SPI.begin(sck, miso, mosi, ss);
-  } else {
-    SPI.begin();
-  }
-  return true;
+  // Arduino SPI or the ESP-IDF DMA driver, see board/spi_bus.h
+  return spi_bus_begin(sck, miso, mosi);
 }
 
 void board_print_report(const BoardBringupReport& r) {
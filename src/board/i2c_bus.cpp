@@ -0,0 +1,116 @@
+#include "i2c_bus.h"
+
+bool I2cBus::start(uint8_t prio, int8_t core, uint32_t stack_bytes)
+{
+#if I2C_BUS_TASK
+  if (task_) return true;
+  return xTaskCreatePinnedToCore(task_entry_, "i2c", stack_bytes, this, prio,
+                                 &task_, core) == pdPASS;
+#else
+  (void)prio;
+  (void)core;
+  (void)stack_bytes;
+  return true;
+#endif
+}
+
+uint8_t I2cBus::add_device(const char* name, uint8_t addr7)
+{
+  if (n_dev_ >= MAX_DEVICES) return I2C_DEV_NONE;
+  dev_[n_dev_].name = name;
+  dev_[n_dev_].addr7 = addr7;
+  return (uint8_t)n_dev_++;
+}
+
+bool I2cBus::submit(I2cTxn& t)
+{
+  I2cDevStats* st = t.dev < n_dev_ ? &dev_[t.dev] : nullptr;
+
+  if (task_) {
+    portENTER_CRITICAL(&mux_);
+    const bool ok = q_.push(&t, micros());
+    if (!ok && st) st->rejected++;
+    portEXIT_CRITICAL(&mux_);
+    if (ok) xTaskNotifyGive(task_);
+    return ok;
+  }
+
+  // Boot, or I2C_BUS_TASK=0: right here
+  if (t.busy()) {
+    if (st) st->rejected++;
+    return false;
+  }
+  t.ok = false;
+  t.t_submit_us = micros();
+  t.t_start_us = t.t_submit_us;
+  t.state = I2cTxnState::ACTIVE;
+  execute_(t);
+  return true;
+}
+
+// GPIO ISR context (Arduino's GPIO ISR service is installed with
+// ESP_INTR_FLAG_IRAM): everything here is in IRAM or DRAM, queue push
+// included (i2c_queue.h)
+bool IRAM_ATTR I2cBus::submit_from_isr(I2cTxn& t)
+{
+  if (!task_) return false;
+  I2cDevStats* st = t.dev < n_dev_ ? &dev_[t.dev] : nullptr;
+
+  portENTER_CRITICAL_ISR(&mux_);
+  const bool ok = q_.push(&t, micros());
+  if (!ok && st) st->rejected++;
+  portEXIT_CRITICAL_ISR(&mux_);
+  if (ok) {
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(task_, &woken);
+    if (woken) portYIELD_FROM_ISR();
+  }
+  return ok;
+}
+
+bool I2cBus::run(I2cTxn& t)
+{
+  if (!submit(t)) return false;
+  // Wire's own timeout bounds this
+  while (t.busy()) vTaskDelay(1);
+  return t.ok;
+}
+
+void I2cBus::task_entry_(void* arg)
+{
+  I2cBus& b = *static_cast<I2cBus*>(arg);
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    for (;;) {
+      portENTER_CRITICAL(&b.mux_);
+      I2cTxn* t = b.q_.pop(micros());
+      portEXIT_CRITICAL(&b.mux_);
+      if (!t) break;
+      b.execute_(*t);
+    }
+  }
+}
+
+void I2cBus::execute_(I2cTxn& t)
+{
+  t.ok = t.job ? t.job(t.ctx) : transfer_(t);
+  t.t_done_us = micros();
+
+  // Bus task only (inline: each device has a single caller)
+  if (t.dev < n_dev_) dev_[t.dev].add(t);
+
+  if (t.done_fn) t.done_fn(t, t.ctx);
+  t.complete();
+}
+
+bool I2cBus::transfer_(I2cTxn& t)
+{
+  wire_->beginTransmission(t.addr7);
+  for (uint8_t i = 0; i < t.tx_len; i++) wire_->write(t.tx[i]);
+  if (t.rx_len == 0) return wire_->endTransmission(true) == 0;
+
+  if (wire_->endTransmission(false) != 0) return false;   // repeated start
+  if (wire_->requestFrom(t.addr7, t.rx_len) != t.rx_len) return false;
+  for (uint8_t i = 0; i < t.rx_len; i++) t.rx[i] = (uint8_t)wire_->read();
+  return true;
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <Arduino.h>
+#include <Wire.h>
+
+#include "board/i2c_queue.h"
+
+// I2C bus manager: one task owns Wire and runs queued transactions
+// (board/i2c_queue.h) most urgent first. Everyone else submits and gets
+// on with its work: the slow group queues its ToF slot, the report group
+// its power/baro/mag reads, and none of them waits on the bus.
+//
+//   boot:   begin(Wire); drivers' begin() run their transactions inline
+//   start() the task (config/rate_groups.h: prio, core, stack); from then
+//           on Wire belongs to it
+//
+// Results come back through the I2cTxn (poll done()) or its done_fn.
+// run() submits and waits: boot and the report group only.
+// submit_from_isr() lets a data-ready interrupt queue its own fetch.
+//
+// I2C_BUS_TASK=0: no task; every transaction runs inline in the caller,
+// as the drivers did before (stats are still kept).
+#ifndef I2C_BUS_TASK
+#define I2C_BUS_TASK 1
+#endif
+
+class I2cBus {
+ public:
+  static constexpr int MAX_DEVICES = 8;
+
+  void begin(TwoWire& wire) { wire_ = &wire; }
+  bool start(uint8_t prio, int8_t core, uint32_t stack_bytes);
+  bool started() const { return task_ != nullptr; }
+
+  // Stats slot for a device; I2C_DEV_NONE when the table is full
+  uint8_t add_device(const char* name, uint8_t addr7);
+
+  // Queue t (false while it is still busy, or the queue is full)
+  bool submit(I2cTxn& t);
+
+  // From a GPIO ISR. False before start() (nobody to run it) and whenever
+  // submit() would be.
+  bool IRAM_ATTR submit_from_isr(I2cTxn& t);
+
+  // Submit and wait for the result
+  bool run(I2cTxn& t);
+
+  // Wire for library drivers' begin() (boot) and inside jobs
+  TwoWire& wire() { return *wire_; }
+
+  int devices() const { return n_dev_; }
+  const I2cDevStats& stats(int dev) const { return dev_[dev]; }
+  const I2cQueue& queue() const { return q_; }
+
+ private:
+  static void task_entry_(void* arg);
+  void execute_(I2cTxn& t);
+  bool transfer_(I2cTxn& t);
+
+  TwoWire* wire_ = &Wire;
+  TaskHandle_t task_ = nullptr;
+  portMUX_TYPE mux_ = portMUX_INITIALIZER_UNLOCKED;
+  I2cQueue q_;
+  I2cDevStats dev_[MAX_DEVICES];
+  int n_dev_ = 0;
+};
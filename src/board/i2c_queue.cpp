@@ -0,0 +1,38 @@
+#include "i2c_queue.h"
+
+I2cTxn* I2cQueue::pop(uint32_t now_us)
+{
+  if (n_ == 0) return nullptr;
+
+  int best = 0;
+  for (int i = 1; i < n_; i++) {
+    const I2cTxn* a = q_[i];
+    const I2cTxn* b = q_[best];
+    if (a->prio > b->prio ||
+        (a->prio == b->prio && (int32_t)(a->seq - b->seq) < 0)) {
+      best = i;
+    }
+  }
+
+  // Order lives in seq, so the last entry can fill the hole
+  I2cTxn* t = q_[best];
+  q_[best] = q_[--n_];
+  q_[n_] = nullptr;
+
+  t->t_start_us = now_us;
+  t->state = I2cTxnState::ACTIVE;
+  return t;
+}
+
+void I2cDevStats::add(const I2cTxn& t)
+{
+  const uint32_t wait = t.t_start_us - t.t_submit_us;
+  const uint32_t bus = t.t_done_us - t.t_start_us;
+  txns++;
+  if (!t.ok) errors++;
+  sum_wait_us += wait;
+  sum_bus_us += bus;
+  if (wait > max_wait_us) max_wait_us = wait;
+  if (bus > max_bus_us) max_bus_us = bus;
+  if (wait + bus > max_lat_us) max_lat_us = wait + bus;
+}
@@ -0,0 +1,142 @@
+#pragma once
+#include <stdint.h>
+
+#include "utils/spsc.h"
+
+// Transactions and the priority queue of the I2C bus manager
+// (board/i2c_bus.h).
+//
+// A transaction is either a register access (write tx, then read rx after
+// a repeated start) or a job: a function that gets Wire to itself on the
+// bus task, for drivers that talk to Wire through a library (VL53LX,
+// INA3221). The submitter owns the I2cTxn and uses it as a future: it is
+// untouched while busy(), and done() once ok / rx / the times are final.
+// done_fn, if set, runs on the bus task right before that.
+//
+// No Arduino dependencies (host test: test/i2c_queue_test.cpp).
+
+#ifdef ESP_PLATFORM
+#include <esp_attr.h>
+#elif !defined(IRAM_ATTR)
+#define IRAM_ATTR
+#endif
+
+// Most urgent first; FIFO within a priority
+enum class I2cPrio : uint8_t {
+  BACKGROUND = 0,   // diagnostics
+  SENSOR,           // power, baro, mag
+  RANGING,          // ToF slot (the stagger runs on its timing)
+};
+
+enum class I2cTxnState : uint8_t {
+  IDLE = 0,
+  QUEUED,
+  ACTIVE,
+  DONE,
+};
+
+static constexpr uint8_t I2C_DEV_NONE = 0xFF;   // no stats slot
+
+struct I2cTxn;
+using I2cJobFn = bool (*)(void* ctx);               // true = ok
+using I2cDoneFn = void (*)(I2cTxn& t, void* ctx);
+
+struct I2cTxn {
+  // Request: set before submit, left alone while busy()
+  uint8_t dev = I2C_DEV_NONE;       // I2cBus::add_device() id (stats)
+  I2cPrio prio = I2cPrio::SENSOR;
+  uint8_t addr7 = 0;
+  const uint8_t* tx = nullptr;      // register address (+ data)
+  uint8_t tx_len = 0;
+  uint8_t* rx = nullptr;            // then read with a repeated start
+  uint8_t rx_len = 0;
+  I2cJobFn job = nullptr;           // instead of tx/rx
+  I2cDoneFn done_fn = nullptr;
+  void* ctx = nullptr;
+
+  // Result
+  volatile I2cTxnState state = I2cTxnState::IDLE;
+  bool ok = false;
+  uint32_t t_submit_us = 0;
+  uint32_t t_start_us = 0;
+  uint32_t t_done_us = 0;
+  uint32_t seq = 0;                 // queue order
+
+  bool busy() const { return state == I2cTxnState::QUEUED || state == I2cTxnState::ACTIVE; }
+  bool done() const { return state == I2cTxnState::DONE; }
+
+  // Register access helpers
+  void set_read(uint8_t addr, const uint8_t* reg, uint8_t* buf, uint8_t n)
+  {
+    addr7 = addr; tx = reg; tx_len = 1; rx = buf; rx_len = n; job = nullptr;
+  }
+  void set_write(uint8_t addr, const uint8_t* data, uint8_t n)
+  {
+    addr7 = addr; tx = data; tx_len = n; rx = nullptr; rx_len = 0; job = nullptr;
+  }
+
+  // Bus side, last: everything above is final before the submitter sees it
+  void complete()
+  {
+    spsc_fence();
+    state = I2cTxnState::DONE;
+  }
+};
+
+// Fixed capacity, no heap. The caller serialises access (I2cBus holds a
+// spinlock around push/pop; producers are on both cores).
+class I2cQueue {
+ public:
+  static constexpr int CAPACITY = 16;
+
+  // False (and counted) when full or t is still busy. In IRAM: GPIO ISRs
+  // push too (I2cBus::submit_from_isr), with the flash cache possibly off.
+  bool IRAM_ATTR push(I2cTxn* t, uint32_t now_us)
+  {
+    if (!t || t->state == I2cTxnState::QUEUED || t->state == I2cTxnState::ACTIVE ||
+        n_ >= CAPACITY) {
+      rejected_++;
+      return false;
+    }
+    t->state = I2cTxnState::QUEUED;
+    t->ok = false;
+    t->t_submit_us = now_us;
+    t->seq = seq_++;
+    q_[n_++] = t;
+    if (n_ > max_n_) max_n_ = n_;
+    return true;
+  }
+
+  // Most urgent, oldest first; marks it ACTIVE. nullptr when empty.
+  I2cTxn* pop(uint32_t now_us);
+
+  int size() const { return n_; }
+  int max_depth() const { return max_n_; }
+  uint32_t rejected() const { return rejected_; }
+
+ private:
+  I2cTxn* q_[CAPACITY] = {};
+  int n_ = 0;
+  int max_n_ = 0;
+  uint32_t seq_ = 0;
+  uint32_t rejected_ = 0;
+};
+
+// Per device, cumulative. wait = submit -> start (queued behind others),
+// bus = start -> done (on the wire), latency = submit -> done.
+struct I2cDevStats {
+  const char* name = nullptr;
+  uint8_t addr7 = 0;                // 0: several (the ToF job)
+  uint32_t txns = 0;
+  uint32_t errors = 0;
+  uint32_t rejected = 0;            // submit refused (still busy, queue full)
+  uint32_t max_wait_us = 0;
+  uint32_t max_bus_us = 0;
+  uint32_t max_lat_us = 0;
+  uint64_t sum_wait_us = 0;
+  uint64_t sum_bus_us = 0;
+
+  void add(const I2cTxn& t);
+  uint32_t avg_wait_us() const { return txns ? (uint32_t)(sum_wait_us / txns) : 0; }
+  uint32_t avg_bus_us() const { return txns ? (uint32_t)(sum_bus_us / txns) : 0; }
+};
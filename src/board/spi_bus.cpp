@@ -0,0 +1,222 @@
+#include "spi_bus.h"
+
+#if SPI_BUS_IDF
+#include <esp_heap_caps.h>
+#endif
+
+// --- Bus --- //
+
+bool spi_bus_begin(int sck, int miso, int mosi)
+{
+#if SPI_BUS_IDF
+  spi_bus_config_t bus = {};
+  bus.mosi_io_num = mosi;
+  bus.miso_io_num = miso;
+  bus.sclk_io_num = sck;
+  bus.quadwp_io_num = -1;
+  bus.quadhd_io_num = -1;
+  bus.max_transfer_sz = SpiDevice::DMA_BUF_BYTES;
+  return spi_bus_initialize(SPI2_HOST, &bus, SPI_DMA_CH_AUTO) == ESP_OK;
+#else
+  if (sck >= 0 && miso >= 0 && mosi >= 0) {
+    SPI.begin(sck, miso, mosi, -1);
+  } else {
+    SPI.begin();
+  }
+  return true;
+#endif
+}
+
+// --- Device --- //
+
+bool SpiDevice::begin(int cs_pin, uint32_t hz, uint8_t mode)
+{
+  cs_ = cs_pin;
+  pinMode(cs_, OUTPUT);
+  digitalWrite(cs_, HIGH);
+
+#if SPI_BUS_IDF
+  spi_device_interface_config_t dc = {};
+  dc.mode = mode;
+  dc.clock_speed_hz = (int)hz;
+  dc.spics_io_num = -1;   // CS is ours, see header
+  dc.queue_size = 1;
+  if (spi_bus_add_device(SPI2_HOST, &dc, &handle_) != ESP_OK) return false;
+
+  // Internal RAM, DMA-capable; flash-resident data (the BMI270 config blob)
+  // is copied in here since DMA can't read flash.
+  tx_buf_ = (uint8_t*)heap_caps_malloc(DMA_BUF_BYTES, MALLOC_CAP_DMA);
+  rx_buf_ = (uint8_t*)heap_caps_malloc(DMA_BUF_BYTES, MALLOC_CAP_DMA);
+  return tx_buf_ && rx_buf_;
+#else
+  const uint8_t modes[4] = { SPI_MODE0, SPI_MODE1, SPI_MODE2, SPI_MODE3 };
+  settings_ = SPISettings(hz, MSBFIRST, modes[mode & 3]);
+  return true;
+#endif
+}
+
+void SpiDevice::select()
+{
+#if SPI_BUS_IDF
+  spi_device_acquire_bus(handle_, portMAX_DELAY);
+#else
+  SPI.beginTransaction(settings_);
+#endif
+  digitalWrite(cs_, LOW);
+}
+
+void SpiDevice::deselect()
+{
+  digitalWrite(cs_, HIGH);
+#if SPI_BUS_IDF
+  spi_device_release_bus(handle_);
+#else
+  SPI.endTransaction();
+#endif
+}
+
+#if SPI_BUS_IDF
+// Clock n bytes out of tx_buf_ (into rx_buf_ if want_rx)
+bool SpiDevice::run_buf_(uint32_t n, bool want_rx)
+{
+  stats_.transfers++;
+  stats_.bytes += n;
+
+  spi_transaction_t t = {};
+  t.length = n * 8;
+  t.tx_buffer = tx_buf_;
+  t.rx_buffer = want_rx ? rx_buf_ : nullptr;
+
+  esp_err_t err;
+  if (n <= SPI_POLL_MAX) {
+    err = spi_device_polling_transmit(handle_, &t);
+  } else {
+    // Task sleeps until the DMA done interrupt; the core is free meanwhile
+    const uint32_t t0 = micros();
+    spi_transaction_t* done = nullptr;
+    err = spi_device_queue_trans(handle_, &t, portMAX_DELAY);
+    if (err == ESP_OK) err = spi_device_get_trans_result(handle_, &done, portMAX_DELAY);
+    stats_.wait_us += micros() - t0;
+  }
+  if (err != ESP_OK) stats_.errors++;
+  return err == ESP_OK;
+}
+#endif
+
+bool SpiDevice::transfer(const uint8_t* tx, uint8_t* rx, uint32_t n)
+{
+#if SPI_BUS_IDF
+  bool ok = true;
+  while (n > 0) {
+    const uint32_t c = n < DMA_BUF_BYTES ? n : DMA_BUF_BYTES;
+    if (tx) {
+      memcpy(tx_buf_, tx, c);
+      tx += c;
+    } else {
+      memset(tx_buf_, 0xFF, c);   // same filler as the Arduino backend
+    }
+    ok = run_buf_(c, rx != nullptr) && ok;
+    if (rx) {
+      memcpy(rx, rx_buf_, c);
+      rx += c;
+    }
+    n -= c;
+  }
+  return ok;
+#else
+  if (n == 0) return true;
+  stats_.transfers++;
+  stats_.bytes += n;
+  if (rx) {
+    SPI.transferBytes(tx, rx, n);   // null tx clocks out 0xFF
+  } else if (tx) {
+    SPI.writeBytes(tx, n);
+  }
+  return true;
+#endif
+}
+
+uint8_t SpiDevice::transfer_byte(uint8_t v)
+{
+#if SPI_BUS_IDF
+  uint8_t r = 0;
+  transfer(&v, &r, 1);
+  return r;
+#else
+  stats_.transfers++;
+  stats_.bytes++;
+  return SPI.transfer(v);
+#endif
+}
+
+bool SpiDevice::read_reg(uint8_t addr, uint8_t* data, uint32_t n)
+{
+  select();
+#if SPI_BUS_IDF
+  // Address + data in one DMA transaction when it fits
+  if (n + 1 <= DMA_BUF_BYTES) {
+    memset(tx_buf_, 0xFF, n + 1);
+    tx_buf_[0] = addr;
+    const bool ok = run_buf_(n + 1, true);
+    memcpy(data, rx_buf_ + 1, n);
+    deselect();
+    return ok;
+  }
+#endif
+  bool ok = transfer(&addr, nullptr, 1);
+  ok = transfer(nullptr, data, n) && ok;
+  deselect();
+  return ok;
+}
+
+bool SpiDevice::write_reg(uint8_t addr, const uint8_t* data, uint32_t n)
+{
+  select();
+#if SPI_BUS_IDF
+  if (n + 1 <= DMA_BUF_BYTES) {
+    tx_buf_[0] = addr;
+    memcpy(tx_buf_ + 1, data, n);
+    const bool ok = run_buf_(n + 1, false);
+    deselect();
+    return ok;
+  }
+#endif
+  bool ok = transfer(&addr, nullptr, 1);
+  ok = transfer(data, nullptr, n) && ok;
+  deselect();
+  return ok;
+}
+
+// --- Benchmark --- //
+
+void spi_bus_bench(SpiDevice& dev, uint8_t addr)
+{
+  static uint8_t buf[SpiDevice::DMA_BUF_BYTES];
+  static const uint32_t sizes[] = { 12, 128, 421 };  // data regs, Bosch max read, full FIFO drain
+  constexpr int REPS = 50;
+
+  Serial.printf("[spi bench] backend=%s reps=%d\n", SPI_BUS_IDF ? "idf-dma" : "arduino", REPS);
+
+  for (uint32_t n : sizes) {
+    // Old glue pattern: one SPI call per byte
+    uint32_t t0 = micros();
+    for (int r = 0; r < REPS; r++) {
+      dev.select();
+      dev.transfer_byte(addr);
+      for (uint32_t i = 0; i < n; i++) buf[i] = dev.transfer_byte(0x00);
+      dev.deselect();
+    }
+    const float per_byte_us = (float)(micros() - t0) / REPS;
+
+    // One bulk transfer
+    const uint32_t wait0 = dev.stats().wait_us;
+    t0 = micros();
+    for (int r = 0; r < REPS; r++) dev.read_reg(addr, buf, n);
+    const float bulk_us = (float)(micros() - t0) / REPS;
+    const float cpu_us = bulk_us - (float)(dev.stats().wait_us - wait0) / REPS;
+
+    Serial.printf("[spi bench] n=%lu per-byte %.1fus (%.2f B/us) | bulk %.1fus (%.2f B/us) cpu %.1fus\n",
+                  (unsigned long)n, per_byte_us, (n + 1) / per_byte_us,
+                  bulk_us, (n + 1) / bulk_us, cpu_us);
+  }
+}
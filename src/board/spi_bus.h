@@ -0,0 +1,83 @@
+#pragma once
+#include <Arduino.h>
+#include <SPI.h>
+
+// Shared SPI bus for the StampFly SPI devices (BMI270, PMW3901).
+//
+// SPI_BUS_IDF=0: Arduino SPIClass. Bulk transfers go through
+//                SPI.transferBytes() (hardware FIFO, one call per transfer).
+// SPI_BUS_IDF=1: ESP-IDF spi_master on SPI2_HOST with DMA. The bus driver
+//                owns the pins, so every device on it must go through
+//                SpiDevice (SPI.* calls would fight the driver).
+//                Transfers up to SPI_POLL_MAX bytes use
+//                spi_device_polling_transmit (lowest latency); longer ones
+//                are queued and the calling task blocks while DMA runs.
+//
+// CS is a plain GPIO driven here rather than by the peripheral, so a
+// select() .. deselect() window can span several transfers with delays in
+// between (the PMW3901 needs that).
+#ifndef SPI_BUS_IDF
+#define SPI_BUS_IDF 0
+#endif
+
+// SPI_BENCH=1: run spi_bus_bench() on the BMI270 at boot
+#ifndef SPI_BENCH
+#define SPI_BENCH 0
+#endif
+
+#if SPI_BUS_IDF
+#include <driver/spi_master.h>
+#endif
+
+struct SpiBusStats {
+  uint32_t transfers = 0;
+  uint32_t bytes = 0;
+  uint32_t wait_us = 0;   // time the caller was blocked on DMA (CPU free)
+  uint32_t errors = 0;    // transfers the driver refused (IDF backend)
+};
+
+class SpiDevice {
+ public:
+  static constexpr uint32_t DMA_BUF_BYTES = 512;  // largest single DMA chunk
+  static constexpr uint32_t SPI_POLL_MAX = 64;
+
+  bool begin(int cs_pin, uint32_t hz, uint8_t mode);
+
+  // Take the bus and assert CS / release both
+  void select();
+  void deselect();
+
+  // Inside select()/deselect(). tx may be null (clocks out 0xFF on both
+  // backends, as SPI.transferBytes() does), rx may be null. False if the
+  // driver failed a transfer (rx is then not to be trusted); the Arduino
+  // backend has no way to fail.
+  bool transfer(const uint8_t* tx, uint8_t* rx, uint32_t n);
+  uint8_t transfer_byte(uint8_t v);
+
+  // One CS-framed register access: address byte then n data bytes.
+  // Same failure rule as transfer().
+  bool read_reg(uint8_t addr, uint8_t* data, uint32_t n);
+  bool write_reg(uint8_t addr, const uint8_t* data, uint32_t n);
+
+  const SpiBusStats& stats() const { return stats_; }
+  void reset_stats() { stats_ = SpiBusStats{}; }
+
+ private:
+  int cs_ = -1;
+  SpiBusStats stats_;
+#if SPI_BUS_IDF
+  bool run_buf_(uint32_t n, bool want_rx);
+  spi_device_handle_t handle_ = nullptr;
+  uint8_t* tx_buf_ = nullptr;   // DMA-capable, allocated once in begin()
+  uint8_t* rx_buf_ = nullptr;
+#else
+  SPISettings settings_;
+#endif
+};
+
+// Bring up the bus (before any SpiDevice::begin)
+bool spi_bus_begin(int sck, int miso, int mosi);
+
+// Transfer-size sweep on one device: per-byte loop (the old glue's pattern)
+// vs one bulk transfer, reading from addr. Prints [spi bench] lines.
+void spi_bus_bench(SpiDevice& dev, uint8_t addr);
@@ -1,5 +1,6 @@
 #include "spi_probe.h"
 #include "config/spi_config.h"
+#include "board/spi_bus.h"
 #include <SPI.h>
 
 static uint8_t spi_read_raw(int cs, uint8_t reg, const SPISettings& s)
@@ -44,6 +45,11 @@ static uint8_t spi_read_bmi270_reg(int cs, uint8_t reg, const SPISettings& s)
 
 void spi_probe_devices()
 {
+#if SPI_BUS_IDF
+  // Raw SPI.* calls would fight the ESP-IDF bus driver
+  Serial.println("\n[SPI PROBE] skipped (SPI_BUS_IDF=1)");
+  return;
+#endif
   pinMode(PIN_CS_BMI270, OUTPUT);
   pinMode(PIN_CS_PMW3901, OUTPUT);
   digitalWrite(PIN_CS_BMI270, HIGH);
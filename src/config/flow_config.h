@@ -0,0 +1,22 @@
+#pragma once
+#include "estimation/flow_velocity.h"
+
+// PMW3901 on the StampFly, looking down. Change optics/mounting here only.
+//
+// Scale: 35 px across a 42 deg field of view, 2*sin(21 deg) = 0.7167 rad,
+// and the motion counts come in tenths of a pixel (the Bitcraze/Crazyflie
+// flow deck model, measured there). At 1 m and 121 Hz one count is ~0.25 m/s.
+//
+// Axes: dx/dy are sensor axes. The maps below follow the board layout but
+// haven't been checked in flight. Check: rotate the craft by hand over a
+// textured surface, [flow vel] should stay near zero (else flip rot[]);
+// slide it forward, v F should go positive (else flip body[]).
+static constexpr FlowOptics FLOW_OPTICS = {
+  10.0f * 35.0f / 0.71674f,  // px_per_rad (counts)
+  { {1, -1}, {0, +1} },      // body F = -dy, R = dx
+  { {1, +1}, {0, -1} },      // F: gy > 0 is nose up, R: gx > 0 is right wing down
+  30,                        // min_squal (FlowSample::quality_ok)
+  0.08f,                     // min_height_m: datasheet focus range from 80 mm
+  4.0f,                      // max_height_m: ToF range
+  7.4f,                      // max_rate_rad_s: datasheet max speed at 80 mm
+};
@@ -0,0 +1,31 @@
+#pragma once
+#include "sensors/imu/bmi270_config.h"
+#include "utils/filters.h"
+
+// BMI270 on the StampFly. Change ranges/ODR here only: scaling, FIFO timing
+// and the body remap follow.
+//
+// Oversampled: the sensor runs at 1.6 kHz (the accel maximum; both share the
+// ODR so every FIFO frame carries accel + gyro) and IMU_DECIM brings it down
+// to IMU_OUT_HZ before anything else sees it. Vibration above the output
+// Nyquist is filtered instead of aliasing into the rate loop.
+static constexpr Bmi270Config IMU_CFG = {
+  BMI2_ACC_RANGE_4G,       // ±4 g
+  BMI2_GYR_RANGE_2000,     // ±2000 dps
+  BMI2_ACC_ODR_1600HZ,     // accel + gyro
+  BMI2_ACC_NORMAL_AVG4,
+  BMI2_GYR_NORMAL_MODE,
+  // FRU body: x = sensor y, y = sensor x, z = sensor z
+  { {1, +1}, {0, +1}, {2, +1} },
+};
+
+static_assert(IMU_CFG.valid(), "IMU_CFG: unknown range/ODR or body[] is not a signed axis permutation");
+
+// 1.6 kHz -> 400 Hz. 2nd-order CIC: adds only, 1.9 ms group delay, -1.7 dB
+// at 100 Hz. FirDecimator<4, 16, 6> with FIR_DECIM4_16_Q15 is the sharper
+// (and slower, 4.7 ms) alternative.
+static constexpr uint8_t IMU_DECIM = 4;
+using ImuDecimator = CicDecimator<IMU_DECIM, 2, 6>;   // acc xyz, gyr xyz
+
+static constexpr uint32_t IMU_OUT_HZ = IMU_CFG.odr_hz() / IMU_DECIM;
+static_assert(IMU_CFG.odr_hz() % IMU_DECIM == 0, "IMU_DECIM must divide the ODR");
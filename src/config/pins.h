@@ -7,6 +7,10 @@ static constexpr int PIN_I2C_SDA = 3; // G3
 static constexpr int PIN_I2C_SCL = 4; // G4
 static constexpr uint32_t I2C_FREQ = 100000;
 
+// BMI270 INT1 (FIFO watermark -> fast group release). -1 = not wired:
+// the fast group then polls at its nominal rate.
+static constexpr int PIN_IMU_INT1 = 11; // G11
+
 // ToF-1 (down)
 static constexpr int PIN_TOF1_XSHUT = 7; // G7
 static constexpr int PIN_TOF1_GPIO1 = 6; // G6
@@ -15,11 +19,13 @@ static constexpr int PIN_TOF1_GPIO1 = 6; // G6
 static constexpr int PIN_TOF2_XSHUT = 9; // G9
 static constexpr int PIN_TOF2_GPIO1 = 8; // G8
 
-// ToF addresses (7-bit)
-static constexpr uint8_t TOF_ADDR7_FRONT = 0x29; // front stays default
+// ToF addresses (7-bit). Both move off the default 0x29: a sensor reset
+// at runtime (stuck-sensor recovery) comes back there, and must not
+// collide with the other one.
+static constexpr uint8_t TOF_ADDR7_FRONT = 0x31; // front gets moved here
 static constexpr uint8_t TOF_ADDR7_DOWN  = 0x30; // down gets moved here
 
-// ToF addresses (8-bit, for InitSensor())
-static constexpr uint8_t TOF_ADDR8_FRONT = (TOF_ADDR7_FRONT << 1); // 0x52
+// ToF addresses (8-bit, for VL53LX_SetDeviceAddress())
+static constexpr uint8_t TOF_ADDR8_FRONT = (TOF_ADDR7_FRONT << 1); // 0x62
 static constexpr uint8_t TOF_ADDR8_DOWN  = (TOF_ADDR7_DOWN  << 1); // 0x60
 
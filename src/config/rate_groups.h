@@ -0,0 +1,46 @@
+#pragma once
+#include "utils/rate_group.h"
+
+// Rate-group table. Shared by the firmware scheduler (main.cpp) and the
+// host simulator (test/rate_scheduler_test.cpp) so both check the same thing.
+//
+// Priorities follow FreeRTOS (higher = more urgent). For reference: Arduino
+// loopTask runs at 1, esp_timer at 22, Wi-Fi on core 0 at ~23.
+// Core 1 is the Arduino APP core; the report group lives on core 0 so its
+// Serial prints never compete with sensor reads.
+
+static constexpr uint32_t FAST_HZ   = 400;  // IMU (BMI270 1.6 kHz ODR / FIFO watermark of 4)
+static constexpr uint32_t FLOW_HZ   = 121;  // PMW3901 frame rate
+static constexpr uint32_t SLOW_HZ   = 40;   // ToF: down and front take turns (20 Hz each)
+static constexpr uint32_t REPORT_HZ = 1;    // power/pres/mag + telemetry print
+static constexpr uint32_t SPEC_HZ   = 20;   // gyro FFT (a frame every 80 ms, drained in batches)
+
+static constexpr uint32_t FAST_PERIOD_US   = 1000000UL / FAST_HZ;
+static constexpr uint32_t FLOW_PERIOD_US   = 1000000UL / FLOW_HZ;   // 8264 us
+static constexpr uint32_t SLOW_PERIOD_US   = 1000000UL / SLOW_HZ;
+static constexpr uint32_t REPORT_PERIOD_US = 1000000UL / REPORT_HZ;
+static constexpr uint32_t SPEC_PERIOD_US   = 1000000UL / SPEC_HZ;
+
+// The fast group is released by the BMI270 INT1 edge (FIFO watermark), so it
+// runs on the sensor's clock instead of ours; FAST_HZ must match the sensor
+// ODR / ImuBmi270::INT1_WM_FRAMES. Without edges it polls at FAST_HZ.
+// That caps it at an integer fraction of the ODR: 500 Hz is not one of
+// 1.6 kHz (or the gyro-only 3.2 kHz), so 400 Hz is the closest we get.
+//                                   name      period            prio core stack clock
+static constexpr RateGroupDef RG_FAST   = {"fast",   FAST_PERIOD_US,   5,   1,   4096, RateClock::EXTERNAL};
+// Flow: one read per sensor frame. 8.264 ms isn't a whole number of RTOS
+// ticks, hence the esp_timer clock. The PMW3901 accumulates motion between
+// reads, so timer/sensor clock drift costs nothing but the odd empty read.
+static constexpr RateGroupDef RG_FLOW   = {"flow",   FLOW_PERIOD_US,   4,   1,   4096, RateClock::HW_TIMER};
+static constexpr RateGroupDef RG_SLOW   = {"slow",   SLOW_PERIOD_US,   3,   1,   4096, RateClock::RTOS_TICK};
+static constexpr RateGroupDef RG_REPORT = {"report", REPORT_PERIOD_US, 2,   0,   6144, RateClock::RTOS_TICK};
+// Lowest of all, on core 0: a slow FFT frame can only delay itself
+static constexpr RateGroupDef RG_SPEC   = {"spec",   SPEC_PERIOD_US,   1,   0,   4096, RateClock::RTOS_TICK};
+
+// I2C bus manager task (board/i2c_bus.h). Not a rate group: it wakes when
+// a transaction is queued. Above report and spec on core 0 so queued work
+// starts at once; it sleeps on the I2C driver during transfers, so they
+// lose no CPU to it. No core 1 group touches Wire.
+static constexpr uint8_t  I2C_BUS_PRIO  = 3;
+static constexpr int8_t   I2C_BUS_CORE  = 0;
+static constexpr uint32_t I2C_BUS_STACK = 4096;
@@ -3,10 +3,17 @@
 
 // StampFly known-good SPI settings (Phase 0 probe verified)
 
+// Shared bus pins
+static constexpr int PIN_SPI_SCK  = 44;
+static constexpr int PIN_SPI_MISO = 43;
+static constexpr int PIN_SPI_MOSI = 14;
+
 // BMI270 IMU
 static constexpr int PIN_CS_BMI270 = 46;
+static constexpr uint32_t SPI_BMI270_HZ = 8000000;   // 8 MHz (match official baseline)
+static constexpr uint8_t SPI_BMI270_MODE = 0;
 static const SPISettings SPI_BMI270_SETTINGS(
-    8000000,      // 8 MHz (match official baseline)
+    SPI_BMI270_HZ,
     MSBFIRST,
     SPI_MODE0
 );
@@ -14,8 +21,10 @@ static const SPISettings SPI_BMI270_SETTINGS(
 
 // PMW3901 optical flow
 static constexpr int PIN_CS_PMW3901 = 12;
+static constexpr uint32_t SPI_PMW3901_HZ = 1000000;  // 1 MHz
+static constexpr uint8_t SPI_PMW3901_MODE = 3;
 static const SPISettings SPI_PMW3901_SETTINGS( 
-    1000000,      // 1 MHz
+    SPI_PMW3901_HZ,
     MSBFIRST,
     SPI_MODE3
 );
@@ -0,0 +1,76 @@
+#pragma once
+#include <stdint.h>
+
+#include "config/rate_groups.h"
+#include "sensors/tof/tof_profile.h"
+#include "sensors/tof/tof_target.h"
+
+// VL53L3 pair (down + front) ranging plan, see sensors/tof/tof_stagger.h.
+// The slow group ticks once per slot and the two sensors take turns, so
+// each ranges at SLOW_HZ / 2 = 20 Hz (the down sensor's old rate) and the
+// front one comes for free.
+static constexpr uint32_t TOF_SLOT_US = SLOW_PERIOD_US;   // 25 ms
+
+// Ranging profiles, near -> far (sensors/tof/tof_profile.h). A range takes
+// the budget plus a few ms of VCSEL/processing overhead ([tof sched]
+// range= shows the real figure) and must finish inside its own slots or
+// it overlaps the other sensor's.
+//
+//  near: short mode, one slot. 20 Hz with both sensors, 40 Hz alone.
+//  far:  long mode (~4 m), two slots for a budget that keeps the noise down
+//        at range. Down 13.3 Hz, and front drops to 13.3 Hz with it.
+//
+// The down sensor switches between them by range; near's max sits above
+// far's min so hovering around 1 m doesn't flap.
+static constexpr TofProfile TOF_PROFILES[] = {
+  //  name    mode                    budget  slots  min_mm  max_mm
+  { "near",  TofDistanceMode::SHORT,  18000,  1,     0,      1100 },
+  { "far",   TofDistanceMode::LONG,   41000,  2,     900,    0xFFFF },
+};
+static constexpr int TOF_PROFILE_COUNT = sizeof(TOF_PROFILES) / sizeof(TOF_PROFILES[0]);
+static constexpr int TOF_PROFILE_NEAR = 0;
+
+static constexpr uint32_t TOF_RANGE_OVERHEAD_US = 5000;
+
+static constexpr bool tof_profiles_fit(int i = 0)
+{
+  return i >= TOF_PROFILE_COUNT ||
+         (TOF_PROFILES[i].budget_us + TOF_RANGE_OVERHEAD_US <= TOF_PROFILES[i].slots * TOF_SLOT_US &&
+          tof_profiles_fit(i + 1));
+}
+static_assert(tof_profiles_fit(), "a ToF timing budget doesn't fit in its slots");
+
+// Front looks for obstacles: fixed on near (short mode sees ~1.3 m, plenty
+// for the speeds we fly indoors). Down starts there too (on the ground).
+static constexpr int TOF_FRONT_PROFILE = TOF_PROFILE_NEAR;
+static constexpr int TOF_DOWN_START_PROFILE = TOF_PROFILE_NEAR;
+
+// Which histogram object is the real surface (sensors/tof/tof_target.h).
+// Signal/sigma limits are loose first guesses; the [tof targets] counts
+// show what each rule throws away.
+//
+//  down: on the ground the floor is ~20 mm out, so the glass cut stays at
+//        the old 20 mm; low over a shiny floor the second bounce off the
+//        frame shows up at twice the height (echo).
+//  front: prop tips pass through the edge of the cone at 2-9 cm.
+static constexpr TofTargetRules TOF_TARGETS_DOWN = {
+  20, 4000,      // min/max mm
+  0.10f,         // min signal (Mcps)
+  40.0f,         // max sigma (mm)
+  0, 0,          // no prop band
+  0.15f,         // echo within 15 % of 2x
+};
+static constexpr TofTargetRules TOF_TARGETS_FRONT = {
+  30, 4000,
+  0.10f,
+  40.0f,
+  20, 90,        // prop band (mm)
+  0.0f,          // no echo check
+};
+
+// A kicked sensor with no result after this long is kicked again
+static constexpr uint32_t TOF_STUCK_US = 200000;
+
+// TofStagger channels
+static constexpr int TOF_DOWN = 0;
+static constexpr int TOF_FRONT = 1;
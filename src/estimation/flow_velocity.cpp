@@ -0,0 +1,54 @@
+#include "flow_velocity.h"
+
+#include <math.h>
+
+static float pick(const FlowAxis& a, const float* in)
+{
+  return a.sign < 0 ? -in[a.src] : in[a.src];
+}
+
+bool flow_velocity(const FlowDelta& d, float height_m, const FlowOptics& o,
+                   FlowVelocity& out)
+{
+  out = FlowVelocity{};
+  out.squal = d.squal;
+  const int32_t dt_us = (int32_t)(d.t1_us - d.t0_us);
+  out.t_us = d.t0_us + (uint32_t)(dt_us / 2);
+  if (dt_us <= 0) {
+    out.reject = FlowReject::INTERVAL;
+    return false;
+  }
+  out.dt_s = (float)dt_us * 1e-6f;
+
+  const float counts[2] = { (float)d.dx, (float)d.dy };
+  for (int i = 0; i < 2; i++) {
+    out.flow_rad[i] = pick(o.body[i], counts) / o.px_per_rad;
+    out.rot_rad[i] = pick(o.rot[i], d.gyro_rad);
+  }
+
+  // Most specific reason first: a bad surface also makes the rest meaningless
+  if (d.squal < o.min_squal) out.reject = FlowReject::QUALITY;
+  else if (!d.gyro_ok) out.reject = FlowReject::NO_GYRO;
+  else if (!(height_m >= o.min_height_m && height_m <= o.max_height_m)) out.reject = FlowReject::HEIGHT;
+  else if (fabsf(out.flow_rad[0]) > o.max_rate_rad_s * out.dt_s ||
+           fabsf(out.flow_rad[1]) > o.max_rate_rad_s * out.dt_s) out.reject = FlowReject::RATE;
+  if (out.reject != FlowReject::NONE) return false;
+
+  const float k = height_m / out.dt_s;
+  for (int i = 0; i < 2; i++) out.v_m_s[i] = (out.flow_rad[i] - out.rot_rad[i]) * k;
+  out.valid = true;
+  return true;
+}
+
+const char* flow_reject_name(FlowReject r)
+{
+  switch (r) {
+    case FlowReject::NONE: return "ok";
+    case FlowReject::QUALITY: return "squal";
+    case FlowReject::NO_GYRO: return "no gyro";
+    case FlowReject::HEIGHT: return "height";
+    case FlowReject::INTERVAL: return "interval";
+    case FlowReject::RATE: return "rate";
+  }
+  return "?";
+}
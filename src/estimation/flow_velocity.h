@@ -0,0 +1,61 @@
+#pragma once
+#include <stdint.h>
+
+#include "sensors/flow/flow_gyro_sync.h"
+
+// Flow measurement stage: one FlowDelta (counts + gyro integral over the
+// same interval) and the height above ground -> body-frame ground velocity.
+//
+//   flow_b   = map(dx, dy) / px_per_rad         image motion, rad
+//   trans_b  = flow_b - rot(gyro_rad)           rotation taken out
+//   v_b      = trans_b * height / dt            m/s
+//
+// Sign convention after the maps: moving forward (right) at constant height
+// reads as +F (+R) flow, and tilting the camera's line of sight forward
+// (right) reads the same as moving that way. The rotation map says which
+// gyro axis does that and with which sign.
+//
+// Pure, no allocation, no Arduino (host test: test/flow_velocity_test.cpp).
+// The instance for this airframe is FLOW_OPTICS in config/flow_config.h.
+
+// One body axis: sign * in[src]
+struct FlowAxis {
+  uint8_t src;
+  int8_t sign;
+};
+
+struct FlowOptics {
+  float px_per_rad;       // counts per radian of image motion
+  FlowAxis body[2];       // body F, R <- sensor dx (0) / dy (1)
+  FlowAxis rot[2];        // body F, R flow <- FRU gyro integral x/y/z
+  uint8_t min_squal;      // below: surface not tracked
+  float min_height_m;     // below: out of focus
+  float max_height_m;     // above: counts too small to mean anything
+  float max_rate_rad_s;   // above: sensor can't track, counts clip
+};
+
+enum class FlowReject : uint8_t {
+  NONE,
+  QUALITY,     // SQUAL < min_squal
+  NO_GYRO,     // rotation over the interval unknown
+  HEIGHT,      // height outside [min, max] (or not known)
+  INTERVAL,    // t1 <= t0
+  RATE,        // image rate beyond the sensor's range
+};
+
+struct FlowVelocity {
+  float v_m_s[2] = {0, 0};      // body F, R
+  float flow_rad[2] = {0, 0};   // measured image motion, body
+  float rot_rad[2] = {0, 0};    // rotation part removed
+  float dt_s = 0;
+  uint32_t t_us = 0;            // interval midpoint
+  uint8_t squal = 0;
+  FlowReject reject = FlowReject::NONE;
+  bool valid = false;
+};
+
+// Fills out (diagnostics even when rejected); true when out.valid
+bool flow_velocity(const FlowDelta& d, float height_m, const FlowOptics& o,
+                   FlowVelocity& out);
+
+const char* flow_reject_name(FlowReject r);
@@ -2,30 +2,43 @@
 #include <Wire.h>
 
 #include "config/pins.h"
+#include "config/rate_groups.h"
+#include "config/flow_config.h"
 #include "utils/loop_stats.h"
+#include "utils/rate_scheduler.h"
+#include "utils/profiler.h"
 
 #include "board/board_init.h"
+#include "board/i2c_bus.h"
 #include "board/spi_probe.h"
 
 #include "sensors/sensors.h"
 
 
-// Phase 0 loop targets
-static constexpr uint32_t FAST_HZ = 250;   // e.g. IMU later
-static constexpr uint32_t SLOW_HZ = 20;    // e.g. ToF later
-static constexpr uint32_t REPORT_HZ = 1;   // Report telemetry, and measure power
-
-static constexpr uint32_t FAST_PERIOD_US   = 1000000UL / FAST_HZ;
-static constexpr uint32_t SLOW_PERIOD_US   = 1000000UL / SLOW_HZ;
-static constexpr uint32_t REPORT_PERIOD_US = 1000000UL / REPORT_HZ;
-
+// Rate groups (periods, priorities, cores) live in config/rate_groups.h
+static RateScheduler g_sched;
 static LoopStats fast_stats;
+static LoopStats flow_stats;
 static LoopStats slow_stats;
-static uint32_t last_report_us = 0;
+static LoopStats report_stats;
 
-// Sensors
+// Sensors; their I2C all goes through the bus task
+static I2cBus g_i2c;
 static Sensors g_sensors;
 
+// Flow measurement for the velocity estimator (flow group)
+static FlowVelocity g_flow_vel;
+static uint32_t g_flow_vel_ok = 0, g_flow_vel_rejected = 0;
+
+// BMI270 INT1 releases the fast group (added first, so index 0)
+static constexpr int FAST_GROUP = 0;
+static_assert(IMU_CFG.odr_hz() / ImuBmi270::INT1_WM_FRAMES == FAST_HZ,
+              "FAST_HZ must match the BMI270 ODR / INT1 watermark");
+
+static void IRAM_ATTR on_imu_data_ready(uint32_t t_us) {
+  g_sched.release_from_isr(FAST_GROUP, t_us);
+}
+
 // temp helper functions - delete when done
 static bool i2c_read_u8(uint8_t addr, uint8_t reg, uint8_t &value)
 {
@@ -143,6 +156,176 @@ void probe_bmm150_like(uint8_t addr)
 
 
 
+// --- Rate groups --- //
+static void fast_group() {
+  // Read 'fast' sensors
+  g_sensors.fast_read();
+}
+
+static void flow_group() {
+  // Optical flow at its own frame rate, paired with the IMU gyro
+  g_sensors.flow_read();
+
+  // Derotate + scale each new interval; height = ToF range (same body axis
+  // as the camera), the newest the bus task has
+  const SensorsSample& s = g_sensors.sample();
+  TofSample down;
+  const float height_m = (g_sensors.tof_down(down) && down.valid) ? down.range_mm * 0.001f : NAN;
+  for (uint8_t i = 0; i < s.flow_delta_count; i++) {
+    if (flow_velocity(s.flow_delta_batch[i], height_m, FLOW_OPTICS, g_flow_vel)) g_flow_vel_ok++;
+    else g_flow_vel_rejected++;
+  }
+}
+
+static void slow_group() {
+  // Read 'slow' sensors
+  g_sensors.slow_read();
+}
+
+static void spec_group() {
+  // Gyro vibration analysis (feeds the fast loop's notch filters)
+  g_sensors.spectrum_run();
+}
+
+static void print_group_stats(int i) {
+  const RateGroupDef& d = g_sched.def(i);
+  const RateGroupStats& st = g_sched.stats(i);
+  Serial.printf("[sched] %s: runs=%lu overruns=%lu misses=%lu max_lat=%luus max_resp=%luus max_exec=%luus",
+                d.name, (unsigned long)st.runs, (unsigned long)st.overruns,
+                (unsigned long)st.deadline_misses, (unsigned long)st.max_start_lat_us,
+                (unsigned long)st.max_response_us, (unsigned long)st.max_exec_us);
+  if (d.clock == RateClock::EXTERNAL) {
+    Serial.printf(" polled=%lu", (unsigned long)st.fallback_runs);
+  }
+  Serial.println();
+}
+
+// Percentiles over the last report window (histograms reset on read)
+static void print_group_hist(const char* name, LoopStats& st) {
+  static LatencyHistogram dt, exec;  // 1 KB each; keep off the task stack
+  st.read_window(dt, exec);
+  Serial.printf("[hist] %s: n=%lu dt p50=%lu p99=%lu p99.9=%lu max=%luus | exec p50=%lu p99=%lu p99.9=%lu max=%luus\n",
+                name, (unsigned long)dt.total(),
+                (unsigned long)dt.percentile(50.0f), (unsigned long)dt.percentile(99.0f),
+                (unsigned long)dt.percentile(99.9f), (unsigned long)dt.max(),
+                (unsigned long)exec.percentile(50.0f), (unsigned long)exec.percentile(99.0f),
+                (unsigned long)exec.percentile(99.9f), (unsigned long)exec.max());
+}
+
+// I2C bus task: queue and per-device wait / bus time (cumulative)
+static void print_i2c_stats() {
+  const I2cQueue& q = g_i2c.queue();
+  Serial.printf("[i2c] %s queue max=%d/%d rejected=%lu\n",
+                g_i2c.started() ? "task" : "inline", q.max_depth(), I2cQueue::CAPACITY,
+                (unsigned long)q.rejected());
+  for (int i = 0; i < g_i2c.devices(); i++) {
+    const I2cDevStats& d = g_i2c.stats(i);
+    Serial.printf("[i2c] %s@0x%02X: n=%lu err=%lu rejected=%lu wait avg=%luus max=%luus bus avg=%luus max=%luus lat max=%luus\n",
+                  d.name, (unsigned)d.addr7, (unsigned long)d.txns, (unsigned long)d.errors,
+                  (unsigned long)d.rejected, (unsigned long)d.avg_wait_us(),
+                  (unsigned long)d.max_wait_us, (unsigned long)d.avg_bus_us(),
+                  (unsigned long)d.max_bus_us, (unsigned long)d.max_lat_us);
+  }
+}
+
+// Per-stage time inside the groups (profiler zones), over the last window
+static void print_profile() {
+#if PROFILE_ZONES
+  static ProfZoneStats zones[PROF_ZONE_COUNT];
+  prof::read_and_reset(zones);
+  for (int i = 0; i < PROF_ZONE_COUNT; i++) {
+    const ProfZoneStats& z = zones[i];
+    if (z.count == 0) continue;
+    Serial.printf("[prof] %-6s n=%lu avg=%.1fus max=%.1fus total=%.1fms\n",
+                  prof::zone_name((ProfZone)i), (unsigned long)z.count,
+                  prof::ticks_to_us((uint32_t)(z.sum_ticks / z.count)),
+                  prof::ticks_to_us(z.max_ticks),
+                  prof::ticks_to_us((uint32_t)z.sum_ticks) * 0.001f);  // < 17 s of cycles per window
+  }
+#endif
+}
+
+#if FLOW_FRAME_CAPTURE
+// Serial 'f': grab one raw flow frame; 'F': one per report until 'F' again.
+// Binary packets (sensors/flow/pmw3901_frame.h) go out between the text
+// lines; tools/python/flow_frame_view.py picks them out. Runs here, on
+// core 0: the grab blocks ~0.25 s and pauses the flow group meanwhile.
+static bool g_frame_stream = false;
+
+static void flow_frame_service() {
+  bool once = false;
+  while (Serial.available() > 0) {
+    const int c = Serial.read();
+    if (c == 'f') once = true;
+    else if (c == 'F') g_frame_stream = !g_frame_stream;
+  }
+  if (!once && !g_frame_stream) return;
+
+  static FlowFrame frame;                      // 1.2 KB each; keep off the task stack
+  static uint8_t pkt[FLOW_FRAME_PACKET_MAX];
+  if (!g_sensors.flow_capture(frame)) {
+    Serial.println("[flow frame] capture failed");
+    return;
+  }
+  const size_t n = flow_frame_encode(frame, pkt, sizeof(pkt));
+  Serial.write(pkt, n);
+  Serial.println();
+}
+#endif
+
+// 1 Hz report of dt jitter
+static void report_group() {
+  // Update very slow sensors (power)
+  g_sensors.very_slow_read();
+
+  // Prints the cache without a lock while fast/slow run on the other core;
+  // a torn value can only affect this debug line.
+  g_sensors.printSample();
+  Serial.printf("[flow vel] v F=%.2f R=%.2f m/s flow=%.4f %.4f rot=%.4f %.4f rad %s ok=%lu rejected=%lu\n",
+                g_flow_vel.v_m_s[0], g_flow_vel.v_m_s[1],
+                g_flow_vel.flow_rad[0], g_flow_vel.flow_rad[1],
+                g_flow_vel.rot_rad[0], g_flow_vel.rot_rad[1],
+                flow_reject_name(g_flow_vel.reject),
+                (unsigned long)g_flow_vel_ok, (unsigned long)g_flow_vel_rejected);
+
+  // Print timing stats
+  Serial.printf("[timing] fast(%u Hz): samples=%lu min=%luus avg=%luus max=%luus\n",
+                (unsigned)FAST_HZ, (unsigned long)fast_stats.samples(),
+                (unsigned long)fast_stats.min_dt_us(), (unsigned long)fast_stats.avg_dt_us(),
+                (unsigned long)fast_stats.max_dt_us());
+
+  Serial.printf("[timing] fast(%u Hz): wake avg=%luus max=%luus exec avg=%luus max=%luus miss=%lu skipped=%lu\n",
+                (unsigned)FAST_HZ,
+                (unsigned long)fast_stats.avg_wake_lat_us(), (unsigned long)fast_stats.max_wake_lat_us(),
+                (unsigned long)fast_stats.avg_exec_us(), (unsigned long)fast_stats.max_exec_us(),
+                (unsigned long)fast_stats.deadline_misses(), (unsigned long)fast_stats.missed_ticks());
+
+  Serial.printf("[timing] flow(%u Hz): samples=%lu min=%luus avg=%luus max=%luus\n",
+                (unsigned)FLOW_HZ, (unsigned long)flow_stats.samples(),
+                (unsigned long)flow_stats.min_dt_us(), (unsigned long)flow_stats.avg_dt_us(),
+                (unsigned long)flow_stats.max_dt_us());
+
+  Serial.printf("[timing] slow(%u Hz): samples=%lu min=%luus avg=%luus max=%luus\n",
+                (unsigned)SLOW_HZ, (unsigned long)slow_stats.samples(),
+                (unsigned long)slow_stats.min_dt_us(), (unsigned long)slow_stats.avg_dt_us(),
+                (unsigned long)slow_stats.max_dt_us());
+
+  print_profile();
+  print_i2c_stats();
+
+  for (int i = 0; i < g_sched.count(); i++) print_group_stats(i);
+
+  print_group_hist("fast", fast_stats);
+  print_group_hist("flow", flow_stats);
+  print_group_hist("slow", slow_stats);
+  print_group_hist("report", report_stats);
+
+#if FLOW_FRAME_CAPTURE
+  flow_frame_service();
+#endif
+}
+
+
 void setup() {
   Serial.begin(115200);
   delay(2500);
@@ -152,8 +335,11 @@ void setup() {
   auto init = board_init();
   //spi_probe_devices();
 
-  // Bring up all sensors (Wire is already initialized in board_init())
-  bool sensors_ok = g_sensors.begin(Wire);
+  // Bring up all sensors (Wire is already initialized in board_init()).
+  // Until the bus task starts, their I2C runs inline here.
+  g_i2c.begin(Wire);
+  g_sensors.set_imu_data_ready(on_imu_data_ready);
+  bool sensors_ok = g_sensors.begin(g_i2c);
 
   // Run a final i2c scan and print results  
   auto scan = board_i2c_scan(Wire);
@@ -161,61 +347,33 @@ void setup() {
   scan.spi_ok = init.spi_ok;
   board_print_report(scan);
 
+  // From here on Wire belongs to the bus task
+  bool i2c_ok = g_i2c.start(I2C_BUS_PRIO, I2C_BUS_CORE, I2C_BUS_STACK);
+  Serial.printf("[i2c] bus task: %s\n", i2c_ok ? (I2C_BUS_TASK ? "OK" : "off (inline)") : "FAIL");
+
   // temp - delete when done
   //delay(100);
   //probe_bmm150_like(0x10);
   //delay(100);
   //probe_i2c_devices();
 
-  // Init timing stats
+  // Init timing stats and hand the rate groups to the scheduler
   fast_stats.reset();
+  flow_stats.reset();
   slow_stats.reset();
-  last_report_us = micros();
+  report_stats.reset();
+
+  bool sched_ok = g_sched.add(RG_FAST, fast_group, &fast_stats) &&
+                  g_sched.add(RG_FLOW, flow_group, &flow_stats) &&
+                  g_sched.add(RG_SLOW, slow_group, &slow_stats) &&
+                  g_sched.add(RG_REPORT, report_group, &report_stats) &&
+                  g_sched.add(RG_SPEC, spec_group) &&
+                  g_sched.start();
+  Serial.printf("[sched] start: %s\n", sched_ok ? "OK" : "FAIL");
 }
 
 
 void loop() {
-  const uint32_t now = micros();
-
-  // Fast loop placeholder (later: IMU read)
-  if (fast_stats.ready(now, FAST_PERIOD_US)) {
-    fast_stats.tick(now);
-
-    // Read 'fast' sensors    
-    g_sensors.fast_read();
-
-  }
-
-  // Slow loop placeholder (later: ToF read)
-  if (slow_stats.ready(now, SLOW_PERIOD_US)) {
-    slow_stats.tick(now);
-
-    // Read 'slow' sensors
-    g_sensors.slow_read();
-
-  }
-
-  // 1 Hz report of dt jitter
-  if ((uint32_t)(now - last_report_us) >= REPORT_PERIOD_US) {
-    last_report_us = now;
-
-    // Update very slow sensors (power)
-    g_sensors.very_slow_read();
-    g_sensors.printSample();
-
-    // Print timing stats
-    Serial.printf("[timing] fast(%u Hz): samples=%lu min=%luus avg=%luus max=%luus\n",
-                  (unsigned)FAST_HZ, (unsigned long)fast_stats.samples(),
-                  (unsigned long)fast_stats.min_dt_us(), (unsigned long)fast_stats.avg_dt_us(),
-                  (unsigned long)fast_stats.max_dt_us());
-    
-    Serial.printf("[timing] slow(%u Hz): samples=%lu min=%luus avg=%luus max=%luus\n",
-                  (unsigned)SLOW_HZ, (unsigned long)slow_stats.samples(),
-                  (unsigned long)slow_stats.min_dt_us(), (unsigned long)slow_stats.avg_dt_us(),
-                  (unsigned long)slow_stats.max_dt_us());
-  }
-  
-  // Avoid starving Wi-Fi/RTOS housekeeping in future; safe to yield here.
-  //delay(1);
-  //delayMicroseconds(10);
+  // All periodic work runs in the rate-group tasks; loopTask has nothing left to do.
+  vTaskDelete(nullptr);
 }
@@ -0,0 +1,100 @@
+#include "flow_gyro_sync.h"
+
+void FlowGyroSync::add_gyro(uint32_t t_us, const float g[3])
+{
+  if (g_n_ > 0) {
+    const GyroPoint& last = hist_(g_n_ - 1);
+    const uint32_t dt = t_us - last.t_us;
+    if (dt == 0 || dt > MAX_GYRO_DT_US) {
+      // Out of order, duplicate or a hole: start over from this sample
+      g_n_ = 0;
+      gyro_restarts_++;
+    }
+  }
+
+  GyroPoint& p = gyro_[g_head_];
+  if (g_n_ == 0) {
+    p.cum[0] = p.cum[1] = p.cum[2] = 0;
+  } else {
+    const GyroPoint& last = hist_(g_n_ - 1);
+    const float dt_s = (float)(t_us - last.t_us) * 1e-6f;
+    for (int k = 0; k < 3; k++) p.cum[k] = last.cum[k] + 0.5f * (g[k] + g_last_[k]) * dt_s;
+  }
+  p.t_us = t_us;
+  g_last_[0] = g[0];
+  g_last_[1] = g[1];
+  g_last_[2] = g[2];
+  g_head_ = (uint8_t)((g_head_ + 1) % GYRO_HIST);
+  if (g_n_ < GYRO_HIST) g_n_++;
+}
+
+bool FlowGyroSync::cum_at_(uint32_t t_us, float out[3]) const
+{
+  if (g_n_ < 2) return false;
+  const uint32_t t0 = hist_(0).t_us;
+  const uint32_t span = hist_(g_n_ - 1).t_us - t0;
+  const uint32_t off = t_us - t0;
+  if (off > span) return false;   // before the oldest (wraps huge) or after the newest
+
+  for (uint8_t i = 1; i < g_n_; i++) {
+    const GyroPoint& b = hist_(i);
+    if (b.t_us - t0 < off) continue;
+    const GyroPoint& a = hist_(i - 1);
+    const float f = (float)(t_us - a.t_us) / (float)(b.t_us - a.t_us);
+    for (int k = 0; k < 3; k++) out[k] = a.cum[k] + f * (b.cum[k] - a.cum[k]);
+    return true;
+  }
+  return false;
+}
+
+bool FlowGyroSync::integrate(uint32_t a_us, uint32_t b_us, float out[3]) const
+{
+  float ca[3], cb[3];
+  if (!cum_at_(a_us, ca) || !cum_at_(b_us, cb)) return false;
+  for (int k = 0; k < 3; k++) out[k] = cb[k] - ca[k];
+  return true;
+}
+
+void FlowGyroSync::add_flow(uint32_t t_us, int16_t dx, int16_t dy, uint8_t squal, bool motion)
+{
+  const bool first = !have_flow_;
+  const uint32_t t0 = t_flow_;
+  have_flow_ = true;
+  t_flow_ = t_us;
+  if (first) return;   // no interval yet
+  if (t_us - t0 > MAX_FLOW_DT_US) {
+    gaps_++;
+    return;
+  }
+
+  if (p_n_ == PENDING) {
+    p_tail_ = (uint8_t)((p_tail_ + 1) % PENDING);
+    p_n_--;
+    dropped_++;
+  }
+  FlowDelta& d = pend_[(p_tail_ + p_n_) % PENDING];
+  d = FlowDelta{};
+  d.t0_us = t0;
+  d.t1_us = t_us;
+  d.dx = motion ? dx : 0;
+  d.dy = motion ? dy : 0;
+  d.squal = squal;
+  d.motion = motion;
+  p_n_++;
+}
+
+bool FlowGyroSync::pop(FlowDelta& out, uint32_t now_us)
+{
+  if (p_n_ == 0) return false;
+  FlowDelta& d = pend_[p_tail_];
+
+  const bool reached = g_n_ > 0 && (int32_t)(hist_(g_n_ - 1).t_us - d.t1_us) >= 0;
+  if (!reached && (int32_t)(now_us - d.t1_us) < (int32_t)MAX_WAIT_US) return false;
+
+  d.gyro_ok = integrate(d.t0_us, d.t1_us, d.gyro_rad);
+  if (!d.gyro_ok) d.gyro_rad[0] = d.gyro_rad[1] = d.gyro_rad[2] = 0;
+  out = d;
+  p_tail_ = (uint8_t)((p_tail_ + 1) % PENDING);
+  p_n_--;
+  return true;
+}
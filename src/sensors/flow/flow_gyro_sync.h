@@ -0,0 +1,80 @@
+#pragma once
+#include <stdint.h>
+
+// Pairs each PMW3901 delta with the gyro rotation over the same interval.
+//
+// The PMW3901 accumulates motion between reads, so a burst read at t1
+// returns the motion over (t0, t1], t0 being the previous read. Rotation
+// alone moves the image too; to take it out, the estimator needs the
+// integral of the gyro over exactly that interval. The IMU arrives in
+// batches a few ms late, so completed deltas are held until the gyro
+// history reaches t1, then handed out with the integral attached.
+//
+// Gyro integral: trapezoids between samples, kept as a running sum per
+// sample time; an arbitrary interval is the difference of that sum
+// linearly interpolated at both ends. A gap in the gyro stream (lost
+// samples, > MAX_GYRO_DT_US) restarts the history.
+//
+// Times are micros() values (wrap-safe). No Arduino dependencies (host
+// test: test/flow_gyro_sync_test.cpp).
+
+struct FlowDelta {
+  uint32_t t0_us = 0, t1_us = 0;   // interval the deltas accumulated over
+  int16_t dx = 0, dy = 0;          // raw counts, sensor axes
+  float gyro_rad[3] = {0, 0, 0};   // ∫ gyro dt over (t0, t1], FRU
+  uint8_t squal = 0;
+  bool motion = false;             // sensor flagged new motion (else dx = dy = 0)
+  bool gyro_ok = false;            // gyro history covered the whole interval
+};
+
+class FlowGyroSync {
+ public:
+  static constexpr uint8_t GYRO_HIST = 64;          // 160 ms at 400 Hz
+  static constexpr uint8_t PENDING = 8;             // deltas waiting for gyro
+  static constexpr uint32_t MAX_GYRO_DT_US = 20000; // longer: gyro gap
+  static constexpr uint32_t MAX_FLOW_DT_US = 50000; // longer: missed reads, no delta
+  static constexpr uint32_t MAX_WAIT_US = 40000;    // then hand out without gyro
+
+  void reset() { *this = FlowGyroSync{}; }
+
+  void add_gyro(uint32_t t_us, const float g[3]);
+
+  // One read latched at t_us; motion false means dx = dy = 0 (still valid)
+  void add_flow(uint32_t t_us, int16_t dx, int16_t dy, uint8_t squal, bool motion);
+
+  // Next completed delta (oldest first) once the gyro reached its t1, or
+  // MAX_WAIT_US after t1 without it (gyro_ok = false)
+  bool pop(FlowDelta& out, uint32_t now_us);
+
+  // ∫ gyro over (a, b]; false if the history doesn't cover it
+  bool integrate(uint32_t a_us, uint32_t b_us, float out[3]) const;
+
+  uint32_t dropped() const { return dropped_; }     // pending queue overflow
+  uint32_t gaps() const { return gaps_; }           // flow intervals too long
+  uint32_t gyro_restarts() const { return gyro_restarts_; }
+
+ private:
+  struct GyroPoint {
+    uint32_t t_us;
+    float cum[3];    // running ∫ gyro dt up to t_us (rad)
+  };
+
+  bool cum_at_(uint32_t t_us, float out[3]) const;
+  const GyroPoint& hist_(uint8_t i) const { return gyro_[(g_head_ + GYRO_HIST - g_n_ + i) % GYRO_HIST]; }
+
+  GyroPoint gyro_[GYRO_HIST] = {};
+  uint8_t g_head_ = 0;      // next write
+  uint8_t g_n_ = 0;
+  float g_last_[3] = {0, 0, 0};
+
+  FlowDelta pend_[PENDING];
+  uint8_t p_tail_ = 0;      // oldest
+  uint8_t p_n_ = 0;
+
+  bool have_flow_ = false;
+  uint32_t t_flow_ = 0;     // previous read
+
+  uint32_t dropped_ = 0;
+  uint32_t gaps_ = 0;
+  uint32_t gyro_restarts_ = 0;
+};
@@ -7,149 +7,60 @@
 //  - SPI_PMW3901_SETTINGS(1000000, MSBFIRST, SPI_MODE0)
 //  - PIN_CS_PMW3901 = 12
 #include "config/spi_config.h"
+#include "board/spi_bus.h"
+#include "pmw3901_async.h"
+#include "pmw3901_init.h"
 
 namespace {
 
-// PMW3901 typically wants a dummy byte on reads.
-constexpr uint8_t DUMMY = 0x00;
-
-// Conservative CS timing guards (ESP32-S3 is fast; the sensor can be picky)
-inline void cs_select() {
-  digitalWrite(PIN_CS_PMW3901, LOW);
-  delayMicroseconds(5);
-}
-inline void cs_deselect() {
-  delayMicroseconds(5);
-  digitalWrite(PIN_CS_PMW3901, HIGH);
-  delayMicroseconds(5);
-}
+SpiDevice g_spi;
 
+#if !FLOW_BURST
 // NOTE: Addressing differs across PMW3901 breakouts/drivers.
 // Many use: write = reg | 0x80, read = reg & 0x7F.
 // If your first probe returns nonsense, we’ll flip this convention.
 static uint8_t reg_read(uint8_t reg) {
   // adapted from BitCraze PMW3901 lib
   reg &= ~0x80u;
-  SPI.beginTransaction(SPI_PMW3901_SETTINGS);
-  digitalWrite(PIN_CS_PMW3901, LOW);
+  g_spi.select();
   
   delayMicroseconds(50);
-  SPI.transfer(reg);
-  delayMicroseconds(50);          // tSRAD: allow sensor to prepare data
-  uint8_t v = SPI.transfer(0x00); // clock out data
+  g_spi.transfer_byte(reg);
+  delayMicroseconds(50);                 // tSRAD: allow sensor to prepare data
+  uint8_t v = g_spi.transfer_byte(0x00); // clock out data
   delayMicroseconds(100);
 
-  digitalWrite(PIN_CS_PMW3901, HIGH);
-  SPI.endTransaction();
+  g_spi.deselect();
 
   delayMicroseconds(50);          // inter-transaction gap (safe/conservative)
   return v;
 }
+#endif
+
+// Motion burst state machine and register access on the shared SPI device
+class SpiFlowBus : public Pmw3901Bus {
+ public:
+  void select() override { g_spi.select(); }
+  void deselect() override { g_spi.deselect(); }
+  void transfer(const uint8_t* tx, uint8_t* rx, uint32_t n) override { g_spi.transfer(tx, rx, n); }
+  uint32_t now_us() override { return micros(); }
+  void delay_us(uint32_t us) override {
+    // Long waits (reset, init settle) sleep instead of spinning
+    if (us >= 1000) delay(us / 1000);
+    delayMicroseconds(us % 1000);
+  }
+};
 
-inline void reg_write(uint8_t reg, uint8_t val) {
-  // Adapted from Bitcraze pmw3901 lib
-  reg |= 0x80u;
-  SPI.beginTransaction(SPI_PMW3901_SETTINGS);
-  cs_select();
-
-  delayMicroseconds(50);
-  SPI.transfer(reg);
-  SPI.transfer(val);
-  delayMicroseconds(50);
-
-  cs_deselect();
-  SPI.endTransaction();
-  delayMicroseconds(200);
-}
+SpiFlowBus g_bus;
+Pmw3901Async g_burst(g_bus);
 
 }  // namespace
 
-// Performance optimisation registers
-// Taken from BitCraze PMW3901 lib
-void initRegisters()
-{
-  reg_write(0x7F, 0x00);
-  reg_write(0x61, 0xAD);
-  reg_write(0x7F, 0x03);
-  reg_write(0x40, 0x00);
-  reg_write(0x7F, 0x05);
-  reg_write(0x41, 0xB3);
-  reg_write(0x43, 0xF1);
-  reg_write(0x45, 0x14);
-  reg_write(0x5B, 0x32);
-  reg_write(0x5F, 0x34);
-  reg_write(0x7B, 0x08);
-  reg_write(0x7F, 0x06);
-  reg_write(0x44, 0x1B);
-  reg_write(0x40, 0xBF);
-  reg_write(0x4E, 0x3F);
-  reg_write(0x7F, 0x08);
-  reg_write(0x65, 0x20);
-  reg_write(0x6A, 0x18);
-  reg_write(0x7F, 0x09);
-  reg_write(0x4F, 0xAF);
-  reg_write(0x5F, 0x40);
-  reg_write(0x48, 0x80);
-  reg_write(0x49, 0x80);
-  reg_write(0x57, 0x77);
-  reg_write(0x60, 0x78);
-  reg_write(0x61, 0x78);
-  reg_write(0x62, 0x08);
-  reg_write(0x63, 0x50);
-  reg_write(0x7F, 0x0A);
-  reg_write(0x45, 0x60);
-  reg_write(0x7F, 0x00);
-  reg_write(0x4D, 0x11);
-  reg_write(0x55, 0x80);
-  reg_write(0x74, 0x1F);
-  reg_write(0x75, 0x1F);
-  reg_write(0x4A, 0x78);
-  reg_write(0x4B, 0x78);
-  reg_write(0x44, 0x08);
-  reg_write(0x45, 0x50);
-  reg_write(0x64, 0xFF);
-  reg_write(0x65, 0x1F);
-  reg_write(0x7F, 0x14);
-  reg_write(0x65, 0x60);
-  reg_write(0x66, 0x08);
-  reg_write(0x63, 0x78);
-  reg_write(0x7F, 0x15);
-  reg_write(0x48, 0x58);
-  reg_write(0x7F, 0x07);
-  reg_write(0x41, 0x0D);
-  reg_write(0x43, 0x14);
-  reg_write(0x4B, 0x0E);
-  reg_write(0x45, 0x0F);
-  reg_write(0x44, 0x42);
-  reg_write(0x4C, 0x80);
-  reg_write(0x7F, 0x10);
-  reg_write(0x5B, 0x02);
-  reg_write(0x7F, 0x07);
-  reg_write(0x40, 0x41);
-  reg_write(0x70, 0x00);
-
-  delay(100);
-  reg_write(0x32, 0x44);
-  reg_write(0x7F, 0x07);
-  reg_write(0x40, 0x40);
-  reg_write(0x7F, 0x06);
-  reg_write(0x62, 0xf0);
-  reg_write(0x63, 0x00);
-  reg_write(0x7F, 0x0D);
-  reg_write(0x48, 0xC0);
-  reg_write(0x6F, 0xd5);
-  reg_write(0x7F, 0x00);
-  reg_write(0x5B, 0xa0);
-  reg_write(0x4E, 0xA8);
-  reg_write(0x5A, 0x50);
-  reg_write(0x40, 0x80);
-}
-
 
 bool FlowPmw3901::begin() {
-  pinMode(PIN_CS_PMW3901, OUTPUT);
-  digitalWrite(PIN_CS_PMW3901, HIGH);  // idle HIGH (board_init already does it, but harmless)
-  SPI.beginTransaction(SPI_PMW3901_SETTINGS);
+  // CS idles HIGH (board_init already does it, but harmless)
+  if (!g_spi.begin(PIN_CS_PMW3901, SPI_PMW3901_HZ, SPI_PMW3901_MODE)) return false;
+  g_spi.select();   // bus + mode 3 clock idle for the pulse below
 
   // Make sure the SPI bus is reset
   digitalWrite(PIN_CS_PMW3901, HIGH);
@@ -159,33 +70,107 @@ bool FlowPmw3901::begin() {
   digitalWrite(PIN_CS_PMW3901, HIGH);
   delay(1);
 
-  SPI.endTransaction();
+  g_spi.deselect();
 
-  // Power on reset
-  reg_write(0x3A, 0x5A);
-  delay(5);
-  // Test the SPI communication, checking chipId and inverse chipId
-  uint8_t chipId = reg_read(0x00);
-  uint8_t dIpihc = reg_read(0x5F);
+  return init_sensor();
+}
 
-  if (chipId != 0x49 || dIpihc != 0xB6) {
-    return false;
+// Power-on reset, ID check, init script (PMW3901_INIT); also the only way
+// out of frame grab mode
+bool FlowPmw3901::init_sensor() {
+  Pmw3901RegIo io(g_bus);
+  return pmw3901_load(io, PMW3901_INIT, PMW3901_INIT_STEPS, _init);
+}
+
+bool FlowPmw3901::captureFrame(FlowFrame& f) {
+#if FLOW_FRAME_CAPTURE
+  const uint32_t t0 = micros();
+  f.t_us = t0;
+  // tSRAD + tSRR spacing only, so the shared bus is held ~40 us per read,
+  // 2450+ reads a frame
+  Pmw3901RegIo io(g_bus);
+  for (const Pmw3901RegWrite& w : PMW3901_FRAME_ENTER) io.write(w.reg, w.val);
+
+  // Grab ready (normally at once)
+  bool ready = false;
+  for (int i = 0; i < 100 && !ready; i++) {
+    ready = (io.read(PMW3901_RAWDATA_GRAB_STATUS) & PMW3901_GRAB_READY) == PMW3901_GRAB_READY;
   }
 
-  // Reading the motion registers one time
-  reg_read(0x02);
-  reg_read(0x03);
-  reg_read(0x04);
-  reg_read(0x05);
-  reg_read(0x06);
-  delay(1);
+  // Two good reads per pixel; give up after as many not-ready ones again
+  Pmw3901FrameAssembler a(f.px);
+  for (uint32_t i = 0; ready && i < 4u * PMW3901_FRAME_PIXELS; i++) {
+    if (a.push(io.read(PMW3901_RAWDATA_GRAB))) break;
+  }
+  f.grab_us = micros() - t0;
+
+  _frame_stats.grabs++;
+  _frame_stats.not_ready += a.not_ready();
+  _frame_stats.out_of_order += a.out_of_order();
+  if (!a.done()) _frame_stats.failed++;
+
+  // Back to tracking (the sensor has no other way out of frame mode)
+  const bool init_ok = init_sensor();
+  if (!init_ok) _frame_stats.reinit_failed++;
+  return a.done() && init_ok;
+#else
+  (void)f;
+  return false;
+#endif
+}
 
-  initRegisters();
+bool FlowPmw3901::read(FlowSample& out) {
+  start();
+  return finish(out);
+}
 
+bool FlowPmw3901::start() {
+#if FLOW_BURST
+  return g_burst.start();
+#else
   return true;
+#endif
 }
 
-bool FlowPmw3901::read(FlowSample& out) {
+bool FlowPmw3901::finish(FlowSample& out) {
+#if FLOW_BURST
+  if (!g_burst.busy()) {
+    out.read_ok = false;
+    out.valid = false;
+    return false;
+  }
+  // Normally the gap is over by now; otherwise spin out what is left
+  Pmw3901Burst b;
+  if (!g_burst.poll(b)) {
+    const uint32_t t0 = micros();
+    while (!g_burst.poll(b)) {
+    }
+    const uint32_t spin = micros() - t0;
+    _stats.spun++;
+    _stats.spin_us += spin;
+    if (spin > _stats.max_spin_us) _stats.max_spin_us = spin;
+  }
+  _stats.reads++;
+  out.t_us = g_burst.started_us();   // when the burst latched the motion
+  out.read_ok = true;
+
+  out.motion = b.motion;
+  out.quality = b.squal;
+  out.quality_ok = (b.squal >= 30);
+  out.shutter = b.shutter;
+
+  // MOTION GATE: deltas are only new when bit7 is set
+  if (!(b.motion & PMW3901_MOTION_MOT)) {
+    out.dx = 0.0f;
+    out.dy = 0.0f;
+    out.valid = false;
+    return false;
+  }
+  out.dx = (float)b.dx;
+  out.dy = (float)b.dy;
+  out.valid = true;
+  return true;
+#else
   // Timestamp early so the caller knows "when this was checked"
   out.t_us = micros();
 
@@ -196,6 +181,7 @@ bool FlowPmw3901::read(FlowSample& out) {
   out.motion = m;
   out.quality = q;
   out.quality_ok = (q >= 30);
+  out.read_ok = true;
 
   // MOTION GATE: bit7 indicates a new motion sample is available
   const bool has_new_motion = (m & 0x80) != 0;
@@ -214,4 +200,5 @@ bool FlowPmw3901::read(FlowSample& out) {
   out.dy = (float)dy;
   out.valid = true;
   return true;
+#endif
 }
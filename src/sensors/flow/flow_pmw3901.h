@@ -1,6 +1,22 @@
 #pragma once
 #include <stdint.h>
 
+// FLOW_BURST=1: motion burst through Pmw3901Async (one ~150 us SPI
+// transaction, the 35 us gap left to the caller). 0: the old per-register
+// reads (~250 us of delays each, kept to compare).
+#ifndef FLOW_BURST
+#define FLOW_BURST 1
+#endif
+
+// FLOW_FRAME_CAPTURE=1: captureFrame() grabs the raw 35x35 image for
+// debugging poor surfaces (serial 'f' / 'F' in main.cpp). 0: compiled out.
+#ifndef FLOW_FRAME_CAPTURE
+#define FLOW_FRAME_CAPTURE 1
+#endif
+
+#include "pmw3901_frame.h"
+#include "pmw3901_init.h"
+
 /*
 quality >= 80 → excellent
 quality 30..80 → usable
@@ -12,13 +28,56 @@ struct FlowSample {
   float dy = 0;
   uint8_t motion = 0;
   uint8_t quality = 0; // 0..255-ish, sensor-specific
+  uint16_t shutter = 0; // exposure (burst only); rises as the surface gets darker
   bool quality_ok = false;
   uint32_t t_us = 0;
-  bool valid = false;
+  bool read_ok = false;  // the sensor was read (dx/dy = 0 without motion)
+  bool valid = false;    // new motion in dx/dy
+};
+
+// Time finish() spent waiting out the burst gap (FLOW_BURST=1)
+struct FlowAsyncStats {
+  uint32_t reads = 0;
+  uint32_t spun = 0;          // finish() had to wait out part of tSRAD_MOTBR
+  uint32_t spin_us = 0;       // total
+  uint32_t max_spin_us = 0;
+};
+
+struct FlowFrameStats {
+  uint32_t grabs = 0;
+  uint32_t failed = 0;         // frame incomplete
+  uint32_t reinit_failed = 0;  // sensor didn't come back after the grab
+  uint32_t not_ready = 0;      // RawData_Grab reads without data
+  uint32_t out_of_order = 0;
 };
 
 class FlowPmw3901 {
  public:
   bool begin();
+  const Pmw3901InitReport& initReport() const { return _init; }   // last init
+
+  // Blocking: start() + finish()
   bool read(FlowSample& out);
+
+  // Split read: start() opens the motion burst (CS low, address) and
+  // returns; finish() completes it, waiting only for whatever is left of
+  // the 35 us gap. Do non-SPI work in between: the burst holds the bus.
+  // With FLOW_BURST=0 start() does nothing and finish() is the old read.
+  bool start();
+  bool finish(FlowSample& out);
+
+  const FlowAsyncStats& asyncStats() const { return _stats; }
+
+  // Raw frame grab into f.px / t_us / grab_us. Blocking (~0.25 s with the
+  // re-init after it) and leaves the sensor re-initialised; no start() /
+  // finish() may run meanwhile. Run it off the control core.
+  bool captureFrame(FlowFrame& f);
+  const FlowFrameStats& frameStats() const { return _frame_stats; }
+
+ private:
+  bool init_sensor();
+
+  FlowAsyncStats _stats;
+  FlowFrameStats _frame_stats;
+  Pmw3901InitReport _init;
 };
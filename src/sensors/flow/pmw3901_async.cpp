@@ -0,0 +1,45 @@
+#include "pmw3901_async.h"
+
+bool Pmw3901Async::start()
+{
+  if (state_ != State::IDLE) return false;
+  const uint32_t now = bus_.now_us();
+  if (exited_ && (uint32_t)(now - t_exit_) < PMW3901_T_BEXIT_US) return false;
+
+  const uint8_t addr = PMW3901_MOTION_BURST;
+  bus_.select();
+  t_start_ = bus_.now_us();
+  bus_.transfer(&addr, nullptr, 1);
+  t_addr_ = bus_.now_us();
+  state_ = State::WAIT_SRAD;
+  return true;
+}
+
+uint32_t Pmw3901Async::wait_us()
+{
+  if (state_ != State::WAIT_SRAD) return 0;
+  // +1: a micros() difference of n can be anything in (n-1, n]
+  constexpr uint32_t GAP = PMW3901_T_SRAD_MOTBR_US + 1;
+  const uint32_t el = bus_.now_us() - t_addr_;
+  return el >= GAP ? 0 : GAP - el;
+}
+
+bool Pmw3901Async::poll(Pmw3901Burst& out)
+{
+  if (state_ != State::WAIT_SRAD) return false;
+  if (wait_us() > 0) {
+    early_polls_++;
+    return false;
+  }
+
+  uint8_t buf[PMW3901_BURST_BYTES];
+  bus_.transfer(nullptr, buf, PMW3901_BURST_BYTES);
+  bus_.deselect();
+  t_exit_ = bus_.now_us();
+  exited_ = true;
+  state_ = State::IDLE;
+  bursts_++;
+
+  pmw3901_parse_burst(buf, out);
+  return true;
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <stdint.h>
+
+#include "pmw3901_burst.h"
+#include "pmw3901_bus.h"
+
+// Non-blocking PMW3901 motion burst.
+//
+//   start():  CS low + address byte, returns at once
+//   poll():   once tSRAD_MOTBR has passed since the address byte, clocks
+//             out the 12 bytes and raises CS; false (nothing touched)
+//             before that
+//
+// The caller does other work between the two instead of spinning through
+// the gap; wait_us() says how much of it is left. start() refuses while a
+// burst is open and until tBEXIT after the previous one.
+//
+// No Arduino dependencies: the bus and clock are an interface (host test
+// with a timing-checking fake SPI: test/pmw3901_async_test.cpp). Times are
+// micros() values compared wrap-safe.
+class Pmw3901Async {
+ public:
+  enum class State : uint8_t { IDLE, WAIT_SRAD };
+
+  explicit Pmw3901Async(Pmw3901Bus& bus) : bus_(bus) {}
+
+  bool start();
+  bool poll(Pmw3901Burst& out);
+
+  // Microseconds until poll() can complete (0 when it can now or idle)
+  uint32_t wait_us();
+
+  State state() const { return state_; }
+  bool busy() const { return state_ != State::IDLE; }
+  uint32_t started_us() const { return t_start_; }   // burst latch time
+
+  uint32_t bursts() const { return bursts_; }
+  uint32_t early_polls() const { return early_polls_; }
+
+ private:
+  Pmw3901Bus& bus_;
+  State state_ = State::IDLE;
+  uint32_t t_start_ = 0;    // CS low
+  uint32_t t_addr_ = 0;     // address byte done
+  uint32_t t_exit_ = 0;     // CS high after the last burst
+  bool exited_ = false;     // t_exit_ valid
+  uint32_t bursts_ = 0;
+  uint32_t early_polls_ = 0;
+};
@@ -0,0 +1,50 @@
+#pragma once
+#include <stdint.h>
+
+// PMW3901 motion burst (register 0x16): one CS window returns motion,
+// deltas, SQUAL and shutter instead of a register read per field.
+//
+//   CS low, address 0x16, wait tSRAD_MOTBR, clock out 12 bytes, CS high
+//
+// Raising CS ends burst mode (tBEXIT before the next CS low). Reading the
+// burst clears the motion bit and the delta registers like reading
+// Motion then Delta_X/Y does.
+//
+// No Arduino dependencies (host test: test/pmw3901_burst_test.cpp).
+
+static constexpr uint8_t PMW3901_MOTION_BURST = 0x16;
+static constexpr uint8_t PMW3901_BURST_BYTES = 12;
+
+// Datasheet minimums (us), rounded up
+static constexpr uint32_t PMW3901_T_SRAD_MOTBR_US = 35;   // address -> first burst byte
+static constexpr uint32_t PMW3901_T_BEXIT_US = 1;         // CS high after a burst (500 ns)
+
+static constexpr uint8_t PMW3901_MOTION_MOT = 0x80;       // Motion bit7: new deltas
+
+struct Pmw3901Burst {
+  uint8_t motion = 0;
+  uint8_t observation = 0;
+  int16_t dx = 0;
+  int16_t dy = 0;
+  uint8_t squal = 0;
+  uint8_t raw_sum = 0;
+  uint8_t raw_max = 0;
+  uint8_t raw_min = 0;
+  uint16_t shutter = 0;
+};
+
+// Burst byte order: Motion, Observation, Delta_X_L, Delta_X_H, Delta_Y_L,
+// Delta_Y_H, SQUAL, RawData_Sum, Maximum_RawData, Minimum_RawData,
+// Shutter_Upper, Shutter_Lower
+inline void pmw3901_parse_burst(const uint8_t b[PMW3901_BURST_BYTES], Pmw3901Burst& out)
+{
+  out.motion = b[0];
+  out.observation = b[1];
+  out.dx = (int16_t)((uint16_t)b[3] << 8 | b[2]);
+  out.dy = (int16_t)((uint16_t)b[5] << 8 | b[4]);
+  out.squal = b[6];
+  out.raw_sum = b[7];
+  out.raw_max = b[8];
+  out.raw_min = b[9];
+  out.shutter = (uint16_t)((uint16_t)b[10] << 8 | b[11]);
+}
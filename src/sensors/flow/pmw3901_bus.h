@@ -0,0 +1,21 @@
+#pragma once
+#include <stdint.h>
+
+// What the PMW3901 code needs from the SPI device, plus a microsecond
+// clock (the gaps count from the end of a transfer, so callers read the
+// time themselves) and a delay. CS is held from select() to deselect(); on
+// target that also holds the shared bus, so a started burst must be
+// finished before another SPI device is used.
+//
+// Host tests implement it on a virtual clock (delay_us() just advances it).
+class Pmw3901Bus {
+ public:
+  virtual void select() = 0;
+  virtual void deselect() = 0;
+  virtual void transfer(const uint8_t* tx, uint8_t* rx, uint32_t n) = 0;
+  virtual uint32_t now_us() = 0;
+  virtual void delay_us(uint32_t us) = 0;
+
+ protected:
+  ~Pmw3901Bus() = default;
+};
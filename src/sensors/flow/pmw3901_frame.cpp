@@ -0,0 +1,86 @@
+#include "pmw3901_frame.h"
+
+#include <string.h>
+
+bool Pmw3901FrameAssembler::push(uint8_t raw)
+{
+  if (done()) return true;
+  switch (raw >> 6) {
+    case 0x1:
+      hi_ = (uint8_t)(raw << 2);
+      have_hi_ = true;
+      break;
+    case 0x2:
+      if (!have_hi_) {
+        out_of_order_++;
+        break;
+      }
+      px_[n_++] = (uint8_t)(hi_ | ((raw >> 2) & 0x03));
+      have_hi_ = false;
+      break;
+    default:
+      not_ready_++;
+      break;
+  }
+  return done();
+}
+
+uint16_t flow_frame_crc16(const uint8_t* p, size_t n, uint16_t crc)
+{
+  // CRC-16/CCITT-FALSE, bitwise: ~10 us per frame isn't worth a table
+  for (size_t i = 0; i < n; i++) {
+    crc ^= (uint16_t)p[i] << 8;
+    for (int b = 0; b < 8; b++) {
+      crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+
+size_t flow_frame_encode(const FlowFrame& f, uint8_t* out, size_t cap)
+{
+  if (cap < FLOW_FRAME_PACKET_MAX) return 0;
+  FlowFrameHeader h;
+  h.magic[0] = FLOW_FRAME_MAGIC0;
+  h.magic[1] = FLOW_FRAME_MAGIC1;
+  h.version = FLOW_FRAME_VERSION;
+  h.w = PMW3901_FRAME_W;
+  h.h = PMW3901_FRAME_W;
+  h.squal = f.squal;
+  h.seq = f.seq;
+  h.t_us = f.t_us;
+  h.shutter = f.shutter;
+  h.grab_us_div8 = (uint16_t)(f.grab_us / 8 > 0xFFFF ? 0xFFFF : f.grab_us / 8);
+
+  size_t n = 0;
+  memcpy(out, &h, sizeof(h));
+  n += sizeof(h);
+  memcpy(out + n, f.px, PMW3901_FRAME_PIXELS);
+  n += PMW3901_FRAME_PIXELS;
+  const uint16_t crc = flow_frame_crc16(out, n);
+  out[n++] = (uint8_t)(crc & 0xFF);
+  out[n++] = (uint8_t)(crc >> 8);
+  return n;
+}
+
+bool flow_frame_decode(const uint8_t* in, size_t n, FlowFrame& f)
+{
+  if (n < FLOW_FRAME_PACKET_MAX) return false;
+  FlowFrameHeader h;
+  memcpy(&h, in, sizeof(h));
+  if (h.magic[0] != FLOW_FRAME_MAGIC0 || h.magic[1] != FLOW_FRAME_MAGIC1) return false;
+  if (h.version != FLOW_FRAME_VERSION) return false;
+  if (h.w != PMW3901_FRAME_W || h.h != PMW3901_FRAME_W) return false;
+
+  const size_t body = sizeof(h) + PMW3901_FRAME_PIXELS;
+  const uint16_t crc = (uint16_t)(in[body] | (uint16_t)in[body + 1] << 8);
+  if (flow_frame_crc16(in, body) != crc) return false;
+
+  f.seq = h.seq;
+  f.t_us = h.t_us;
+  f.grab_us = (uint32_t)h.grab_us_div8 * 8;
+  f.squal = h.squal;
+  f.shutter = h.shutter;
+  memcpy(f.px, in + sizeof(h), PMW3901_FRAME_PIXELS);
+  return true;
+}
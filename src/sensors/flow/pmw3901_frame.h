@@ -0,0 +1,96 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// PMW3901 raw frame grab (diagnostic) and its wire format.
+//
+// Grab: write the PMW3901_FRAME_ENTER sequence, wait for RawData_Grab_Status
+// (0x59) bits 7:6, then read RawData_Grab (0x58) repeatedly. Each read
+// carries a 2-bit status in bits 7:6:
+//   01: pixel bits 7:2 in bits 5:0      10: pixel bits 1:0 in bits 3:2
+//   00 / 11: not ready, read again
+// 35 x 35 pixels, row-major as the sensor sends them. The sensor only
+// leaves frame mode through a reset (FlowPmw3901::begin() again).
+//
+// Wire format (little-endian), self-delimiting so it can share a serial
+// port with text output, one packet per UDP datagram:
+//   FlowFrameHeader | w*h pixel bytes | crc16 (CCITT, over header + pixels)
+//
+// No Arduino dependencies (host test: test/pmw3901_frame_test.cpp; host
+// decoder: tools/python/flow_frame_view.py).
+
+static constexpr uint8_t PMW3901_FRAME_W = 35;
+static constexpr uint16_t PMW3901_FRAME_PIXELS = PMW3901_FRAME_W * PMW3901_FRAME_W;
+
+static constexpr uint8_t PMW3901_RAWDATA_GRAB = 0x58;
+static constexpr uint8_t PMW3901_RAWDATA_GRAB_STATUS = 0x59;
+static constexpr uint8_t PMW3901_GRAB_READY = 0xC0;   // status bits 7:6
+
+// Bitcraze/PixArt frame capture register sequence
+struct Pmw3901RegWrite {
+  uint8_t reg, val;
+};
+static constexpr Pmw3901RegWrite PMW3901_FRAME_ENTER[] = {
+  {0x7F, 0x07}, {0x41, 0x1D}, {0x4C, 0x00}, {0x7F, 0x08}, {0x6A, 0x38},
+  {0x7F, 0x00}, {0x55, 0x04}, {0x40, 0x80}, {0x4D, 0x11}, {0x70, 0x00},
+  {0x58, 0xFF},
+};
+
+// Feeds RawData_Grab reads in, pixels out
+class Pmw3901FrameAssembler {
+ public:
+  explicit Pmw3901FrameAssembler(uint8_t* px) : px_(px) {}
+
+  // One 0x58 read; true once all pixels are in
+  bool push(uint8_t raw);
+
+  bool done() const { return n_ == PMW3901_FRAME_PIXELS; }
+  uint16_t pixels() const { return n_; }
+  uint32_t not_ready() const { return not_ready_; }     // 00 / 11 reads
+  uint32_t out_of_order() const { return out_of_order_; }  // low half without a high half
+
+ private:
+  uint8_t* px_;
+  uint16_t n_ = 0;
+  bool have_hi_ = false;
+  uint8_t hi_ = 0;
+  uint32_t not_ready_ = 0;
+  uint32_t out_of_order_ = 0;
+};
+
+// --- Wire format ---
+
+static constexpr uint8_t FLOW_FRAME_MAGIC0 = 'P';
+static constexpr uint8_t FLOW_FRAME_MAGIC1 = 'F';
+static constexpr uint8_t FLOW_FRAME_VERSION = 1;
+
+struct FlowFrameHeader {
+  uint8_t magic[2];
+  uint8_t version;
+  uint8_t w, h;
+  uint8_t squal;          // last SQUAL before the grab
+  uint16_t seq;
+  uint32_t t_us;          // grab start
+  uint16_t shutter;       // last shutter before the grab
+  uint16_t grab_us_div8;  // grab duration / 8 (diagnostic)
+} __attribute__((packed));
+
+static constexpr size_t FLOW_FRAME_PACKET_MAX =
+    sizeof(FlowFrameHeader) + PMW3901_FRAME_PIXELS + 2;   // 1243 bytes
+
+struct FlowFrame {
+  uint16_t seq = 0;
+  uint32_t t_us = 0;
+  uint32_t grab_us = 0;
+  uint8_t squal = 0;
+  uint16_t shutter = 0;
+  uint8_t px[PMW3901_FRAME_PIXELS] = {};
+};
+
+uint16_t flow_frame_crc16(const uint8_t* p, size_t n, uint16_t crc = 0xFFFF);
+
+// Packet into out (cap >= FLOW_FRAME_PACKET_MAX); bytes written, 0 if short
+size_t flow_frame_encode(const FlowFrame& f, uint8_t* out, size_t cap);
+
+// One packet starting at in[0]; false on bad magic/version/size/CRC
+bool flow_frame_decode(const uint8_t* in, size_t n, FlowFrame& f);
@@ -0,0 +1,120 @@
+#include "pmw3901_init.h"
+
+void Pmw3901RegIo::space_(bool next_is_write)
+{
+  if (!any_) return;
+  const uint32_t gap = last_write_
+      ? (next_is_write ? PMW3901_T_SWW_US : PMW3901_T_SWR_US)
+      : (next_is_write ? PMW3901_T_SRW_US : PMW3901_T_SRR_US);
+  // +1: a micros() difference of n can be anything in (n-1, n]
+  const uint32_t el = bus_.now_us() - last_end_;
+  if (el < gap + 1) bus_.delay_us(gap + 1 - el);
+}
+
+void Pmw3901RegIo::write(uint8_t reg, uint8_t val)
+{
+  space_(true);
+  const uint8_t tx[2] = { (uint8_t)(reg | 0x80u), val };
+  bus_.select();
+  bus_.transfer(tx, nullptr, 2);
+  last_end_ = bus_.now_us();
+  bus_.delay_us(PMW3901_T_SCLK_NCS_W_US + 1);
+  bus_.deselect();
+  any_ = true;
+  last_write_ = true;
+}
+
+uint8_t Pmw3901RegIo::read(uint8_t reg)
+{
+  space_(false);
+  const uint8_t a = (uint8_t)(reg & 0x7Fu);
+  uint8_t v = 0;
+  bus_.select();
+  bus_.transfer(&a, nullptr, 1);
+  bus_.delay_us(PMW3901_T_SRAD_US + 1);
+  bus_.transfer(nullptr, &v, 1);
+  last_end_ = bus_.now_us();
+  bus_.deselect();
+  any_ = true;
+  last_write_ = false;
+  return v;
+}
+
+bool pmw3901_load(Pmw3901RegIo& io, const Pmw3901InitStep* steps, size_t n,
+                  Pmw3901InitReport& rep)
+{
+  rep = Pmw3901InitReport{};
+  rep.id_ok = true;
+  const uint32_t t0 = io.now_us();
+  bool failed = false;
+
+  auto fail = [&](const Pmw3901InitStep& s, uint8_t got) {
+    if (!failed) {
+      rep.bad_reg = s.reg;
+      rep.bad_want = s.val;
+      rep.bad_got = got;
+    }
+    failed = true;
+  };
+
+  for (size_t i = 0; i < n; i++) {
+    const Pmw3901InitStep& s = steps[i];
+    rep.steps++;
+    switch (s.op) {
+      case Pmw3901Op::WRITE:
+        io.write(s.reg, s.val);
+        rep.writes++;
+        break;
+
+      case Pmw3901Op::WRITE_VERIFY:
+      case Pmw3901Op::WRITE_CHECK: {
+        io.write(s.reg, s.val);
+        rep.writes++;
+        rep.verified++;
+        uint8_t got = io.read(s.reg);
+        if (got != s.val) {
+          rep.retries++;
+          io.write(s.reg, s.val);
+          rep.writes++;
+          got = io.read(s.reg);
+          if (got != s.val) {
+            if (s.op == Pmw3901Op::WRITE_CHECK) {
+              rep.unconfirmed++;
+            } else {
+              rep.mismatches++;
+              fail(s, got);
+            }
+          }
+        }
+        break;
+      }
+
+      case Pmw3901Op::READ:
+        io.read(s.reg);
+        break;
+
+      case Pmw3901Op::EXPECT: {
+        const uint8_t got = io.read(s.reg);
+        if (got != s.val) {
+          // Wrong chip or no chip: the rest would be writes into nothing
+          rep.id_ok = false;
+          fail(s, got);
+          rep.total_us = io.now_us() - t0;
+          return false;
+        }
+        break;
+      }
+
+      case Pmw3901Op::WAIT_MS: {
+        const uint32_t us = (uint32_t)s.val * 1000u;
+        io.wait_us(us);
+        rep.wait_us += us;
+        break;
+      }
+    }
+  }
+
+  rep.total_us = io.now_us() - t0;
+  rep.ok = !failed;
+  return rep.ok;
+}
@@ -0,0 +1,126 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include "pmw3901_bus.h"
+
+// PMW3901 bring-up as data: power-on reset, ID check, motion register
+// prime and the Bitcraze/PixArt performance-optimisation script, run by a
+// loader that spaces register accesses by the datasheet minimums instead
+// of fixed padding, reads back the bank selects (reported, not fatal), and
+// times the whole thing.
+//
+// No Arduino dependencies (host test with a recording fake SPI:
+// test/pmw3901_init_test.cpp).
+
+// Datasheet SPI minimums (us), rounded up. Gaps count from the end of the
+// last data byte.
+static constexpr uint32_t PMW3901_T_SRAD_US = 35;        // read address -> data
+static constexpr uint32_t PMW3901_T_SCLK_NCS_W_US = 35;  // last write bit -> CS high
+static constexpr uint32_t PMW3901_T_SWW_US = 45;         // write -> write
+static constexpr uint32_t PMW3901_T_SWR_US = 45;         // write -> read
+static constexpr uint32_t PMW3901_T_SRW_US = 20;         // read -> write
+static constexpr uint32_t PMW3901_T_SRR_US = 20;         // read -> read
+
+static constexpr uint8_t PMW3901_REG_BANK = 0x7F;
+
+// Register access with minimal legal spacing. Tracks the end of the last
+// access and waits out only what is left of the gap.
+class Pmw3901RegIo {
+ public:
+  explicit Pmw3901RegIo(Pmw3901Bus& bus) : bus_(bus) {}
+
+  void write(uint8_t reg, uint8_t val);
+  uint8_t read(uint8_t reg);
+  void wait_us(uint32_t us) { bus_.delay_us(us); }
+  uint32_t now_us() { return bus_.now_us(); }
+
+ private:
+  void space_(bool next_is_write);
+
+  Pmw3901Bus& bus_;
+  bool any_ = false;
+  bool last_write_ = false;
+  uint32_t last_end_ = 0;
+};
+
+enum class Pmw3901Op : uint8_t {
+  WRITE,
+  WRITE_VERIFY,   // write, read back, one retry; still wrong fails init
+  WRITE_CHECK,    // same, but still wrong is only counted (undocumented regs)
+  READ,           // read and discard (clears motion registers)
+  EXPECT,         // read, must equal val (IDs); stops the load otherwise
+  WAIT_MS,        // val ms
+};
+
+struct Pmw3901InitStep {
+  Pmw3901Op op;
+  uint8_t reg;
+  uint8_t val;
+};
+
+constexpr Pmw3901InitStep pmw3901_wr(uint8_t reg, uint8_t val) { return {Pmw3901Op::WRITE, reg, val}; }
+// 0x7F isn't in the datasheet and nothing promises it reads back, so a
+// mismatch there is reported but doesn't fail the init
+constexpr Pmw3901InitStep pmw3901_bank(uint8_t bank) { return {Pmw3901Op::WRITE_CHECK, PMW3901_REG_BANK, bank}; }
+constexpr Pmw3901InitStep pmw3901_rd(uint8_t reg) { return {Pmw3901Op::READ, reg, 0}; }
+constexpr Pmw3901InitStep pmw3901_expect(uint8_t reg, uint8_t val) { return {Pmw3901Op::EXPECT, reg, val}; }
+constexpr Pmw3901InitStep pmw3901_wait_ms(uint8_t ms) { return {Pmw3901Op::WAIT_MS, 0, ms}; }
+
+// Same order and values as the hand-written sequence it replaced
+static constexpr Pmw3901InitStep PMW3901_INIT[] = {
+  // Power-on reset, ID, clear motion
+  pmw3901_wr(0x3A, 0x5A), pmw3901_wait_ms(5),
+  pmw3901_expect(0x00, 0x49), pmw3901_expect(0x5F, 0xB6),
+  pmw3901_rd(0x02), pmw3901_rd(0x03), pmw3901_rd(0x04), pmw3901_rd(0x05), pmw3901_rd(0x06),
+  pmw3901_wait_ms(1),
+
+  // Performance optimisation registers (Bitcraze PMW3901 lib)
+  pmw3901_bank(0x00), pmw3901_wr(0x61, 0xAD),
+  pmw3901_bank(0x03), pmw3901_wr(0x40, 0x00),
+  pmw3901_bank(0x05), pmw3901_wr(0x41, 0xB3), pmw3901_wr(0x43, 0xF1), pmw3901_wr(0x45, 0x14),
+  pmw3901_wr(0x5B, 0x32), pmw3901_wr(0x5F, 0x34), pmw3901_wr(0x7B, 0x08),
+  pmw3901_bank(0x06), pmw3901_wr(0x44, 0x1B), pmw3901_wr(0x40, 0xBF), pmw3901_wr(0x4E, 0x3F),
+  pmw3901_bank(0x08), pmw3901_wr(0x65, 0x20), pmw3901_wr(0x6A, 0x18),
+  pmw3901_bank(0x09), pmw3901_wr(0x4F, 0xAF), pmw3901_wr(0x5F, 0x40), pmw3901_wr(0x48, 0x80),
+  pmw3901_wr(0x49, 0x80), pmw3901_wr(0x57, 0x77), pmw3901_wr(0x60, 0x78), pmw3901_wr(0x61, 0x78),
+  pmw3901_wr(0x62, 0x08), pmw3901_wr(0x63, 0x50),
+  pmw3901_bank(0x0A), pmw3901_wr(0x45, 0x60),
+  pmw3901_bank(0x00), pmw3901_wr(0x4D, 0x11), pmw3901_wr(0x55, 0x80), pmw3901_wr(0x74, 0x1F),
+  pmw3901_wr(0x75, 0x1F), pmw3901_wr(0x4A, 0x78), pmw3901_wr(0x4B, 0x78), pmw3901_wr(0x44, 0x08),
+  pmw3901_wr(0x45, 0x50), pmw3901_wr(0x64, 0xFF), pmw3901_wr(0x65, 0x1F),
+  pmw3901_bank(0x14), pmw3901_wr(0x65, 0x60), pmw3901_wr(0x66, 0x08), pmw3901_wr(0x63, 0x78),
+  pmw3901_bank(0x15), pmw3901_wr(0x48, 0x58),
+  pmw3901_bank(0x07), pmw3901_wr(0x41, 0x0D), pmw3901_wr(0x43, 0x14), pmw3901_wr(0x4B, 0x0E),
+  pmw3901_wr(0x45, 0x0F), pmw3901_wr(0x44, 0x42), pmw3901_wr(0x4C, 0x80),
+  pmw3901_bank(0x10), pmw3901_wr(0x5B, 0x02),
+  pmw3901_bank(0x07), pmw3901_wr(0x40, 0x41), pmw3901_wr(0x70, 0x00),
+
+  pmw3901_wait_ms(100),
+  pmw3901_wr(0x32, 0x44),
+  pmw3901_bank(0x07), pmw3901_wr(0x40, 0x40),
+  pmw3901_bank(0x06), pmw3901_wr(0x62, 0xF0), pmw3901_wr(0x63, 0x00),
+  pmw3901_bank(0x0D), pmw3901_wr(0x48, 0xC0), pmw3901_wr(0x6F, 0xD5),
+  pmw3901_bank(0x00), pmw3901_wr(0x5B, 0xA0), pmw3901_wr(0x4E, 0xA8), pmw3901_wr(0x5A, 0x50),
+  pmw3901_wr(0x40, 0x80),
+};
+static constexpr size_t PMW3901_INIT_STEPS = sizeof(PMW3901_INIT) / sizeof(PMW3901_INIT[0]);
+
+struct Pmw3901InitReport {
+  bool ok = false;             // IDs matched and every WRITE_VERIFY stuck
+  bool id_ok = false;
+  uint16_t steps = 0;          // executed
+  uint16_t writes = 0;         // including retries
+  uint16_t verified = 0;
+  uint16_t retries = 0;
+  uint16_t mismatches = 0;     // WRITE_VERIFY still wrong after the retry
+  uint16_t unconfirmed = 0;    // WRITE_CHECK (bank selects) still wrong after the retry
+  uint8_t bad_reg = 0;         // first EXPECT / verify failure
+  uint8_t bad_want = 0;
+  uint8_t bad_got = 0;
+  uint32_t total_us = 0;
+  uint32_t wait_us = 0;        // of total_us, WAIT_MS steps
+};
+
+bool pmw3901_load(Pmw3901RegIo& io, const Pmw3901InitStep* steps, size_t n,
+                  Pmw3901InitReport& rep);
@@ -19,17 +19,8 @@ int8_t bmi2_spi_read(uint8_t reg_addr, uint8_t *reg_data, uint32_t len, void *in
 
   const uint8_t addr = reg_addr | 0x80; // read bit
 
-  SPI.beginTransaction(ctx->settings);
-  digitalWrite(ctx->cs_pin, LOW);
-
-  SPI.transfer(addr);
-  for (uint32_t i = 0; i < len; i++) {
-    reg_data[i] = SPI.transfer(0x00);
-  }
-
-  digitalWrite(ctx->cs_pin, HIGH);
-  SPI.endTransaction();
-  return BMI2_OK;
+  // One CS-framed burst (single DMA transaction with SPI_BUS_IDF)
+  return ctx->spi.read_reg(addr, reg_data, len) ? BMI2_OK : BMI2_E_COM_FAIL;
 }
 
 int8_t bmi2_spi_write(uint8_t reg_addr, const uint8_t *reg_data, uint32_t len, void *intf_ptr)
@@ -39,17 +30,7 @@ int8_t bmi2_spi_write(uint8_t reg_addr, const uint8_t *reg_data, uint32_t len, v
 
   const uint8_t addr = reg_addr & 0x7F; // write
 
-  SPI.beginTransaction(ctx->settings);
-  digitalWrite(ctx->cs_pin, LOW);
-
-  SPI.transfer(addr);
-  for (uint32_t i = 0; i < len; i++) {
-    SPI.transfer(reg_data[i]);
-  }
-
-  digitalWrite(ctx->cs_pin, HIGH);
-  SPI.endTransaction();
-  return BMI2_OK;
+  return ctx->spi.write_reg(addr, reg_data, len) ? BMI2_OK : BMI2_E_COM_FAIL;
 }
 
 } // extern "C"
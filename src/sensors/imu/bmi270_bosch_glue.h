@@ -2,6 +2,8 @@
 #include <Arduino.h>
 #include <SPI.h>
 
+#include "board/spi_bus.h"
+
 extern "C" {
   #include "bmi2.h"
   #include "bmi270.h"
@@ -21,6 +23,5 @@ extern "C" {
 }
 
 struct Bmi270SpiIntf {
-  uint8_t cs_pin;
-  SPISettings settings;
+  SpiDevice spi;
 };
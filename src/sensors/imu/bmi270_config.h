@@ -0,0 +1,95 @@
+#pragma once
+#include <stdint.h>
+
+extern "C" {
+  #include "bmi2.h"
+}
+
+#include "bmi270_convert.h"
+
+// BMI270 setup captured once, at compile time: ranges, ODR, filters and the
+// sensor -> body axis map. Everything that used to be repeated by hand is
+// derived from it:
+//   - the bmi2_sens_config written in begin()      (bmi270_fill_config)
+//   - the raw -> SI factors in the hot path         (scale(), folded)
+//   - the FIFO/sensortime period                    (period_us, sensortime_ticks)
+//   - the sensor -> FRU remap                       (bmi270_to_body)
+// The instance lives in config/imu_config.h; a range change there can't
+// leave the scaling behind.
+
+// One body axis: sign * sensor[src]
+struct Bmi270Axis {
+  uint8_t src;   // sensor axis 0..2
+  int8_t sign;   // +1 / -1
+};
+
+struct Bmi270Config {
+  uint8_t acc_range;   // BMI2_ACC_RANGE_*
+  uint8_t gyr_range;   // BMI2_GYR_RANGE_*
+  uint8_t odr;         // BMI2_ACC_ODR_* (same codes as BMI2_GYR_ODR_*), 100..1600 Hz
+  uint8_t acc_bwp;     // BMI2_ACC_*_AVG* / BMI2_ACC_NORMAL_AVG4
+  uint8_t gyr_bwp;     // BMI2_GYR_*_MODE
+  Bmi270Axis body[3];  // body x, y, z
+
+  // ±2/4/8/16 g
+  constexpr float acc_range_g() const
+  {
+    return acc_range <= BMI2_ACC_RANGE_16G ? (float)(2 << acc_range) : 0.0f;
+  }
+
+  // ±2000/1000/500/250/125 dps
+  constexpr float gyr_range_dps() const
+  {
+    return gyr_range <= BMI2_GYR_RANGE_125 ? 2000.0f / (float)(1 << gyr_range) : 0.0f;
+  }
+
+  constexpr uint32_t odr_hz() const
+  {
+    return (odr >= BMI2_ACC_ODR_100HZ && odr <= BMI2_ACC_ODR_1600HZ)
+               ? 100u << (odr - BMI2_ACC_ODR_100HZ) : 0u;
+  }
+
+  constexpr uint32_t period_us() const { return 1000000u / odr_hz(); }
+
+  // Sensortime runs at 25.6 kHz (39.0625 us/tick)
+  constexpr uint16_t sensortime_ticks() const { return (uint16_t)(25600u / odr_hz()); }
+
+  constexpr Bmi270Scale scale() const { return Bmi270Scale::make(acc_range_g(), gyr_range_dps()); }
+
+  constexpr bool axis_ok(int i) const
+  {
+    return body[i].src < 3 && (body[i].sign == 1 || body[i].sign == -1);
+  }
+
+  // Ranges/ODR known, and body[] is a signed permutation of the sensor axes
+  constexpr bool valid() const
+  {
+    return acc_range_g() > 0.0f && gyr_range_dps() > 0.0f && odr_hz() > 0 &&
+           axis_ok(0) && axis_ok(1) && axis_ok(2) &&
+           body[0].src != body[1].src && body[0].src != body[2].src && body[1].src != body[2].src;
+  }
+};
+
+// Fill the accel/gyro entries read back by bmi2_get_sensor_config()
+inline void bmi270_fill_config(const Bmi270Config &c, bmi2_sens_config &acc, bmi2_sens_config &gyr)
+{
+  acc.cfg.acc.odr = c.odr;
+  acc.cfg.acc.range = c.acc_range;
+  acc.cfg.acc.bwp = c.acc_bwp;
+  acc.cfg.acc.filter_perf = BMI2_PERF_OPT_MODE;
+
+  gyr.cfg.gyr.odr = c.odr;
+  gyr.cfg.gyr.range = c.gyr_range;
+  gyr.cfg.gyr.bwp = c.gyr_bwp;
+  gyr.cfg.gyr.noise_perf = BMI2_PERF_OPT_MODE;
+  gyr.cfg.gyr.filter_perf = BMI2_PERF_OPT_MODE;
+}
+
+// Sensor frame -> body frame. With a constexpr config this folds to moves
+// and sign flips.
+inline void bmi270_to_body(const Bmi270Config &c, const float in[3], float out[3])
+{
+  for (int i = 0; i < 3; i++) {
+    out[i] = c.body[i].sign < 0 ? -in[c.body[i].src] : in[c.body[i].src];
+  }
+}
@@ -0,0 +1,22 @@
+#include "bmi270_convert.h"
+
+static inline int16_t le16(const uint8_t *p)
+{
+  return (int16_t)(uint16_t)(p[0] | ((uint16_t)p[1] << 8));
+}
+
+void bmi270_unpack_regs(const uint8_t regs[BMI270_DATA_BYTES], int16_t cross_zx,
+                        int16_t acc[3], int16_t gyr[3])
+{
+  acc[0] = le16(regs + 0);
+  acc[1] = le16(regs + 2);
+  acc[2] = le16(regs + 4);
+  gyr[0] = le16(regs + 6);
+  gyr[1] = le16(regs + 8);
+  gyr[2] = le16(regs + 10);
+
+  // Same as Bosch comp_gyro_cross_axis_sensitivity(), including the int16
+  // truncation of the correction term and the saturation
+  const int32_t x = (int32_t)gyr[0] - (int16_t)(((int32_t)cross_zx * (int32_t)gyr[2]) / 512);
+  gyr[0] = (int16_t)(x > 32767 ? 32767 : (x < -32768 ? -32768 : x));
+}
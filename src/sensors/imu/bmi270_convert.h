@@ -0,0 +1,78 @@
+#pragma once
+#include <stdint.h>
+
+// BMI270 data registers -> SI, without going through bmi2_get_sensor_data.
+//
+// The hot path bursts the 12 data bytes (ACC_X_LSB 0x0C .. GYR_Z_MSB 0x17)
+// in one transaction and converts them here. bmi2_get_sensor_data reads 24
+// bytes from STATUS (aux + sensortime we don't use) and parses them through
+// several copies; the Bosch API is still used for configuration.
+//
+// Results are bit-identical to the old read_raw_sample() path:
+//   - bmi270_unpack_regs() applies the same gyro z->x cross-axis correction
+//     the Bosch parser does (the remap is identity, bmi2_sec_init default)
+//   - bmi270_raw_to_si() multiplies by one precomputed scale per sensor.
+//     (x / 32768) * (range * k) and x * ((range * k) / 32768) round the
+//     same since the / 32768 is an exact power of two.
+//
+// Pure functions, no Arduino: tested on host (test/bmi270_convert_test.cpp).
+
+static constexpr uint8_t BMI270_DATA_REG = 0x0C;     // ACC_X_LSB
+static constexpr uint8_t BMI270_DATA_BYTES = 12;     // acc xyz, gyr xyz
+
+// SI units per LSB for a given range
+struct Bmi270Scale {
+  float acc;   // m/s^2 per LSB
+  float gyr;   // rad/s per LSB
+
+  static constexpr float G = 9.80665f;
+  static constexpr float DEG2RAD = 3.14159265358979323846f / 180.0f;
+  static constexpr float INV_32768 = 1.0f / 32768.0f;
+
+  static constexpr Bmi270Scale make(float acc_range_g, float gyr_range_dps)
+  {
+    return Bmi270Scale{ (acc_range_g * G) * INV_32768, (gyr_range_dps * DEG2RAD) * INV_32768 };
+  }
+};
+
+// Little-endian register bytes -> counts. cross_zx is bmi2_dev::gyr_cross_sens_zx.
+void bmi270_unpack_regs(const uint8_t regs[BMI270_DATA_BYTES], int16_t cross_zx,
+                        int16_t acc[3], int16_t gyr[3]);
+
+// A burst that came back all 0x00 or all 0xFF is the bus, not the sensor
+// (MISO stuck, sensor unpowered or in reset): at rest gravity alone rules
+// out all-zero, and -1 count on all six axes at once doesn't happen.
+inline bool bmi270_regs_stuck(const uint8_t regs[BMI270_DATA_BYTES])
+{
+  const uint8_t b = regs[0];
+  if (b != 0x00 && b != 0xFF) return false;
+  for (uint8_t i = 1; i < BMI270_DATA_BYTES; i++) {
+    if (regs[i] != b) return false;
+  }
+  return true;
+}
+
+// Counts -> m/s^2 and rad/s (sensor frame, no bias removed). Inline so a
+// constexpr scale (IMU_CFG.scale()) folds into the multiplies.
+inline void bmi270_raw_to_si(const int16_t acc[3], const int16_t gyr[3], const Bmi270Scale &k,
+                             float acc_si[3], float gyr_si[3])
+{
+  acc_si[0] = acc[0] * k.acc;
+  acc_si[1] = acc[1] * k.acc;
+  acc_si[2] = acc[2] * k.acc;
+  gyr_si[0] = gyr[0] * k.gyr;
+  gyr_si[1] = gyr[1] * k.gyr;
+  gyr_si[2] = gyr[2] * k.gyr;
+}
+
+// TEMPERATURE_0/1 (0x22, 0x23) -> °C: 0x0000 = 23 °C, 1/512 K per LSB.
+// 0x8000 means no valid reading (sensors off / not updated yet).
+static constexpr uint8_t BMI270_TEMP_REG = 0x22;
+
+inline bool bmi270_temp_c(const uint8_t regs[2], float &out)
+{
+  const int16_t raw = (int16_t)(uint16_t)(regs[0] | ((uint16_t)regs[1] << 8));
+  if (raw == INT16_MIN) return false;
+  out = 23.0f + raw * (1.0f / 512.0f);
+  return true;
+}
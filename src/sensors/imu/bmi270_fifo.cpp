@@ -0,0 +1,128 @@
+#include "bmi270_fifo.h"
+#include <string.h>
+
+static constexpr uint32_t SENSORTIME_MASK = 0xFFFFFF;
+
+int8_t Bmi270Fifo::configure(bmi2_dev& dev) {
+  // FIFO reads need advanced power save off (Bosch note on bmi2_read_fifo_data)
+  int8_t rslt = bmi2_set_adv_power_save(BMI2_DISABLE, &dev);
+  if (rslt != BMI2_OK) return rslt;
+
+  rslt = bmi2_set_fifo_config(BMI2_FIFO_ALL_EN | BMI2_FIFO_STOP_ON_FULL, BMI2_DISABLE, &dev);
+  if (rslt != BMI2_OK) return rslt;
+
+  // Keep newest data on overflow (stop-on-full off), header mode so the
+  // sensor can insert skip and sensortime frames.
+  rslt = bmi2_set_fifo_config(BMI2_FIFO_ACC_EN | BMI2_FIFO_GYR_EN | BMI2_FIFO_HEADER_EN |
+                              BMI2_FIFO_TIME_EN, BMI2_ENABLE, &dev);
+  if (rslt != BMI2_OK) return rslt;
+
+  return bmi2_set_command_register(BMI2_FIFO_FLUSH_CMD, &dev);
+}
+
+int8_t Bmi270Fifo::enable_int1(bmi2_dev& dev, uint8_t wm_frames) {
+  int8_t rslt = bmi2_set_fifo_wm((uint16_t)(wm_frames * FRAME_BYTES), &dev);
+  if (rslt != BMI2_OK) return rslt;
+
+  bmi2_int_pin_config pin;
+  memset(&pin, 0, sizeof(pin));
+  pin.pin_type = BMI2_INT1;
+  pin.int_latch = BMI2_INT_NON_LATCH;
+  pin.pin_cfg[0].lvl = BMI2_INT_ACTIVE_HIGH;
+  pin.pin_cfg[0].od = BMI2_INT_PUSH_PULL;
+  pin.pin_cfg[0].output_en = BMI2_INT_OUTPUT_ENABLE;
+  pin.pin_cfg[0].input_en = BMI2_INT_INPUT_DISABLE;
+  rslt = bmi2_set_int_pin_config(&pin, &dev);
+  if (rslt != BMI2_OK) return rslt;
+
+  return bmi2_map_data_int(BMI2_FWM_INT, BMI2_INT1, &dev);
+}
+
+int8_t Bmi270Fifo::read(bmi2_dev& dev, Bmi270FifoBatch& out) {
+  out.count = 0;
+  out.has_sensor_time = false;
+  out.unpaired = 0;
+  out.skipped = 0;
+
+  uint16_t fill = 0;
+  int8_t rslt = bmi2_get_fifo_length(&fill, &dev);
+  out.fifo_bytes = fill;
+  if (rslt != BMI2_OK) return rslt;
+  if (fill == 0) return BMI2_W_FIFO_EMPTY;
+
+  // Drain completely when it fits: reading past the last frame makes the
+  // sensor append a sensortime frame. Otherwise read whole frames only so the
+  // FIFO read pointer stays frame-aligned for the next burst.
+  uint16_t len;
+  if (fill <= Bmi270FifoBatch::MAX_FRAMES * FRAME_BYTES) {
+    len = fill + SENSORTIME_FRAME_BYTES;
+  } else {
+    len = Bmi270FifoBatch::MAX_FRAMES * FRAME_BYTES;
+  }
+
+  bmi2_fifo_frame fifo;
+  memset(&fifo, 0, sizeof(fifo));
+  fifo.data = buf_;
+  fifo.length = len + dev.dummy_byte;
+
+  rslt = bmi2_read_fifo_data(&fifo, &dev);
+  if (rslt != BMI2_OK) return rslt;
+
+  return unpack(fifo, dev, out);
+}
+
+int8_t Bmi270Fifo::unpack(bmi2_fifo_frame& fifo, const bmi2_dev& dev, Bmi270FifoBatch& out) {
+  out.count = 0;
+  out.has_sensor_time = false;
+  out.sensor_time = 0;
+  out.unpaired = 0;
+
+  // The extractors keep separate byte cursors in fifo; both passes walk the
+  // whole buffer and pick up the sensortime/skip frames on the way.
+  bmi2_sens_axes_data* acc = acc_;
+  bmi2_sens_axes_data* gyr = gyr_;
+
+  uint16_t n_acc = EXTRACT_SLOTS;
+  uint16_t n_gyr = EXTRACT_SLOTS;
+  int8_t rslt = bmi2_extract_accel(acc, &n_acc, &fifo, &dev);
+  if (rslt < BMI2_OK) return rslt;
+  rslt = bmi2_extract_gyro(gyr, &n_gyr, &fifo, &dev);
+  if (rslt < BMI2_OK) return rslt;
+
+  // With equal ODRs every header is a combined gyr+acc frame, so the two
+  // lists line up; keep the newest common frames if they ever differ.
+  uint16_t n = n_acc < n_gyr ? n_acc : n_gyr;
+  if (n > Bmi270FifoBatch::MAX_FRAMES) n = Bmi270FifoBatch::MAX_FRAMES;
+  const uint16_t a0 = n_acc - n;
+  const uint16_t g0 = n_gyr - n;
+  out.unpaired = (uint16_t)(n_acc + n_gyr - 2 * n);
+  out.skipped = fifo.skipped_frame_count;
+
+  for (uint16_t i = 0; i < n; i++) {
+    Bmi270FifoFrame& f = out.f[i];
+    f.acc[0] = acc[a0 + i].x;
+    f.acc[1] = acc[a0 + i].y;
+    f.acc[2] = acc[a0 + i].z;
+    f.gyr[0] = gyr[g0 + i].x;
+    f.gyr[1] = gyr[g0 + i].y;
+    f.gyr[2] = gyr[g0 + i].z;
+    f.sensor_time = 0;
+  }
+  out.count = n;
+
+  // Sensortime frame = sensor time at the read. Frames are produced on the
+  // ODR grid of the same counter, so the newest one sits on the last
+  // multiple of odr_ticks at or before it; older ones step back from there.
+  if (fifo.sensor_time != 0) {
+    out.has_sensor_time = true;
+    out.sensor_time = fifo.sensor_time & SENSORTIME_MASK;
+
+    const uint32_t newest = out.sensor_time - (out.sensor_time % odr_ticks_);
+    for (uint16_t i = 0; i < n; i++) {
+      const uint32_t back = (uint32_t)(n - 1 - i) * odr_ticks_;
+      out.f[i].sensor_time = (newest - back) & SENSORTIME_MASK;
+    }
+  }
+
+  return BMI2_OK;
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <stdint.h>
+
+extern "C" {
+  #include "bmi2.h"
+}
+
+// BMI270 FIFO batch acquisition (header mode, accel + gyro + sensortime).
+//
+// Built on the Bosch API: bmi2_set_fifo_config / bmi2_get_fifo_length /
+// bmi2_read_fifo_data / bmi2_extract_accel / bmi2_extract_gyro. One burst
+// returns every frame produced since the last read, so nothing is dropped
+// when the sensor ODR is above our read rate.
+//
+// No Arduino dependencies: the parser runs on host against FIFO byte dumps
+// (see test/bmi270_fifo_test.cpp).
+
+// One accel+gyro frame, raw sensor-frame counts.
+struct Bmi270FifoFrame {
+  int16_t acc[3];
+  int16_t gyr[3];
+  uint32_t sensor_time;  // 24-bit sensortime (39.0625 us/LSB) the frame was produced at
+};
+
+struct Bmi270FifoBatch {
+  static constexpr uint16_t MAX_FRAMES = 64;   // 40 ms at 1.6 kHz
+
+  Bmi270FifoFrame f[MAX_FRAMES];
+  uint16_t count = 0;
+
+  // Sensortime frame appended by the sensor when the read drains the FIFO.
+  // Missing when the FIFO held more than MAX_FRAMES (the rest stays queued
+  // for the next read); frame sensor_time is then left 0.
+  bool has_sensor_time = false;
+  uint32_t sensor_time = 0;
+
+  uint16_t fifo_bytes = 0;    // FIFO fill level before the read
+  uint16_t unpaired = 0;      // accel/gyro frames without a partner (dropped)
+  uint8_t skipped = 0;        // frames lost to FIFO overflow (sensor's skip frame)
+};
+
+class Bmi270Fifo {
+ public:
+  static constexpr uint32_t SENSORTIME_NS = 39063;   // 39.0625 us, rounded
+  static constexpr uint8_t FRAME_BYTES = 1 + 12;     // header + acc + gyr
+  static constexpr uint8_t SENSORTIME_FRAME_BYTES = 1 + 3;
+
+  // odr_ticks: frame period in sensortime LSBs (400 Hz -> 64, 1.6 kHz -> 16)
+  explicit Bmi270Fifo(uint16_t odr_ticks = 64) : odr_ticks_(odr_ticks) {}
+
+  // Enable header-mode FIFO with accel, gyro and sensortime; flushes it.
+  // Accel and gyro must already run at the same ODR.
+  int8_t configure(bmi2_dev& dev);
+
+  // FIFO watermark interrupt on INT1 (push-pull, active high, non-latched):
+  // the pin rises once wm_frames frames are queued and drops when a read
+  // takes the fill level back under it.
+  int8_t enable_int1(bmi2_dev& dev, uint8_t wm_frames);
+
+  // Burst-read everything queued (up to MAX_FRAMES) and unpack it.
+  int8_t read(bmi2_dev& dev, Bmi270FifoBatch& out);
+
+  // Parse a buffer filled by bmi2_read_fifo_data(). Exposed for host tests.
+  int8_t unpack(bmi2_fifo_frame& fifo, const bmi2_dev& dev, Bmi270FifoBatch& out);
+
+  uint16_t odr_ticks() const { return odr_ticks_; }
+
+ private:
+  // Worst case: MAX_FRAMES frames + sensortime frame + SPI dummy byte
+  static constexpr uint16_t BUF_BYTES =
+      Bmi270FifoBatch::MAX_FRAMES * FRAME_BYTES + SENSORTIME_FRAME_BYTES + 1;
+
+  uint16_t odr_ticks_;
+  uint8_t buf_[BUF_BYTES];
+  // One spare slot: the Bosch extractors stop as soon as the output is full,
+  // which would skip a sensortime frame sitting right after the last frame.
+  static constexpr uint16_t EXTRACT_SLOTS = Bmi270FifoBatch::MAX_FRAMES + 1;
+
+  bmi2_sens_axes_data acc_[EXTRACT_SLOTS];
+  bmi2_sens_axes_data gyr_[EXTRACT_SLOTS];
+};
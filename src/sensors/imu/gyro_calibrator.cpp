@@ -0,0 +1,60 @@
+#include "gyro_calibrator.h"
+
+#include <math.h>
+
+void GyroCalibrator::start(const float seed[3])
+{
+  *this = GyroCalibrator{};
+  if (seed) {
+    for (int i = 0; i < 3; i++) bias_[i] = seed[i];
+    source_ = Source::SEED;
+    checking_seed_ = true;
+    target_ = SEED_CHECK_SAMPLES;
+  }
+}
+
+bool GyroCalibrator::add(const float acc[3], const float gyr[3])
+{
+  if (done_) return false;
+  samples_++;
+
+  const float gmag = sqrtf(gyr[0] * gyr[0] + gyr[1] * gyr[1] + gyr[2] * gyr[2]);
+  const float amag = sqrtf(acc[0] * acc[0] + acc[1] * acc[1] + acc[2] * acc[2]);
+  still_ = (gmag < GYRO_MAX_RAD_S) && (fabsf(amag - G) < ACC_MAG_TOL);
+
+  if (!still_) {
+    if (n_ > 0) motion_resets_++;
+    n_ = 0;
+    sum_[0] = sum_[1] = sum_[2] = 0;
+    return false;
+  }
+
+  sum_[0] += gyr[0];
+  sum_[1] += gyr[1];
+  sum_[2] += gyr[2];
+  n_++;
+  if (n_ < target_) return false;
+
+  const float mean[3] = { sum_[0] / n_, sum_[1] / n_, sum_[2] / n_ };
+
+  if (checking_seed_) {
+    checking_seed_ = false;
+    const bool agrees = fabsf(mean[0] - bias_[0]) < SEED_TOL_RAD_S &&
+                        fabsf(mean[1] - bias_[1]) < SEED_TOL_RAD_S &&
+                        fabsf(mean[2] - bias_[2]) < SEED_TOL_RAD_S;
+    if (agrees) {
+      done_ = true;   // keep the seed: it came from a full window
+      return true;
+    }
+    // Seed is stale (temperature, knock): keep using it until the full
+    // window is in, continuing from the samples we already have
+    seed_rejected_ = true;
+    target_ = TARGET_SAMPLES;
+    return false;
+  }
+
+  for (int i = 0; i < 3; i++) bias_[i] = mean[i];
+  source_ = Source::MEASURED;
+  done_ = true;
+  return true;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <stdint.h>
+
+// Incremental gyro bias calibration, fed one sample at a time from the fast
+// loop (replaces the blocking 2 s loop that used to run in begin()).
+//
+// Samples are sensor frame, SI, without bias removed. A sample counts as
+// still when |gyro| < GYRO_MAX_RAD_S and |acc| is within ACC_MAG_TOL of 1 g;
+// any moving sample throws away what was collected so far. The bias is the
+// mean gyro over TARGET_SAMPLES consecutive still samples.
+//
+// With a seed (bias saved by a previous boot) the seed is usable right away
+// and only SEED_CHECK_SAMPLES still samples are needed to confirm it; if the
+// short mean disagrees by more than SEED_TOL_RAD_S the seed is dropped and
+// the full window runs.
+//
+// No Arduino dependencies (host test: test/gyro_calibrator_test.cpp).
+class GyroCalibrator {
+ public:
+  static constexpr uint16_t TARGET_SAMPLES = 400;      // 1 s at 400 Hz (IMU_OUT_HZ)
+  static constexpr uint16_t SEED_CHECK_SAMPLES = 32;   // 80 ms at 400 Hz
+  static constexpr float SEED_TOL_RAD_S = 0.005f;      // ~0.3 deg/s per axis
+
+  static constexpr float G = 9.80665f;
+  static constexpr float GYRO_MAX_RAD_S = 0.15f;       // ~8.6 deg/s
+  static constexpr float ACC_MAG_TOL = 0.5f;           // m/s^2 around |g|
+
+  enum class Source : uint8_t { NONE, SEED, MEASURED };
+
+  // (Re)start; seed may be null
+  void start(const float seed[3] = nullptr);
+
+  // Returns true on the sample that finishes calibration
+  bool add(const float acc[3], const float gyr[3]);
+
+  bool done() const { return done_; }
+  bool has_bias() const { return source_ != Source::NONE; }   // seed counts
+  Source source() const { return source_; }
+  const float* bias() const { return bias_; }
+
+  bool still() const { return still_; }                // last sample
+  uint16_t still_count() const { return n_; }
+  uint16_t target() const { return target_; }
+  float progress() const { return done_ ? 1.0f : (float)n_ / (float)target_; }
+  uint32_t samples() const { return samples_; }
+  uint32_t motion_resets() const { return motion_resets_; }
+  bool seed_rejected() const { return seed_rejected_; }
+
+ private:
+  float sum_[3] = {0, 0, 0};
+  float bias_[3] = {0, 0, 0};
+  uint16_t n_ = 0;
+  uint16_t target_ = TARGET_SAMPLES;
+  uint32_t samples_ = 0;
+  uint32_t motion_resets_ = 0;
+  Source source_ = Source::NONE;
+  bool checking_seed_ = false;
+  bool seed_rejected_ = false;
+  bool still_ = false;
+  bool done_ = false;
+};
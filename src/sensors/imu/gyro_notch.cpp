@@ -0,0 +1,42 @@
+#include "gyro_notch.h"
+
+#include <math.h>
+
+void GyroNotchBank::set(const GyroPeaks& p)
+{
+  for (uint8_t a = 0; a < 3; a++) {
+    for (uint8_t k = 0; k < K; k++) {
+      const GyroPeak& pk = p.axis[a][k];
+      if (!pk.valid || pk.hz <= 0 || pk.hz >= 0.5f * fs_) {
+        on_[a][k] = false;
+        continue;
+      }
+      if (on_[a][k] && fabsf(pk.hz - hz_[a][k]) < RETUNE_HZ) continue;
+      if (!on_[a][k]) f_[a][k].reset();
+      f_[a][k].set(biquad_notch(pk.hz, Q, fs_));
+      hz_[a][k] = pk.hz;
+      on_[a][k] = true;
+      retunes_++;
+    }
+  }
+}
+
+void GyroNotchBank::apply(float g[3])
+{
+  for (uint8_t a = 0; a < 3; a++) {
+    float v = g[a];
+    for (uint8_t k = 0; k < K; k++) {
+      if (on_[a][k]) v = f_[a][k].step(v);
+    }
+    g[a] = v;
+  }
+}
+
+uint8_t GyroNotchBank::active_count() const
+{
+  uint8_t n = 0;
+  for (uint8_t a = 0; a < 3; a++) {
+    for (uint8_t k = 0; k < K; k++) n += on_[a][k] ? 1 : 0;
+  }
+  return n;
+}
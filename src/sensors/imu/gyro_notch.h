@@ -0,0 +1,36 @@
+#pragma once
+#include <stdint.h>
+
+#include "gyro_spectrum.h"
+#include "utils/filters.h"
+
+// Dynamic notch bank: GyroPeaks::K biquad notches per gyro axis, tuned to
+// what GyroSpectrum tracks. An invalid peak turns its notch off (pass
+// through); a valid one is retuned when it moved by more than RETUNE_HZ.
+// A notch that turns on starts from clear state.
+//
+// Runs in the fast loop on every decimated sample (K biquads per axis).
+// No Arduino dependencies (host test: test/gyro_spectrum_test.cpp).
+class GyroNotchBank {
+ public:
+  static constexpr uint8_t K = GyroPeaks::K;
+  static constexpr float Q = 4.0f;           // -3 dB width f0 / Q (~35 Hz at 140 Hz)
+  static constexpr float RETUNE_HZ = 0.5f;
+
+  explicit GyroNotchBank(float fs_hz) : fs_(fs_hz) {}
+
+  void set(const GyroPeaks& p);
+  void apply(float g[3]);
+
+  bool active(uint8_t axis, uint8_t k) const { return on_[axis][k]; }
+  float hz(uint8_t axis, uint8_t k) const { return hz_[axis][k]; }
+  uint8_t active_count() const;
+  uint32_t retunes() const { return retunes_; }
+
+ private:
+  float fs_;
+  Biquad f_[3][K];
+  float hz_[3][K] = {};
+  bool on_[3][K] = {};
+  uint32_t retunes_ = 0;
+};
@@ -0,0 +1,150 @@
+#include "gyro_spectrum.h"
+
+#include <math.h>
+
+void GyroSpectrum::reset()
+{
+  for (uint8_t a = 0; a < 3; a++) {
+    for (uint16_t i = 0; i < N; i++) hist_[a][i] = 0;
+    for (uint16_t k = 0; k < BINS; k++) p_[a][k] = 0;
+    for (uint8_t s = 0; s < K; s++) miss_[a][s] = 0;
+  }
+  pos_ = filled_ = since_ = 0;
+  peaks_ = GyroPeaks{};
+}
+
+bool GyroSpectrum::push(const float gyr[3])
+{
+  hist_[0][pos_] = gyr[0];
+  hist_[1][pos_] = gyr[1];
+  hist_[2][pos_] = gyr[2];
+  pos_ = (uint16_t)((pos_ + 1) & (N - 1));
+  if (filled_ < N) filled_++;
+  if (since_ < HOP) since_++;
+  return filled_ == N && since_ >= HOP;
+}
+
+void GyroSpectrum::process()
+{
+  if (filled_ < N) return;
+  since_ = 0;
+
+  for (uint8_t a = 0; a < 3; a++) {
+    // Oldest first (pos_ is the oldest slot once the ring is full)
+    for (uint16_t i = 0; i < N; i++) frame_[i] = hist_[a][(pos_ + i) & (N - 1)];
+    fft_.power(frame_, p_[a]);
+
+    Candidate c[K];
+    const uint8_t n = find_peaks_(p_[a], c);
+    track_(a, c, n);
+  }
+  peaks_.frame++;
+}
+
+// K strongest local maxima in the band that clear the noise floor,
+// strongest first
+uint8_t GyroSpectrum::find_peaks_(const float* p, Candidate out[K]) const
+{
+  const float bin = fs_ / N;
+  uint16_t k0 = (uint16_t)ceilf(MIN_HZ / bin);
+  uint16_t k1 = (uint16_t)floorf(MAX_HZ / bin);
+  if (k0 < 2) k0 = 2;
+  if (k1 > BINS - 2) k1 = BINS - 2;
+  if (k1 <= k0) return 0;
+
+  // Noise floor: median band power (one tone can't drag it up)
+  float sorted[BINS];
+  uint16_t m = 0;
+  for (uint16_t k = k0; k <= k1; k++) {
+    const float v = p[k];
+    uint16_t j = m++;
+    while (j > 0 && sorted[j - 1] > v) {
+      sorted[j] = sorted[j - 1];
+      j--;
+    }
+    sorted[j] = v;
+  }
+  const float floor_p = sorted[m / 2] > 1e-20f ? sorted[m / 2] : 1e-20f;
+  const float min_p = floor_p * powf(10.0f, MIN_SNR_DB * 0.1f);
+
+  uint16_t best[K];
+  uint8_t n = 0;
+  for (uint8_t s = 0; s < K; s++) {
+    uint16_t kb = 0;
+    float pb = min_p;
+    for (uint16_t k = k0; k <= k1; k++) {
+      if (p[k] < pb || p[k] < p[k - 1] || p[k] < p[k + 1]) continue;
+      bool taken = false;
+      for (uint8_t i = 0; i < n; i++) {
+        const int d = (int)k - (int)best[i];
+        if (d < GUARD_BINS && d > -GUARD_BINS) taken = true;
+      }
+      if (taken) continue;
+      kb = k;
+      pb = p[k];
+    }
+    if (!kb) break;
+    best[n] = kb;
+
+    // Gaussian interpolation (parabola through log power): Hann main lobe
+    // is close to Gaussian, so this is within a few % of a bin
+    const float la = logf(p[kb - 1] + 1e-30f), lb = logf(p[kb] + 1e-30f), lc = logf(p[kb + 1] + 1e-30f);
+    const float den = la - 2.0f * lb + lc;
+    float d = den < 0 ? 0.5f * (la - lc) / den : 0;
+    if (d > 0.5f) d = 0.5f;
+    if (d < -0.5f) d = -0.5f;
+    out[n].hz = (kb + d) * bin;
+    out[n].snr_db = 10.0f * log10f(p[kb] / floor_p);
+    n++;
+  }
+  return n;
+}
+
+void GyroSpectrum::track_(uint8_t axis, const Candidate* c, uint8_t n)
+{
+  GyroPeak* slot = peaks_.axis[axis];
+  bool used[K] = {};
+  bool hit[K] = {};
+
+  // Valid slots follow their nearest candidate
+  for (uint8_t s = 0; s < K; s++) {
+    if (!slot[s].valid) continue;
+    int bi = -1;
+    float bd = MATCH_HZ;
+    for (uint8_t i = 0; i < n; i++) {
+      const float d = fabsf(c[i].hz - slot[s].hz);
+      if (!used[i] && d < bd) {
+        bd = d;
+        bi = i;
+      }
+    }
+    if (bi < 0) continue;
+    used[bi] = true;
+    hit[s] = true;
+    slot[s].hz += SMOOTH * (c[bi].hz - slot[s].hz);
+    slot[s].snr_db = c[bi].snr_db;
+  }
+
+  // Free slots take what's left, strongest first (c is in that order)
+  for (uint8_t i = 0; i < n; i++) {
+    if (used[i]) continue;
+    for (uint8_t s = 0; s < K; s++) {
+      if (slot[s].valid) continue;
+      slot[s].hz = c[i].hz;
+      slot[s].snr_db = c[i].snr_db;
+      slot[s].valid = true;
+      hit[s] = true;
+      used[i] = true;
+      break;
+    }
+  }
+
+  for (uint8_t s = 0; s < K; s++) {
+    if (hit[s]) {
+      miss_[axis][s] = 0;
+    } else if (slot[s].valid && ++miss_[axis][s] >= HOLD_FRAMES) {
+      slot[s].valid = false;
+      miss_[axis][s] = 0;
+    }
+  }
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include <stdint.h>
+
+#include "utils/fft.h"
+
+// Gyro vibration analyzer: tracks the strongest motor/prop noise peaks per
+// axis so GyroNotchBank can follow them.
+//
+// The decimated gyro stream (rad/s, any frame) goes in one sample at a
+// time. Every HOP samples the last N samples of each axis are Hann
+// windowed and FFT'd; local maxima inside MIN_HZ..MAX_HZ that stand
+// MIN_SNR_DB above the band's median are peak candidates, and the K
+// strongest (GUARD_BINS apart) are refined to sub-bin frequency by a
+// parabola through the log power of the peak bin and its neighbours.
+//
+// Tracking: each slot follows the nearest candidate within MATCH_HZ
+// (EMA, SMOOTH); a free slot takes the strongest unclaimed candidate; a
+// slot that finds nothing for HOLD_FRAMES frames goes invalid.
+//
+// push() is cheap; process() (3 FFTs) is meant for a low-priority task.
+// No Arduino dependencies (host test: test/gyro_spectrum_test.cpp, cost:
+// test/gyro_spectrum_bench.cpp).
+
+struct GyroPeak {
+  float hz = 0;
+  float snr_db = 0;
+  bool valid = false;
+};
+
+struct GyroPeaks {
+  static constexpr uint8_t K = 2;   // tracked peaks per axis
+  GyroPeak axis[3][K];
+  uint32_t frame = 0;               // analyzer frame that produced this
+};
+
+class GyroSpectrum {
+ public:
+  static constexpr uint16_t N = 128;         // 3.125 Hz bins at 400 Hz
+  static constexpr uint16_t HOP = 32;        // a frame every 80 ms at 400 Hz
+  static constexpr uint16_t BINS = RealFft<N>::BINS;
+  static constexpr uint8_t K = GyroPeaks::K;
+
+  static constexpr float MIN_HZ = 60.0f;     // below: airframe/control motion
+  static constexpr float MAX_HZ = 190.0f;    // up to just under Nyquist (200 Hz)
+  static constexpr float MIN_SNR_DB = 12.0f;
+  static constexpr uint8_t GUARD_BINS = 3;   // min spacing of two peaks on one axis
+  static constexpr float MATCH_HZ = 20.0f;
+  static constexpr float SMOOTH = 0.5f;      // weight of the new estimate
+  static constexpr uint8_t HOLD_FRAMES = 4;
+
+  explicit GyroSpectrum(float fs_hz) : fs_(fs_hz) {}
+
+  void reset();
+
+  // Returns true when a frame is due (call process() before the next HOP
+  // samples or frames are skipped)
+  bool push(const float gyr[3]);
+
+  void process();
+
+  const GyroPeaks& peaks() const { return peaks_; }
+  uint32_t frames() const { return peaks_.frame; }
+  float bin_hz() const { return fs_ / N; }
+
+  // Last frame's power spectrum of one axis (debug, tests)
+  const float* power(uint8_t axis) const { return p_[axis]; }
+
+ private:
+  struct Candidate {
+    float hz;
+    float snr_db;
+  };
+
+  uint8_t find_peaks_(const float* p, Candidate out[K]) const;
+  void track_(uint8_t axis, const Candidate* c, uint8_t n);
+
+  float fs_;
+  float hist_[3][N] = {};
+  uint16_t pos_ = 0;        // next write
+  uint16_t filled_ = 0;     // up to N
+  uint16_t since_ = 0;      // samples since the last frame
+
+  RealFft<N> fft_;
+  float frame_[N];
+  float p_[3][BINS] = {};
+
+  GyroPeaks peaks_;
+  uint8_t miss_[3][K] = {};
+};
@@ -0,0 +1,129 @@
+#include "gyro_temp_bias.h"
+
+#include <math.h>
+
+void GyroTempBias::reset()
+{
+  *this = GyroTempBias{};
+}
+
+void GyroTempBias::seed(const float bias[3], float temp_c)
+{
+  add_observation(bias, temp_c, BIN_MAX_N);
+}
+
+bool GyroTempBias::add(const float acc[3], const float gyr[3], float temp_c)
+{
+  float b[3] = {0, 0, 0};
+  if (ready()) bias(temp_c, b);
+  const float dx = gyr[0] - b[0], dy = gyr[1] - b[1], dz = gyr[2] - b[2];
+  const float gmax = ready() ? GYRO_MAX_RAD_S : GYRO_MAX_UNSEEDED;
+  const float amag = sqrtf(acc[0] * acc[0] + acc[1] * acc[1] + acc[2] * acc[2]);
+
+  const bool still = (dx * dx + dy * dy + dz * dz < gmax * gmax) && (fabsf(amag - G) < ACC_MAG_TOL);
+  if (!still) {
+    if (win_n_ > 0) rejected_++;
+    win_n_ = 0;
+    return false;
+  }
+
+  const float x[6] = { gyr[0], gyr[1], gyr[2], acc[0], acc[1], acc[2] };
+  if (win_n_ == 0) {
+    for (int k = 0; k < 6; k++) {
+      win_ref_[k] = x[k];
+      win_sum_[k] = 0;
+      win_sq_[k] = 0;
+    }
+    win_t_ = 0;
+  }
+  for (int k = 0; k < 6; k++) {
+    const float d = x[k] - win_ref_[k];
+    win_sum_[k] += d;
+    win_sq_[k] += d * d;
+  }
+  win_t_ += temp_c;
+  if (++win_n_ < WINDOW) return false;
+  win_n_ = 0;
+
+  // Quiet enough? (motors running fail this even when each sample is close)
+  for (int k = 0; k < 6; k++) {
+    const float m = win_sum_[k] / WINDOW;
+    const float var = win_sq_[k] / WINDOW - m * m;
+    const float lim = k < 3 ? GYRO_STD_MAX : ACC_STD_MAX;
+    if (var > lim * lim) {
+      rejected_++;
+      return false;
+    }
+  }
+
+  float mean[3];
+  for (int k = 0; k < 3; k++) mean[k] = win_ref_[k] + win_sum_[k] / WINDOW;
+  const float t = win_t_ / WINDOW;
+  return add_observation(mean, t);
+}
+
+bool GyroTempBias::add_observation(const float bias[3], float temp_c, uint16_t weight)
+{
+  int i = (int)floorf((temp_c - T_MIN_C) / BIN_C);
+  if (i < 0 || i >= NBINS || weight == 0) return false;
+
+  Bin &bin = bins_[i];
+  if (bin.n == 0) bins_used_++;
+  for (uint16_t k = 0; k < weight; k++) {
+    if (bin.n < BIN_MAX_N) bin.n++;
+    const float a = 1.0f / bin.n;
+    bin.t += (temp_c - bin.t) * a;
+    bin.b[0] += (bias[0] - bin.b[0]) * a;
+    bin.b[1] += (bias[1] - bin.b[1]) * a;
+    bin.b[2] += (bias[2] - bin.b[2]) * a;
+  }
+  observations_++;
+  fit_();
+  return true;
+}
+
+// Weighted least squares over the bins (weight = bin count)
+void GyroTempBias::fit_()
+{
+  float w = 0, wt = 0, wb[3] = {0, 0, 0};
+  t_lo_ = 1e9f;
+  t_hi_ = -1e9f;
+  for (int i = 0; i < NBINS; i++) {
+    const Bin &bin = bins_[i];
+    if (!bin.n) continue;
+    w += bin.n;
+    wt += bin.n * bin.t;
+    for (int k = 0; k < 3; k++) wb[k] += bin.n * bin.b[k];
+    if (bin.t < t_lo_) t_lo_ = bin.t;
+    if (bin.t > t_hi_) t_hi_ = bin.t;
+  }
+  if (w <= 0) return;
+
+  t_ref_ = wt / w;
+  for (int k = 0; k < 3; k++) offset_[k] = wb[k] / w;
+
+  sloped_ = (t_hi_ - t_lo_) >= MIN_SPAN_C;
+  if (!sloped_) {
+    slope_[0] = slope_[1] = slope_[2] = 0;
+    return;
+  }
+
+  float stt = 0, stb[3] = {0, 0, 0};
+  for (int i = 0; i < NBINS; i++) {
+    const Bin &bin = bins_[i];
+    if (!bin.n) continue;
+    const float dt = bin.t - t_ref_;
+    stt += bin.n * dt * dt;
+    for (int k = 0; k < 3; k++) stb[k] += bin.n * dt * (bin.b[k] - offset_[k]);
+  }
+  for (int k = 0; k < 3; k++) slope_[k] = stb[k] / stt;
+}
+
+void GyroTempBias::bias(float temp_c, float out[3]) const
+{
+  float t = temp_c;
+  if (t < t_lo_ - EXTRAP_C) t = t_lo_ - EXTRAP_C;
+  if (t > t_hi_ + EXTRAP_C) t = t_hi_ + EXTRAP_C;
+  const float dt = t - t_ref_;
+  for (int k = 0; k < 3; k++) out[k] = offset_[k] + slope_[k] * dt;
+}
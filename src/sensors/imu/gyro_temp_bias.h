@@ -0,0 +1,104 @@
+#pragma once
+#include <stdint.h>
+
+// Online gyro bias vs temperature model.
+//
+// The boot calibration (GyroCalibrator) gives one bias at one temperature;
+// the board then warms up under motor current and the bias walks off. This
+// keeps learning while the drone runs: whenever the IMU is still for a
+// whole WINDOW (on the ground between flights, parked) the window's mean
+// gyro and temperature become one observation.
+//
+// Still means two things. Every sample must be close to the model bias
+// and 1 g, and the whole window must be quiet: the per-axis standard
+// deviation of gyro and accel stays near sensor noise. A slow, steady turn
+// passes the first test. In flight it never passes the second, because
+// motor vibration is orders of magnitude above the noise floor. So a calm
+// hover with a slow yaw is not learned as bias.
+//
+// Observations go into 1 °C bins (running mean per bin, so a bin at a
+// temperature seen for a long time doesn't outvote the others and slow
+// drift at a fixed temperature is still followed). The model is a weighted
+// line per axis through the bins:
+//   bias(T) = offset + slope * (T - t_ref)
+// Until the bins span MIN_SPAN_C the slope is held at 0 (offset only), and
+// T is clamped to the seen range +- EXTRAP_C so a short span can't
+// extrapolate wildly.
+//
+// No Arduino dependencies (host test: test/gyro_temp_bias_test.cpp).
+class GyroTempBias {
+ public:
+  static constexpr float T_MIN_C = -10.0f;   // bin 0 lower edge
+  static constexpr float BIN_C = 1.0f;
+  static constexpr uint8_t NBINS = 80;       // -10 .. 70 °C
+
+  static constexpr uint16_t WINDOW = 100;    // still samples per observation (250 ms at 400 Hz)
+  static constexpr uint16_t BIN_MAX_N = 16;  // bin mean becomes an EMA after this many
+  static constexpr float MIN_SPAN_C = 3.0f;
+  static constexpr float EXTRAP_C = 5.0f;
+
+  // Stillness: |gyro - model bias| and |acc| vs 1 g. Tighter than the boot
+  // calibration since the bias is already roughly known.
+  static constexpr float G = 9.80665f;
+  static constexpr float GYRO_MAX_RAD_S = 0.05f;  // ~2.9 deg/s
+  static constexpr float ACC_MAG_TOL = 0.3f;      // m/s^2
+  static constexpr float GYRO_MAX_UNSEEDED = 0.15f;
+  // Window quietness (per axis std): a few times BMI270 noise at 400 Hz,
+  // far below any spinning prop
+  static constexpr float GYRO_STD_MAX = 0.01f;    // rad/s
+  static constexpr float ACC_STD_MAX = 0.1f;      // m/s^2
+
+  void reset();
+
+  // Boot calibration result: counts as a full bin at temp_c
+  void seed(const float bias[3], float temp_c);
+
+  // One IMU sample (sensor frame, SI, no bias removed) at temp_c.
+  // Returns true when the model changed.
+  bool add(const float acc[3], const float gyr[3], float temp_c);
+
+  // One still-window result; weight = how many observations it counts as
+  bool add_observation(const float bias[3], float temp_c, uint16_t weight = 1);
+
+  void bias(float temp_c, float out[3]) const;
+
+  bool ready() const { return bins_used_ > 0; }
+  bool sloped() const { return sloped_; }
+  float slope(int axis) const { return slope_[axis]; }     // rad/s per °C
+  float offset(int axis) const { return offset_[axis]; }   // rad/s at t_ref()
+  float t_ref() const { return t_ref_; }
+  float t_lo() const { return t_lo_; }
+  float t_hi() const { return t_hi_; }
+  uint8_t bins_used() const { return bins_used_; }
+  uint32_t observations() const { return observations_; }
+  uint32_t windows_rejected() const { return rejected_; }   // motion or vibration inside a window
+
+ private:
+  struct Bin {
+    uint16_t n;
+    float t;      // mean temperature
+    float b[3];   // mean bias
+  };
+
+  void fit_();
+
+  Bin bins_[NBINS] = {};
+  uint8_t bins_used_ = 0;
+
+  // Current still window: sums of gyr/acc minus the window's first sample
+  // (keeps the variance out of float cancellation)
+  float win_ref_[6] = {0, 0, 0, 0, 0, 0};
+  float win_sum_[6] = {0, 0, 0, 0, 0, 0};
+  float win_sq_[6] = {0, 0, 0, 0, 0, 0};
+  float win_t_ = 0;
+  uint16_t win_n_ = 0;
+
+  // Model
+  float offset_[3] = {0, 0, 0};
+  float slope_[3] = {0, 0, 0};
+  float t_ref_ = 0, t_lo_ = 0, t_hi_ = 0;
+  bool sloped_ = false;
+
+  uint32_t observations_ = 0;
+  uint32_t rejected_ = 0;
+};
@@ -1,100 +1,102 @@
 #include "imu_bmi270.h"
 #include "config/spi_config.h"
+#include "config/pins.h"
 #include <Arduino.h>
 #include <SPI.h>
+#if IMU_GYRO_NVS
+#include <Preferences.h>
+#endif
 
 #include "bmi270_bosch_glue.h"
+#include "bmi270_convert.h"
 
 static bmi2_dev g_dev;
 static Bmi270SpiIntf g_intf;
 
-// --- Helper functions --- //
-static bool read_raw_sample(float &ax, float &ay, float &az,
-                            float &gx, float &gy, float &gz)
-{
-  bmi2_sens_data data = {0};
-  int8_t rslt = bmi2_get_sensor_data(&data, &g_dev);
-  if (rslt != BMI2_OK) return false;
+// INT1 edge capture (written by the ISR only)
+static volatile uint32_t g_int1_us = 0;
+static volatile uint32_t g_int1_edges = 0;
+static ImuBmi270::DataReadyFn g_drdy_fn = nullptr;
 
-  // Convert raw -> SI using your configured ranges
-  constexpr float INV_32768 = 1.0f / 32768.0f;
-  constexpr float DEG2RAD = 3.14159265358979323846f / 180.0f;
-  constexpr float G = 9.80665f;
+static void IRAM_ATTR int1_isr()
+{
+  const uint32_t t = micros();
+  g_int1_us = t;
+  g_int1_edges = g_int1_edges + 1;
+  if (g_drdy_fn) g_drdy_fn(t);
+}
 
-  constexpr float ACC_RANGE_G = 4.0f;        // match your config
-  constexpr float GYR_RANGE_DPS = 2000.0f;   // match your config
+// --- Helper functions --- //
 
-  ax = (data.acc.x * INV_32768) * (ACC_RANGE_G * G);
-  ay = (data.acc.y * INV_32768) * (ACC_RANGE_G * G);
-  az = (data.acc.z * INV_32768) * (ACC_RANGE_G * G);
+// From the same IMU_CFG begin() configures the sensor with
+static constexpr Bmi270Scale IMU_SCALE = IMU_CFG.scale();
 
-  gx = (data.gyr.x * INV_32768) * (GYR_RANGE_DPS * DEG2RAD);
-  gy = (data.gyr.y * INV_32768) * (GYR_RANGE_DPS * DEG2RAD);
-  gz = (data.gyr.z * INV_32768) * (GYR_RANGE_DPS * DEG2RAD);
+// Hot path: one 12-byte burst of the data registers (plus the SPI dummy
+// byte), no bmi2_get_sensor_data. Counts in the sensor frame.
+static uint8_t g_regs[1 + BMI270_DATA_BYTES];
 
+// False when the transfer failed or the bytes are a stuck bus
+static bool read_data_regs(int16_t acc[3], int16_t gyr[3])
+{
+  if (!g_intf.spi.read_reg(BMI270_DATA_REG | 0x80, g_regs, sizeof(g_regs))) return false;
+  if (bmi270_regs_stuck(g_regs + 1)) return false;
+  bmi270_unpack_regs(g_regs + 1, g_dev.gyr_cross_sens_zx, acc, gyr);
   return true;
 }
 
-bool ImuBmi270::calibrate_gyro()
+static bool read_temp_c(float &t)
 {
-  // Keep drone still during this
-  constexpr int N = 500;               // target samples (~2s at 250 Hz)
-  constexpr int MIN_OK = 350;          // require enough "still" samples
-  constexpr float G = 9.80665f;
-
-  // Gating thresholds
-  constexpr float GYRO_MAX_RAD_S = 0.15f;     // ~8.6 deg/s
-  constexpr float ACC_MAG_TOL = 0.5f;         // m/s^2 tolerance around |g|
-
-  float bgx = 0, bgy = 0, bgz = 0;
-  int n_ok = 0;
-
-  for (int i = 0; i < N; i++) {
-    float ax, ay, az, gx, gy, gz;
-    if (read_raw_sample(ax, ay, az, gx, gy, gz)) {
-
-      const float gmag = sqrtf(gx*gx + gy*gy + gz*gz);
-      const float amag = sqrtf(ax*ax + ay*ay + az*az);
-
-      const bool still_gyro = (gmag < GYRO_MAX_RAD_S);
-      const bool still_acc  = (fabsf(amag - G) < ACC_MAG_TOL);
+  uint8_t regs[3];   // dummy byte + TEMPERATURE_0/1
+  if (!g_intf.spi.read_reg(BMI270_TEMP_REG | 0x80, regs, sizeof(regs))) return false;
+  return bmi270_temp_c(regs + 1, t);
+}
 
-      if (still_gyro && still_acc) {
-        bgx += gx; bgy += gy; bgz += gz;
-        n_ok++;
-      }
-    }
-    delay(4); // ~250 Hz pacing
-  }
+#if IMU_GYRO_NVS
+// Gyro bias from the last full calibration, seeds the next boot
+static constexpr char NVS_NS[] = "imu";
+static constexpr char NVS_KEY_BIAS[] = "gyr_bias";
+static constexpr uint32_t NVS_BIAS_MAGIC = 0x47425331;   // "GBS1"
 
-  if (n_ok >= MIN_OK) {
-    _gyro_bias_x = bgx / n_ok;
-    _gyro_bias_y = bgy / n_ok;
-    _gyro_bias_z = bgz / n_ok;
+struct NvsGyroBias {
+  uint32_t magic;
+  float b[3];
+};
 
-    Serial.printf("[imu] gyro bias rad/s: %.6f %.6f %.6f (n=%d/%d)\n",
-                  _gyro_bias_x, _gyro_bias_y, _gyro_bias_z, n_ok, N);
-    return true;
-  }
+static bool nvs_load_bias(float b[3])
+{
+  Preferences prefs;
+  if (!prefs.begin(NVS_NS, true)) return false;
+  NvsGyroBias v = {};
+  const bool ok = prefs.getBytes(NVS_KEY_BIAS, &v, sizeof(v)) == sizeof(v) && v.magic == NVS_BIAS_MAGIC;
+  prefs.end();
+  if (!ok) return false;
+  for (int i = 0; i < 3; i++) b[i] = v.b[i];
+  return true;
+}
 
-  Serial.printf("[imu] gyro bias calibration rejected: n_ok=%d/%d (keep old bias)\n", n_ok, N);
-  return false;
+static bool nvs_save_bias(const float b[3])
+{
+  Preferences prefs;
+  if (!prefs.begin(NVS_NS, false)) return false;
+  NvsGyroBias v = { NVS_BIAS_MAGIC, { b[0], b[1], b[2] } };
+  const bool ok = prefs.putBytes(NVS_KEY_BIAS, &v, sizeof(v)) == sizeof(v);
+  prefs.end();
+  return ok;
 }
+#endif
 
 static inline void mapSensorToFRU(ImuSample &s)
 {
-  const float sx  = s.ax,  sy  = s.ay,  sz  = s.az;
-  const float sgx = s.gx,  sgy = s.gy,  sgz = s.gz;
-
-  // Body FRU mapping you derived:
-  // body_x = sensor_y, body_y = sensor_x, body_z = sensor_z
-  s.ax = sy;
-  s.ay = sx;
-  s.az = sz;
-
-  s.gx = sgy;
-  s.gy = sgx;
-  s.gz = sgz;
+  const float a[3] = { s.ax, s.ay, s.az };
+  const float g[3] = { s.gx, s.gy, s.gz };
+  float ab[3], gb[3];
+
+  // Body FRU mapping from IMU_CFG.body (sensor y, x, z)
+  bmi270_to_body(IMU_CFG, a, ab);
+  bmi270_to_body(IMU_CFG, g, gb);
+
+  s.ax = ab[0]; s.ay = ab[1]; s.az = ab[2];
+  s.gx = gb[0]; s.gy = gb[1]; s.gz = gb[2];
 }
 
 // --- Core functions --- //
@@ -106,8 +108,10 @@ bool ImuBmi270::begin()
   // (so we don't call SPI.begin() here unless you want to make it standalone)
   // 
 
-  g_intf.cs_pin = PIN_CS_BMI270;
-  g_intf.settings = SPI_BMI270_SETTINGS;
+  if (!g_intf.spi.begin(PIN_CS_BMI270, SPI_BMI270_HZ, SPI_BMI270_MODE)) {
+    _ok = false;
+    return false;
+  }
 
   memset(&g_dev, 0, sizeof(g_dev));
   g_dev.intf = BMI2_SPI_INTF;
@@ -119,7 +123,16 @@ bool ImuBmi270::begin()
   // REQUIRED for BMI270 over SPI
   g_dev.dummy_byte = 1;
 
+  // Config blob upload chunk. Default (0 -> 2) is ~4k tiny SPI writes; even
+  // and < BMI2_MAX_LEN since the same length is used for feature-page reads.
+  g_dev.read_write_len = 126;
+
+  const uint32_t t_init = micros();
   int8_t rslt = bmi270_init(&g_dev);
+  Serial.printf("[imu] bmi270_init: %lu us (%lu SPI transfers, %lu bytes)\n",
+                (unsigned long)(micros() - t_init),
+                (unsigned long)g_intf.spi.stats().transfers,
+                (unsigned long)g_intf.spi.stats().bytes);
   if (rslt != BMI2_OK) {
     //Serial.printf("[imu] bmi270_init failed: %d\n", rslt);
     _ok = false;
@@ -146,16 +159,8 @@ bool ImuBmi270::begin()
     return false;
   }
 
-  cfg[0].cfg.acc.odr = BMI2_ACC_ODR_400HZ;
-  cfg[0].cfg.acc.range = BMI2_ACC_RANGE_4G;
-  cfg[0].cfg.acc.bwp = BMI2_ACC_NORMAL_AVG4;
-  cfg[0].cfg.acc.filter_perf = BMI2_PERF_OPT_MODE;
-
-  cfg[1].cfg.gyr.odr = BMI2_GYR_ODR_400HZ;
-  cfg[1].cfg.gyr.range = BMI2_GYR_RANGE_2000;
-  cfg[1].cfg.gyr.bwp = BMI2_GYR_NORMAL_MODE;
-  cfg[1].cfg.gyr.noise_perf = BMI2_PERF_OPT_MODE;
-  cfg[1].cfg.gyr.filter_perf = BMI2_PERF_OPT_MODE;
+  // Ranges/ODR/filters from IMU_CFG (config/imu_config.h)
+  bmi270_fill_config(IMU_CFG, cfg[0], cfg[1]);
 
   rslt = bmi2_set_sensor_config(cfg, 2, &g_dev);
   if (rslt != BMI2_OK) {
@@ -181,53 +186,148 @@ bool ImuBmi270::begin()
 
   delay(10);   // allow sensors to exit suspend and settle
 
-  // Calibrate BMI270 gyro
-  calibrate_gyro();
-  
+#if SPI_BENCH
+  // Reads FIFO_DATA: empty until the FIFO is configured below, so harmless
+  spi_bus_bench(g_intf.spi, BMI2_FIFO_DATA_ADDR | 0x80);
+#endif
+
+  // Gyro bias: collected from the fast loop's own samples (see to_si), so
+  // begin() doesn't wait for it. A bias saved by an earlier boot is used
+  // straight away and confirmed within a few tens of ms of stillness.
+  _temp_ok = read_temp_c(_temp_c);
+
+  float seed[3];
+  bool seeded = false;
+#if IMU_GYRO_NVS
+  seeded = nvs_load_bias(seed);
+#endif
+  _cal.start(seeded ? seed : nullptr);
+  if (seeded) publish_bias();
+  Serial.printf("[imu] gyro bias: %s\n", seeded ? "seeded from NVS, confirming" : "calibrating (keep still)");
+
+#if IMU_FIFO
+  // Flushes the FIFO so the first batch only holds fresh frames.
+  rslt = _fifo.configure(g_dev);
+  _fifo_ok = (rslt == BMI2_OK);
+  if (!_fifo_ok) {
+    Serial.printf("[imu] FIFO config failed: %d (falling back to register reads)\n", rslt);
+  }
+
+  // INT1 = FIFO watermark: the sensor's ODR paces the fast loop
+  if (_fifo_ok && PIN_IMU_INT1 >= 0) {
+    rslt = _fifo.enable_int1(g_dev, INT1_WM_FRAMES);
+    if (rslt == BMI2_OK) {
+      pinMode(PIN_IMU_INT1, INPUT);
+      attachInterrupt(digitalPinToInterrupt(PIN_IMU_INT1), int1_isr, RISING);
+      _irq_ok = true;
+    } else {
+      Serial.printf("[imu] INT1 config failed: %d (polling)\n", rslt);
+    }
+  }
+#endif
+
   _ok = true;
   //Serial.println("[imu] BMI270 initialized (Bosch driver)");
   return true;
   
 }
 
-bool ImuBmi270::read(ImuSample &out)
+// Raw counts -> SI, gyro bias removed (sensor frame). Feeds the gyro
+// calibrator until it has converged.
+void ImuBmi270::to_si(const int16_t acc[3], const int16_t gyr[3], ImuSample &out)
 {
-  // --- scaling constants matching your config ---
-  constexpr float G = 9.80665f;
-  constexpr float ACC_RANGE_G = 4.0f;        // ±4g
-  constexpr float GYR_RANGE_DPS = 2000.0f;   // ±2000 dps
-  constexpr float INV_32768 = 1.0f / 32768.0f;
-  constexpr float DEG2RAD = 3.14159265358979323846f / 180.0f;
+  float a[3], g[3];
+  bmi270_raw_to_si(acc, gyr, IMU_SCALE, a, g);
+
+  if (!_cal.done()) {
+    if (_cal.add(a, g)) {
+#if IMU_GYRO_TCOMP
+      if (_temp_ok) _tbias.seed(_cal.bias(), _temp_c);
+#endif
+      publish_bias();
+      _bias_save_pending = (_cal.source() == GyroCalibrator::Source::MEASURED);
+    }
+  }
+#if IMU_GYRO_TCOMP
+  else if (_temp_ok && _tbias.add(a, g, _temp_c)) {
+    publish_bias();
+  }
+#endif
+
+  out.ax = a[0];
+  out.ay = a[1];
+  out.az = a[2];
 
+  out.gx = g[0] - _gyro_bias_x;
+  out.gy = g[1] - _gyro_bias_y;
+  out.gz = g[2] - _gyro_bias_z;
+}
+
+bool ImuBmi270::read(ImuSample &out)
+{
   if (!_ok) {
     out.valid = false;
     return false;
   }
 
-  bmi2_sens_data data = {0};
-  int8_t rslt = bmi2_get_sensor_data(&data, &g_dev);
-  if (rslt != BMI2_OK) {
+  int16_t acc[3], gyr[3];
+  if (!read_data_regs(acc, gyr)) {
+    _read_errors++;
     out.valid = false;
     return false;
   }
-
-  out.ax = (data.acc.x * INV_32768) * (ACC_RANGE_G * G);
-  out.ay = (data.acc.y * INV_32768) * (ACC_RANGE_G * G);
-  out.az = (data.acc.z * INV_32768) * (ACC_RANGE_G * G);
-  
-  out.gx = (data.gyr.x * INV_32768) * (GYR_RANGE_DPS * DEG2RAD);
-  out.gy = (data.gyr.y * INV_32768) * (GYR_RANGE_DPS * DEG2RAD);
-  out.gz = (data.gyr.z * INV_32768) * (GYR_RANGE_DPS * DEG2RAD);
-
-  out.gx -= _gyro_bias_x;
-  out.gy -= _gyro_bias_y;
-  out.gz -= _gyro_bias_z;
+  to_si(acc, gyr, out);
 
   out.t_us = micros();
   out.valid = true;
   return true;
 }
 
+// Bias in use: temperature model once it has data, else the calibrator's
+void ImuBmi270::publish_bias()
+{
+  float b[3] = { _cal.bias()[0], _cal.bias()[1], _cal.bias()[2] };
+#if IMU_GYRO_TCOMP
+  if (_cal.done() && _temp_ok && _tbias.ready()) _tbias.bias(_temp_c, b);
+#endif
+  _gyro_bias_x = b[0];
+  _gyro_bias_y = b[1];
+  _gyro_bias_z = b[2];
+}
+
+// Temperature moves slowly: one 2-byte read every TEMP_EVERY_READS batches
+void ImuBmi270::update_temp()
+{
+  if (++_temp_div < TEMP_EVERY_READS) return;
+  _temp_div = 0;
+
+  float t;
+  if (!read_temp_c(t)) return;
+  _temp_c = t;
+  _temp_ok = true;
+
+#if IMU_GYRO_TCOMP
+  if (!_cal.done()) return;
+  // Calibration finished before the first valid reading
+  if (!_tbias.ready() && _cal.has_bias()) _tbias.seed(_cal.bias(), _temp_c);
+  publish_bias();
+#endif
+}
+
+// Slow-path work the fast loop must not do (NVS writes take milliseconds)
+void ImuBmi270::service()
+{
+  if (!_bias_save_pending) return;
+  _bias_save_pending = false;
+
+  Serial.printf("[imu] gyro bias rad/s: %.6f %.6f %.6f (n=%u, %lu samples, %lu motion resets)\n",
+                _gyro_bias_x, _gyro_bias_y, _gyro_bias_z, (unsigned)_cal.still_count(),
+                (unsigned long)_cal.samples(), (unsigned long)_cal.motion_resets());
+#if IMU_GYRO_NVS
+  if (!nvs_save_bias(_cal.bias())) Serial.println("[imu] gyro bias NVS save failed");
+#endif
+}
+
 // Returns IMU BMI270 readings in the Forward-Right-Up frame
 bool ImuBmi270::readFRU(ImuSample &out)
 {
@@ -236,5 +336,97 @@ bool ImuBmi270::readFRU(ImuSample &out)
   return true;
 }
 
+void ImuBmi270::onDataReady(DataReadyFn fn)
+{
+  g_drdy_fn = fn;
+}
+
+// Drains the FIFO. Each sample is stamped with when the sensor produced it:
+// the sensortime frame gives the sensor clock at the read, so a frame that is
+// k sensortime ticks older than that happened k * 39.0625 us before micros().
+// After an INT1 edge the anchor is the edge itself (frame INT1_WM_FRAMES-1
+// of a fully drained batch is the one that crossed the watermark), which
+// takes the wake-up and SPI time out of the stamps.
+bool ImuBmi270::readBatchFRU(ImuBatch &out)
+{
+  out.count = 0;
+  out.skipped = 0;
+  out.backlog = false;
+
+  if (!_ok) return false;
+
+  update_temp();
+
+  // Edge bookkeeping before the SPI read so a new edge during it counts next time
+  const uint32_t edges = g_int1_edges;
+  const uint32_t edge_us = g_int1_us;
+  const bool fresh_edge = _irq_ok && (edges != _last_edge);
+  if (_irq_ok) {
+    _irq.edges = edges;
+    if (fresh_edge) {
+      const uint32_t lat = micros() - edge_us;
+      _irq.irq_reads++;
+      _irq.sum_lat_us += lat;
+      _irq.last_lat_us = lat;
+      if (lat > _irq.max_lat_us) _irq.max_lat_us = lat;
+    } else {
+      _irq.polled_reads++;
+    }
+    _last_edge = edges;
+  }
+
+  if (!_fifo_ok) {
+    if (!readFRU(out.s[0])) return false;
+    out.count = 1;
+    return true;
+  }
 
+  int8_t rslt = _fifo.read(g_dev, _raw);
+  const uint32_t t_read_us = micros();
+  if (rslt == BMI2_W_FIFO_EMPTY) return true;
+  if (rslt != BMI2_OK) return false;
+
+  constexpr uint32_t PERIOD_US = IMU_CFG.period_us();   // FIFO frame period
+
+  out.skipped = _raw.skipped;
+  out.backlog = !_raw.has_sensor_time;
+
+  // Anchor: (time, sensortime) pair everything else is measured from
+  uint32_t anchor_us = t_read_us;
+  uint32_t anchor_st = _raw.sensor_time;
+  if (fresh_edge && _raw.has_sensor_time && _raw.count >= INT1_WM_FRAMES) {
+    anchor_us = edge_us;
+    anchor_st = _raw.f[INT1_WM_FRAMES - 1].sensor_time;
+  }
 
+  // Decimator output stamp: the emitting frame's time minus the filter's
+  // group delay, i.e. when the sensor saw what the sample describes
+  constexpr uint32_t DECIM_DELAY_US = (ImuDecimator::DELAY_X2 * PERIOD_US) / 2;
+
+  for (uint16_t i = 0; i < _raw.count; i++) {
+    const Bmi270FifoFrame &f = _raw.f[i];
+
+    // acc xyz + gyr xyz through the decimator; most frames only feed it
+    const int16_t in[6] = { f.acc[0], f.acc[1], f.acc[2], f.gyr[0], f.gyr[1], f.gyr[2] };
+    int16_t dec[6];
+    if (!_decim.push(in, dec)) continue;
+
+    ImuSample &s = out.s[out.count++];
+    to_si(dec, dec + 3, s);
+
+    uint32_t t_us;
+    if (_raw.has_sensor_time) {
+      // Signed: frames after the anchor frame are newer than anchor_us
+      int32_t ticks = (int32_t)((anchor_st - f.sensor_time) & 0xFFFFFF);
+      if (ticks >= 0x800000) ticks -= 0x1000000;
+      const int32_t age_us = (int32_t)(((int64_t)ticks * 625) / 16);   // 39.0625 us/tick
+      t_us = anchor_us - (uint32_t)age_us;
+    } else {
+      t_us = t_read_us - (uint32_t)(_raw.count - 1 - i) * PERIOD_US;
+    }
+    s.t_us = t_us - DECIM_DELAY_US;
+    s.valid = true;
+    mapSensorToFRU(s);
+  }
+  return true;
+}
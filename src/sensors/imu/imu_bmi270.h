@@ -1,6 +1,29 @@
 #pragma once
 #include <Arduino.h>
 
+// IMU_FIFO=1: the fast loop drains the BMI270 FIFO every tick (every sample
+// the sensor produced, sensor-time stamped). 0: one register read per tick.
+#ifndef IMU_FIFO
+#define IMU_FIFO 1
+#endif
+
+// IMU_GYRO_NVS=1: save the converged gyro bias to NVS and seed the next
+// boot's calibration with it.
+#ifndef IMU_GYRO_NVS
+#define IMU_GYRO_NVS 1
+#endif
+
+// IMU_GYRO_TCOMP=1: after the boot calibration, keep learning gyro bias vs
+// the BMI270 temperature whenever the IMU is still (GyroTempBias).
+#ifndef IMU_GYRO_TCOMP
+#define IMU_GYRO_TCOMP 1
+#endif
+
+#include "bmi270_fifo.h"
+#include "gyro_calibrator.h"
+#include "gyro_temp_bias.h"
+#include "config/imu_config.h"
+
 struct ImuSample {
   float ax, ay, az;  // m/s^2 (or g if you prefer; we’ll document once confirmed)
   float gx, gy, gz;  // rad/s (or dps)
@@ -8,16 +31,87 @@ struct ImuSample {
   bool valid;
 };
 
+// All samples produced since the previous read, oldest first, FRU frame,
+// after decimation (IMU_OUT_HZ).
+struct ImuBatch {
+  static constexpr uint16_t MAX_SAMPLES = (Bmi270FifoBatch::MAX_FRAMES + IMU_DECIM - 1) / IMU_DECIM;
+
+  ImuSample s[MAX_SAMPLES];
+  uint16_t count = 0;
+  uint8_t skipped = 0;     // frames the sensor dropped (FIFO overflow)
+  bool backlog = false;    // FIFO held more than one batch; rest comes next read
+};
+
+// INT1 accounting, updated by readBatchFRU()
+struct ImuIrqStats {
+  uint32_t edges = 0;          // INT1 edges seen by the ISR
+  uint32_t irq_reads = 0;      // reads that followed a fresh edge
+  uint32_t polled_reads = 0;   // reads with no edge since the previous one
+  uint32_t max_lat_us = 0;     // edge -> read start
+  uint32_t last_lat_us = 0;
+  uint64_t sum_lat_us = 0;
+
+  uint32_t avg_lat_us() const { return irq_reads ? (uint32_t)(sum_lat_us / irq_reads) : 0; }
+};
+
 class ImuBmi270 {
 public:
+  // Called from the INT1 ISR with the edge time (keep it short, IRAM).
+  using DataReadyFn = void (*)(uint32_t t_us);
+
+  // One edge per 4 frames (FAST_HZ = ODR / 4): one decimated 400 Hz sample
+  // per fast tick, so the rate loop sees each sample as soon as it exists
+  static constexpr uint8_t INT1_WM_FRAMES = 4;
+
   bool begin();
   bool readFRU(ImuSample &out); // returns in FRU frame
+  bool readBatchFRU(ImuBatch &out); // FIFO drain + decimation (single sample if IMU_FIFO=0)
+
+  // Gyro bias calibration runs on the samples read*FRU() pulls; until it is
+  // done gyro output carries the seed bias (or none).
+  bool gyroCalDone() const { return _cal.done(); }
+  const GyroCalibrator &gyroCal() const { return _cal; }
+  const GyroTempBias &gyroTempBias() const { return _tbias; }
+
+  // BMI270 die temperature, refreshed every TEMP_EVERY_READS batch reads
+  static constexpr uint8_t TEMP_EVERY_READS = 40;   // 10 Hz at FAST_HZ
+  bool tempValid() const { return _temp_ok; }
+  float tempC() const { return _temp_c; }
+
+  // Report-group housekeeping (Sensors::very_slow_read(); saves a new gyro
+  // bias to NVS, which takes milliseconds)
+  void service();
+
+  // Must be set before begin() enables the interrupt to see every edge.
+  void onDataReady(DataReadyFn fn);
+  bool irqEnabled() const { return _irq_ok; }
+  const ImuIrqStats &irqStats() const { return _irq; }
+
+  // Register reads that failed (SPI error or a stuck all-0x00/0xFF burst);
+  // the sample is dropped, not passed on
+  uint32_t readErrors() const { return _read_errors; }
 
 private:
   //static bool _read_raw_sample(float &x, float &y, float &z);
   bool read(ImuSample &out); // returns in BMI270s default frame
-  bool calibrate_gyro();
+  void to_si(const int16_t acc[3], const int16_t gyr[3], ImuSample &out);
+  void publish_bias();
+  void update_temp();
   bool _ok = false;
+  bool _fifo_ok = false;
+  bool _irq_ok = false;
+  uint32_t _last_edge = 0;
+  uint32_t _read_errors = 0;
+  ImuIrqStats _irq;
+  Bmi270Fifo _fifo{IMU_CFG.sensortime_ticks()};
+  Bmi270FifoBatch _raw;
+  ImuDecimator _decim;
+  GyroCalibrator _cal;
+  GyroTempBias _tbias;
+  float _temp_c = 0;
+  bool _temp_ok = false;
+  uint8_t _temp_div = 0;
+  volatile bool _bias_save_pending = false;
   float _gyro_bias_x =0;
   float _gyro_bias_y =0;
   float _gyro_bias_z =0;
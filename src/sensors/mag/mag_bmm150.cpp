@@ -3,14 +3,15 @@
 static constexpr uint8_t REG_CHIP_ID      = 0x40; // expect 0x32
 static constexpr uint8_t REG_POWER_CTRL   = 0x4B; // write 0x01 to enable
 static constexpr uint8_t REG_OPMODE       = 0x4C; // keep simple for now
-static constexpr uint8_t REG_DATA_X_LSB   = 0x42; // 0x42..0x47
+static constexpr uint8_t REG_DATA_X_LSB   = 0x42; // 0x42..0x47 (read with the chip id)
 
 static constexpr uint8_t CHIP_ID_BMM150   = 0x32;
 
-bool MagBmm150::begin(TwoWire& wire, uint8_t addr7) {
-  _wire = &wire;
+bool MagBmm150::begin(I2cBus& bus, uint8_t addr7) {
+  _bus = &bus;
   _addr = addr7;
   _ok = false;
+  if (_dev == I2C_DEV_NONE) _dev = bus.add_device("bmm150", addr7);
 
   // Some boards need a brief settle (you already saw that power ctrl matters)
   delay(2);
@@ -28,57 +29,66 @@ bool MagBmm150::begin(TwoWire& wire, uint8_t addr7) {
   (void)write8(REG_OPMODE, 0x00);
   delay(2);
 
+  static const uint8_t reg = REG_CHIP_ID;
+  _txn.dev = _dev;
+  _txn.prio = I2cPrio::SENSOR;
+  _txn.set_read(_addr, &reg, _raw, sizeof(_raw));
+  _txn.done_fn = on_data_;
+  _txn.ctx = this;
+
   _ok = (id == CHIP_ID_BMM150);
   return _ok;
 }
 
-void MagBmm150::read(MagSample& out) {
-  out = MagSample{};
-  if (!_ok || !_wire) return;
-
-  uint8_t id = 0;
-  if (!read8(REG_CHIP_ID, id)) return;
-  out.chip_id = id;
-  if (id != CHIP_ID_BMM150) return;
-
-  uint8_t b[6] = {0};
-  if (!readN(REG_DATA_X_LSB, b, sizeof(b))) return;
+bool MagBmm150::request() {
+  if (!_ok) return false;
+  return _bus->submit(_txn);
+}
 
-  // X/Y are 13-bit signed, Z is 15-bit signed in the common Bosch format.
-  // This is “good enough” for bring-up / non-calibrated heading tests.
-  out.x = unpack13(b[0], b[1]);
-  out.y = unpack13(b[2], b[3]);
-  out.z = unpack15(b[4], b[5]);
+void MagBmm150::read(MagSample& out) {
+  if (!_latest.read(out)) out = MagSample{};
+}
 
-  out.valid = true;
+// Bus task
+void MagBmm150::on_data_(I2cTxn& t, void* ctx) {
+  MagBmm150& m = *static_cast<MagBmm150*>(ctx);
+  MagSample out;
+  const uint8_t* b = m._raw;
+  if (t.ok) {
+    // Chip id first: reads 0x00 after a brown-out (power control lost)
+    out.chip_id = b[0];
+    if (out.chip_id == CHIP_ID_BMM150) {
+      // X/Y are 13-bit signed, Z is 15-bit signed in the common Bosch format.
+      // This is “good enough” for bring-up / non-calibrated heading tests.
+      out.x = unpack13(b[2], b[3]);
+      out.y = unpack13(b[4], b[5]);
+      out.z = unpack15(b[6], b[7]);
+      out.valid = true;
+    }
+  }
+  m._latest.write(out);
 }
 
+// Register access for begin(): synchronous through the bus
 bool MagBmm150::read8(uint8_t reg, uint8_t& v) {
-  if (!_wire) return false;
-  _wire->beginTransmission(_addr);
-  _wire->write(reg);
-  if (_wire->endTransmission(false) != 0) return false; // repeated start
-  if (_wire->requestFrom((int)_addr, 1) != 1) return false;
-  v = _wire->read();
-  return true;
+  return readN(reg, &v, 1);
 }
 
 bool MagBmm150::readN(uint8_t reg, uint8_t* buf, size_t n) {
-  if (!_wire) return false;
-  _wire->beginTransmission(_addr);
-  _wire->write(reg);
-  if (_wire->endTransmission(false) != 0) return false;
-  if (_wire->requestFrom((int)_addr, (int)n) != (int)n) return false;
-  for (size_t i = 0; i < n; i++) buf[i] = _wire->read();
-  return true;
+  if (!_bus) return false;
+  I2cTxn t;
+  t.dev = _dev;
+  t.set_read(_addr, &reg, buf, (uint8_t)n);
+  return _bus->run(t);
 }
 
 bool MagBmm150::write8(uint8_t reg, uint8_t v) {
-  if (!_wire) return false;
-  _wire->beginTransmission(_addr);
-  _wire->write(reg);
-  _wire->write(v);
-  return (_wire->endTransmission(true) == 0);
+  if (!_bus) return false;
+  const uint8_t b[2] = { reg, v };
+  I2cTxn t;
+  t.dev = _dev;
+  t.set_write(_addr, b, sizeof(b));
+  return _bus->run(t);
 }
 
 int16_t MagBmm150::unpack13(uint8_t lsb, uint8_t msb) {
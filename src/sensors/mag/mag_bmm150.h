@@ -1,6 +1,8 @@
 #pragma once
 #include <Arduino.h>
-#include <Wire.h>
+
+#include "board/i2c_bus.h"
+#include "utils/spsc.h"
 
 struct MagSample {
   bool valid = false;
@@ -10,16 +12,29 @@ struct MagSample {
   uint8_t chip_id = 0;
 };
 
+// Reads go through the I2C bus task: request() queues one, read() returns
+// the newest completed. begin() runs its transactions synchronously.
 class MagBmm150 {
 public:
-  bool begin(TwoWire& wire, uint8_t addr7 = 0x10);
+  bool begin(I2cBus& bus, uint8_t addr7 = 0x10);
+
+  // Queue a data read (false while the previous one is still pending)
+  bool request();
+  // Newest completed read, invalid until one completed
   void read(MagSample& out);
 
 private:
-  TwoWire* _wire = nullptr;
+  I2cBus* _bus = nullptr;
+  uint8_t _dev = I2C_DEV_NONE;
   uint8_t _addr = 0;
   bool _ok = false;
 
+  // Async read: chip id through Z in one burst (0x40..0x47)
+  I2cTxn _txn;
+  uint8_t _raw[8] = {0};
+  SpscSnapshot<MagSample> _latest;
+  static void on_data_(I2cTxn& t, void* ctx);
+
   bool read8(uint8_t reg, uint8_t& v);
   bool readN(uint8_t reg, uint8_t* buf, size_t n);
   bool write8(uint8_t reg, uint8_t v);
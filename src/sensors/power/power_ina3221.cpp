@@ -1,4 +1,5 @@
 #include "power_ina3221.h"
+#include "utils/profiler.h"
 
 PowerINA3221::~PowerINA3221() {
   if (_ina) {
@@ -7,19 +8,25 @@ PowerINA3221::~PowerINA3221() {
   }
 }
 
-bool PowerINA3221::begin(TwoWire& wire, uint8_t addr, float shunt_ohms_ch2) {
+bool PowerINA3221::begin(I2cBus& bus, uint8_t addr, float shunt_ohms_ch2) {
   _addr = addr;
   _rshunt = shunt_ohms_ch2;
   _err = 0;
   _ready = false;
+  _bus = &bus;
+  if (_txn.dev == I2C_DEV_NONE) _txn.dev = bus.add_device("ina3221", addr);
+  _txn.prio = I2cPrio::SENSOR;
+  _txn.job = read_job_;
+  _txn.ctx = this;
 
   if (_ina) {
     delete _ina;
     _ina = nullptr;
   }
 
-  // NOTE: Wire.begin() is already done in your board_init()
-  _ina = new INA3221(_addr, &wire);
+  // NOTE: Wire.begin() is already done in your board_init(). Boot only:
+  // once the bus task runs, the library is only called from its jobs.
+  _ina = new INA3221(_addr, &bus.wire());
 
   if (!_ina->begin()) {
     _err++;
@@ -51,7 +58,30 @@ bool PowerINA3221::begin(TwoWire& wire, uint8_t addr, float shunt_ohms_ch2) {
   return true;
 }
 
-PowerSample PowerINA3221::read() {
+bool PowerINA3221::request() {
+  if (!_bus || !_ina || !_ready) return false;
+  return _bus->submit(_txn);
+}
+
+PowerSample PowerINA3221::read() const {
+  PowerSample s;
+  if (!_latest.read(s)) s = PowerSample{};
+  return s;
+}
+
+// Bus task
+bool PowerINA3221::read_job_(void* ctx) {
+  PowerINA3221& p = *static_cast<PowerINA3221*>(ctx);
+  PowerSample s;
+  {
+    PROFILE_ZONE(POWER);
+    s = p.read_now_();
+  }
+  p._latest.write(s);
+  return s.valid;
+}
+
+PowerSample PowerINA3221::read_now_() {
   PowerSample s;
   s.t_ms = millis();
 
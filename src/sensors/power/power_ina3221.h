@@ -4,6 +4,9 @@
 #include <Wire.h>
 #include <INA3221.h>
 
+#include "board/i2c_bus.h"
+#include "utils/spsc.h"
+
 struct PowerSample {
   bool     valid = false;
   uint32_t t_ms = 0;
@@ -19,15 +22,25 @@ public:
   ~PowerINA3221();
 
   // addr should be 0x40 in your case
-  bool begin(TwoWire& wire, uint8_t addr, float shunt_ohms_ch2);
+  bool begin(I2cBus& bus, uint8_t addr, float shunt_ohms_ch2);
 
-  PowerSample read();        // read CH2 only (library channel index 1)
+  // The library talks to Wire itself, so a read is a job on the I2C bus
+  // task: request() queues one (false while the previous one is pending),
+  // read() returns the newest completed (invalid until one completed).
+  bool request();
+  PowerSample read() const;
   uint32_t errorCount() const { return _err; }
   bool isReady() const { return _ina != nullptr && _ready; }
 
 private:
   INA3221* _ina = nullptr;
   bool _ready = false;
+  I2cBus* _bus = nullptr;
+
+  I2cTxn _txn;
+  SpscSnapshot<PowerSample> _latest;
+  PowerSample read_now_();   // CH2 only (library channel index 1); bus task
+  static bool read_job_(void* ctx);
 
   uint8_t _addr = 0x40;
   float _rshunt = 0.01f;     // Ohms (CH2 only)
@@ -11,10 +11,11 @@ static constexpr uint8_t REG_CALIB00   = 0x88; // 0x88..0xA1
 
 static constexpr uint8_t CHIP_ID_BMP280 = 0x58;
 
-bool PresBmp280::begin(TwoWire& wire, uint8_t addr7) {
-  _wire = &wire;
+bool PresBmp280::begin(I2cBus& bus, uint8_t addr7) {
+  _bus = &bus;
   _addr = addr7;
   _ok = false;
+  if (_dev == I2C_DEV_NONE) _dev = bus.add_device("bmp280", addr7);
 
   uint8_t id = 0;
   if (!read8(REG_ID, id)) return false;
@@ -26,19 +27,39 @@ bool PresBmp280::begin(TwoWire& wire, uint8_t addr7) {
   if (!read_calibration()) return false;
   if (!configure()) return false;
 
+  static const uint8_t reg = REG_PRESS_MSB;
+  _txn.dev = _dev;
+  _txn.prio = I2cPrio::SENSOR;
+  _txn.set_read(_addr, &reg, _raw, sizeof(_raw));
+  _txn.done_fn = on_data_;
+  _txn.ctx = this;
+
   _ok = true;
   return true;
 }
 
+bool PresBmp280::request() {
+  if (!_ok) return false;
+  return _bus->submit(_txn);
+}
+
 void PresBmp280::read(PresSample& out) {
-  out = PresSample{};
-  if (!_ok) return;
+  if (!_latest.read(out)) out = PresSample{};
+}
 
-  int32_t adc_T = 0, adc_P = 0;
-  if (!read_raw(adc_T, adc_P)) {
-    out.valid = false;
-    return;
-  }
+// Bus task
+void PresBmp280::on_data_(I2cTxn& t, void* ctx) {
+  PresBmp280& p = *static_cast<PresBmp280*>(ctx);
+  PresSample s;
+  if (t.ok) p.decode_(p._raw, s);
+  p._latest.write(s);
+}
+
+void PresBmp280::decode_(const uint8_t* b, PresSample& out) {
+  // Pressure: 20-bit unsigned
+  const int32_t adc_P = ((int32_t)b[0] << 12) | ((int32_t)b[1] << 4) | ((int32_t)b[2] >> 4);
+  // Temp: 20-bit unsigned
+  const int32_t adc_T = ((int32_t)b[3] << 12) | ((int32_t)b[4] << 4) | ((int32_t)b[5] >> 4);
 
   // Temperature: use Bosch compensation, output float °C
   int32_t t_x100 = compensate_T_x100(adc_T);
@@ -58,32 +79,26 @@ void PresBmp280::read(PresSample& out) {
   out.press_pa = press_pa;
 }
 
+// Register access for begin(): synchronous through the bus
 bool PresBmp280::read8(uint8_t reg, uint8_t& v) {
-  if (!_wire) return false;
-  _wire->beginTransmission(_addr);
-  _wire->write(reg);
-  if (_wire->endTransmission(false) != 0) return false;
-  if (_wire->requestFrom((int)_addr, 1) != 1) return false;
-  v = _wire->read();
-  return true;
+  return readN(reg, &v, 1);
 }
 
 bool PresBmp280::readN(uint8_t reg, uint8_t* buf, size_t n) {
-  if (!_wire) return false;
-  _wire->beginTransmission(_addr);
-  _wire->write(reg);
-  if (_wire->endTransmission(false) != 0) return false;
-  if (_wire->requestFrom((int)_addr, (int)n) != (int)n) return false;
-  for (size_t i = 0; i < n; i++) buf[i] = _wire->read();
-  return true;
+  if (!_bus) return false;
+  I2cTxn t;
+  t.dev = _dev;
+  t.set_read(_addr, &reg, buf, (uint8_t)n);
+  return _bus->run(t);
 }
 
 bool PresBmp280::write8(uint8_t reg, uint8_t v) {
-  if (!_wire) return false;
-  _wire->beginTransmission(_addr);
-  _wire->write(reg);
-  _wire->write(v);
-  return (_wire->endTransmission(true) == 0);
+  if (!_bus) return false;
+  const uint8_t b[2] = { reg, v };
+  I2cTxn t;
+  t.dev = _dev;
+  t.set_write(_addr, b, sizeof(b));
+  return _bus->run(t);
 }
 
 bool PresBmp280::read_calibration() {
@@ -134,18 +149,6 @@ bool PresBmp280::configure() {
   return true;
 }
 
-bool PresBmp280::read_raw(int32_t& adc_T, int32_t& adc_P) {
-  uint8_t b[6] = {0};
-  if (!readN(REG_PRESS_MSB, b, sizeof(b))) return false;
-
-  // Pressure: 20-bit unsigned
-  adc_P = ((int32_t)b[0] << 12) | ((int32_t)b[1] << 4) | ((int32_t)b[2] >> 4);
-  // Temp: 20-bit unsigned
-  adc_T = ((int32_t)b[3] << 12) | ((int32_t)b[4] << 4) | ((int32_t)b[5] >> 4);
-
-  return true;
-}
-
 // Bosch compensation (BMP280 datasheet reference implementation)
 // Temperature in 0.01°C
 int32_t PresBmp280::compensate_T_x100(int32_t adc_T) {
@@ -1,6 +1,8 @@
 #pragma once
 #include <Arduino.h>
-#include <Wire.h>
+
+#include "board/i2c_bus.h"
+#include "utils/spsc.h"
 
 struct PresSample {
   bool valid = false;
@@ -8,16 +10,29 @@ struct PresSample {
   float press_pa = NAN;
 };
 
+// Reads go through the I2C bus task: request() queues one, read() returns
+// the newest completed. begin() runs its transactions synchronously.
 class PresBmp280 {
 public:
-  bool begin(TwoWire& wire, uint8_t addr7 = 0x76);
+  bool begin(I2cBus& bus, uint8_t addr7 = 0x76);
+
+  // Queue a data read (false while the previous one is still pending)
+  bool request();
+  // Newest completed read, invalid until one completed
   void read(PresSample& out);
 
 private:
-  TwoWire* _wire = nullptr;
+  I2cBus* _bus = nullptr;
+  uint8_t _dev = I2C_DEV_NONE;
   uint8_t _addr = 0;
   bool _ok = false;
 
+  // Async data read; compensated on the bus task, handed over here
+  I2cTxn _txn;
+  uint8_t _raw[6] = {0};
+  SpscSnapshot<PresSample> _latest;
+  static void on_data_(I2cTxn& t, void* ctx);
+
   // Calibration (BMP280)
   uint16_t dig_T1 = 0;
   int16_t  dig_T2 = 0, dig_T3 = 0;
@@ -35,7 +50,7 @@ private:
 
   bool read_calibration();
   bool configure();
-  bool read_raw(int32_t& adc_T, int32_t& adc_P);
+  void decode_(const uint8_t* b, PresSample& out);
 
   int32_t compensate_T_x100(int32_t adc_T);     // returns temperature in 0.01°C
   uint32_t compensate_P_Q24_8(int32_t adc_P);   // returns pressure in Pa (Q24.8 per Bosch algo)
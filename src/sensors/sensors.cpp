@@ -1,7 +1,9 @@
 #include "sensors/sensors.h"
+#include "utils/profiler.h"
 
-bool Sensors::begin(TwoWire& wire) {
+bool Sensors::begin(I2cBus& i2c) {
   bool ok = true;
+  _i2c = &i2c;
 
   Serial.println("[sensors] begin");
 
@@ -13,38 +15,72 @@ bool Sensors::begin(TwoWire& wire) {
   // Flow
   bool flow_ok = _flow.begin();
   Serial.printf("[sensors][flow]  PMW3901: %s\n", flow_ok ? "OK" : "FAIL");
+  const Pmw3901InitReport& fi = _flow.initReport();
+  Serial.printf("[sensors][flow]  init: %u steps %u writes in %.1f ms (%.1f ms SPI), verified=%u retries=%u mismatches=%u bank_unconfirmed=%u",
+                (unsigned)fi.steps, (unsigned)fi.writes, fi.total_us * 0.001f,
+                (fi.total_us - fi.wait_us) * 0.001f, (unsigned)fi.verified,
+                (unsigned)fi.retries, (unsigned)fi.mismatches, (unsigned)fi.unconfirmed);
+  if (!fi.ok && fi.steps > 0) {
+    Serial.printf(" first bad reg 0x%02X want 0x%02X got 0x%02X", fi.bad_reg, fi.bad_want, fi.bad_got);
+  }
+  Serial.println();
   if (!flow_ok) ok = false;
 
-  // ToF (down)
-  bool tof_down_ok = _tof_down.begin(_downPins, TOF_ADDR8_DOWN, TOF_ADDR7_DOWN);
-  if (tof_down_ok) {
-    _tof_down.start_ranging();
+  // ToF: down first (moved to 0x30 while front is held in reset), then
+  // front (moved to 0x31). Ranging starts from slow_read(), one sensor
+  // per slot. The GPIO1 hooks only queue once the bus task runs.
+  // Recoveries later take turns the same way (_tof_rec_token).
+  if (_frontPins.xshut >= 0) {
+    pinMode(_frontPins.xshut, OUTPUT);
+    digitalWrite(_frontPins.xshut, LOW);
   }
+  _tof_down.onDataReady(tof_down_ready_, this);
+  _tof_front.onDataReady(tof_front_ready_, this);
+  _tof_down.share_recovery(_tof_front, _tof_rec_token);
+  _tof_front.share_recovery(_tof_down, _tof_rec_token);
+  const TofProfile& down_prof = TOF_PROFILES[_tof_down_sel.current()];
+  bool tof_down_ok = _tof_down.begin(_downPins, TOF_ADDR8_DOWN, TOF_ADDR7_DOWN) &&
+                     _tof_down.set_profile(down_prof);
+  _tof_down.set_target_rules(TOF_TARGETS_DOWN);
+  _tof_sched.enable(TOF_DOWN, tof_down_ok);
+  _tof_sched.set_slots(TOF_DOWN, down_prof.slots);
   Serial.printf("[sensors][tof]   down: %s\n", tof_down_ok ? "OK" : "FAIL");
   if (!tof_down_ok) ok = false;
 
-  // ToF (front) – currently optional
-  /*
-  bool tof_front_ok = _tof_front.begin(_frontPins, TOF_ADDR8_FRONT, TOF_ADDR7_FRONT);
-  if (tof_front_ok) {
-    _tof_front.start_ranging();
-  }
+  // Front runs off VBAT: without a battery it fails here and down gets
+  // every slot
+  const TofProfile& front_prof = TOF_PROFILES[TOF_FRONT_PROFILE];
+  bool tof_front_ok = _tof_front.begin(_frontPins, TOF_ADDR8_FRONT, TOF_ADDR7_FRONT) &&
+                      _tof_front.set_profile(front_prof);
+  _tof_front.set_target_rules(TOF_TARGETS_FRONT);
+  _tof_sched.enable(TOF_FRONT, tof_front_ok);
+  _tof_sched.set_slots(TOF_FRONT, front_prof.slots);
   Serial.printf("[sensors][tof]   front: %s\n", tof_front_ok ? "OK" : "FAIL");
   if (!tof_front_ok) ok = false;
-  */
+
+  _tof_txn.dev = i2c.add_device("vl53l3", 0);
+  _tof_txn.prio = I2cPrio::RANGING;
+  _tof_txn.job = tof_slot_job_;
+  _tof_txn.ctx = this;
+  for (int ch = 0; ch < 2; ch++) {
+    _tof_fetch_txn[ch].dev = _tof_txn.dev;
+    _tof_fetch_txn[ch].prio = I2cPrio::RANGING;
+    _tof_fetch_txn[ch].job = (ch == TOF_DOWN) ? tof_fetch_down_job_ : tof_fetch_front_job_;
+    _tof_fetch_txn[ch].ctx = this;
+  }
 
   // Power monitor
-  bool power_ok = _power.begin(wire, 0x40, 0.01f);
+  bool power_ok = _power.begin(i2c, 0x40, 0.01f);
   Serial.printf("[sensors][power] INA3221: %s\n", power_ok ? "OK" : "FAIL");
   if (!power_ok) ok = false;
 
   // Pressure (BMP280)
-  bool pres_ok = _pres.begin(wire, 0x76);
+  bool pres_ok = _pres.begin(i2c, 0x76);
   Serial.printf("[sensors][pres]  BMP280: %s\n", pres_ok ? "OK" : "FAIL");
   if (!pres_ok) ok = false;
 
   // Magnetometer (BMM150)
-  bool mag_ok = _mag.begin(wire, 0x10);
+  bool mag_ok = _mag.begin(i2c, 0x10);
   Serial.printf("[sensors][mag]   BMM150: %s\n", mag_ok ? "OK" : "FAIL");
   if (!mag_ok) ok = false;
 
@@ -56,40 +92,269 @@ bool Sensors::begin(TwoWire& wire) {
 void Sensors::fast_read() {
   _s.t_fast_ms = millis();
 
-  // IMU
-  ImuSample imu_s;
-  _imu.readFRU(imu_s);
-  _s.imu = imu_s;
-  _s.imu_valid = imu_s.valid;
+  // IMU: everything the FIFO collected since last tick
+  bool imu_ok;
+  {
+    PROFILE_ZONE(IMU);
+    imu_ok = _imu.readBatchFRU(_s.imu_batch);
+  }
 
-  // Flow
+  _s.imu_skipped += _s.imu_batch.skipped;
+
+#if IMU_GYRO_NOTCH
+  {
+    PROFILE_ZONE(NOTCH);
+    GyroPeaks pk;
+    if (_gyro_peaks.read(pk) && pk.frame != _notch_frame) {
+      _notch_frame = pk.frame;
+      _notch.set(pk);
+    }
+    for (uint16_t i = 0; i < _s.imu_batch.count; i++) {
+      ImuSample &is = _s.imu_batch.s[i];
+      GyroVec v = {{ is.gx, is.gy, is.gz }};
+      _gyro_ring.push(v);
+      _notch.apply(v.g);
+      is.gx = v.g[0];
+      is.gy = v.g[1];
+      is.gz = v.g[2];
+    }
+  }
+#endif
+  for (uint16_t i = 0; i < _s.imu_batch.count; i++) {
+    const ImuSample &is = _s.imu_batch.s[i];
+    GyroStamped v = { is.t_us, { is.gx, is.gy, is.gz } };
+    _flow_gyro_ring.push(v);
+  }
+  _s.imu_cal_done = _imu.gyroCalDone();
+  _s.imu_temp_valid = _imu.tempValid();
+  _s.imu_temp_c = _imu.tempC();
+  if (imu_ok && _s.imu_batch.count > 0) {
+    _s.imu = _s.imu_batch.s[_s.imu_batch.count - 1];
+    _s.imu_valid = true;
+  } else if (!imu_ok) {
+    _s.imu_valid = false;
+  }
+}
+
+void Sensors::flow_read() {
+  _s.t_flow_ms = millis();
+
+  // Frame capture owns the sensor: keep the gyro history going, no SPI
+  GyroStamped v;
+  if (__atomic_load_n(&_flow_pause_req, __ATOMIC_SEQ_CST)) {
+    __atomic_store_n(&_flow_paused, true, __ATOMIC_SEQ_CST);
+    while (_flow_gyro_ring.pop(v)) {
+      _flow_sync.add_gyro(v.t_us, v.g);
+    }
+    _s.flow_valid = false;
+    _s.flow_paused = true;
+    return;
+  }
+  _s.flow_paused = false;
+
+  // Gyro first, with the bus free: the fast group's FIFO read must not
+  // queue behind our CS. Gyro that lands after this pairs on the next read.
+  while (_flow_gyro_ring.pop(v)) {
+    _flow_sync.add_gyro(v.t_us, v.g);
+  }
+
+  // Burst: the bus is held for the 35 us address-to-data gap and the
+  // 12 bytes only
   FlowSample flow_s;
-  _flow.read(flow_s);
+  {
+    PROFILE_ZONE(FLOW);
+    _flow.start();
+    _flow.finish(flow_s);
+  }
   _s.flow = flow_s;
   _s.flow_valid = flow_s.valid;
+
+  // Deltas accumulate between reads: every read closes an interval, with
+  // or without motion. Handed out once the gyro has caught up with it.
+  if (flow_s.read_ok) {
+    _flow_sync.add_flow(flow_s.t_us, (int16_t)flow_s.dx, (int16_t)flow_s.dy,
+                        flow_s.quality, flow_s.valid);
+  }
+  // At most PENDING can be waiting, so the batch always has room
+  FlowDelta d;
+  _s.flow_delta_count = 0;
+  while (_s.flow_delta_count < FlowGyroSync::PENDING && _flow_sync.pop(d, micros())) {
+    _s.flow_delta_batch[_s.flow_delta_count++] = d;
+    _s.flow_delta = d;
+    _s.flow_delta_valid = true;
+    _s.flow_deltas++;
+  }
+}
+
+bool Sensors::flow_capture(FlowFrame& f) {
+#if FLOW_FRAME_CAPTURE
+  // Ask the flow group to stand down and wait until it has: it only
+  // acknowledges between reads, so no burst is holding the sensor
+  __atomic_store_n(&_flow_paused, false, __ATOMIC_SEQ_CST);
+  __atomic_store_n(&_flow_pause_req, true, __ATOMIC_SEQ_CST);
+  const uint32_t t0 = millis();
+  while (!__atomic_load_n(&_flow_paused, __ATOMIC_SEQ_CST)) {
+    if (millis() - t0 > 100) {   // flow group not running
+      __atomic_store_n(&_flow_pause_req, false, __ATOMIC_SEQ_CST);
+      return false;
+    }
+    delay(1);
+  }
+
+  f.seq = _flow_frame_seq++;
+  f.squal = _s.flow.quality;
+  f.shutter = _s.flow.shutter;
+  const bool ok = _flow.captureFrame(f);
+
+  // The interval across the pause is > MAX_FLOW_DT_US: FlowGyroSync
+  // counts it as a gap and starts over from the next read
+  __atomic_store_n(&_flow_pause_req, false, __ATOMIC_SEQ_CST);
+  return ok;
+#else
+  (void)f;
+  return false;
+#endif
 }
 
 void Sensors::slow_read() {
   _s.t_slow_ms = millis();
 
-  // ToF down
-  TofSample down;
-  _tof_down.read(down);
-  _s.tof_down = down;
-  _s.tof_down_valid = down.valid;
+  // Whatever the bus task fetched since the last tick
+  TofPair t;
+  if (_tof_out.read(t)) {
+    _s.tof_down = t.down;
+    _s.tof_down_valid = t.down.valid;
+    _s.tof_down_profile = t.down_profile;
+    _s.tof_front = t.front;
+    _s.tof_front_valid = t.front.valid;
+  }
+
+  // The slot runs on the I2C bus task; this group never waits on the bus.
+  // Still pending from the last tick (bus backed up): this slot is skipped,
+  // counted as rejected in the [i2c] line, and the stagger catches up.
+  _i2c->submit(_tof_txn);
+}
+
+bool Sensors::tof_down(TofSample& out) const {
+  TofPair t;
+  if (!_tof_out.read(t)) return false;
+  out = t.down;
+  return true;
+}
+
+bool Sensors::tof_slot_job_(void* ctx) {
+  static_cast<Sensors*>(ctx)->tof_slot_();
+  return true;
+}
+
+bool Sensors::tof_fetch_down_job_(void* ctx) {
+  PROFILE_ZONE(TOF);
+  static_cast<Sensors*>(ctx)->tof_fetch_(TOF_DOWN);
+  return true;
+}
+
+bool Sensors::tof_fetch_front_job_(void* ctx) {
+  PROFILE_ZONE(TOF);
+  static_cast<Sensors*>(ctx)->tof_fetch_(TOF_FRONT);
+  return true;
+}
+
+// GPIO1 ISR: fetch now, not at the next slot. Already queued (the slot or
+// an earlier edge will pick the result up): rejected, nothing lost.
+void IRAM_ATTR Sensors::tof_down_ready_(void* ctx) {
+  Sensors* self = static_cast<Sensors*>(ctx);
+  if (self->_i2c) self->_i2c->submit_from_isr(self->_tof_fetch_txn[TOF_DOWN]);
+}
+
+void IRAM_ATTR Sensors::tof_front_ready_(void* ctx) {
+  Sensors* self = static_cast<Sensors*>(ctx);
+  if (self->_i2c) self->_i2c->submit_from_isr(self->_tof_fetch_txn[TOF_FRONT]);
+}
+
+// Bus task: take ch's result if one is waiting (GPIO1 says so, no I2C
+// otherwise) and publish it through _tof_out, the driver's counters
+// through _tof_diag[ch]
+void Sensors::tof_fetch_(int ch) {
+  TofVl53L3& tof = (ch == TOF_DOWN) ? _tof_down : _tof_front;
+  TofSample s;
+  tof.read(s, false);
+  const uint32_t now = micros();
+  if (s.fresh) {
+    _tof_sched.fetched(ch, s.t_us, now);
+    if (ch == TOF_DOWN) {
+      _tof_prof_stats[_tof_down_sel.current()].add_result(s.t_us, now);
+
+      // Down follows the range between profiles. The sensor is idle (just
+      // fetched), so the switch costs no range; it restarts in its next slot.
+      if (_tof_down_sel.update(s.valid && !s.stale, s.range_mm)) {
+        const int p = _tof_down_sel.current();
+        if (!_tof_down.set_profile(TOF_PROFILES[p])) _tof_prof_errors++;
+        _tof_sched.set_slots(TOF_DOWN, TOF_PROFILES[p].slots);
+        _tof_prof_stats[p].break_chain();
+      }
+    }
+  }
+  if (ch == TOF_DOWN) {
+    _tof_pub.down = s;
+    _tof_pub.down_profile = (uint8_t)_tof_down_sel.current();
+  } else {
+    _tof_pub.front = s;
+  }
+  _tof_out.write(_tof_pub);
+
+  TofDiag d;
+  d.last = tof.lastResult();
+  d.tgt = tof.targetStats();
+  d.irq = tof.irqStats();
+  d.irq_on = tof.irqEnabled();
+  d.rec_state = tof.recovery().state();
+  d.rec = tof.recovery().stats();
+  _tof_diag[ch].write(d);
+}
+
+// Bus task: whatever finished without an edge job (or with GPIO1 off),
+// then start the slot owner's next range
+void Sensors::tof_slot_() {
+  PROFILE_ZONE(TOF);
+  tof_fetch_(TOF_DOWN);
+  tof_fetch_(TOF_FRONT);
 
-  // ToF front
-  //TofSample front;
-  //_tof_front.read(front);
-  //_s.tof_front = front;
-  //_s.tof_front_valid = front.valid;
+  bool kick = false;
+  const uint32_t now = micros();
+  const int slot = _tof_sched.tick(now, kick);
+  if (kick) {
+    TofVl53L3& tof = (slot == TOF_DOWN) ? _tof_down : _tof_front;
+    if (tof.kick()) _tof_sched.kicked(slot, micros());
+  }
+}
+
+// Spec group: drain the gyro ring, one analyzer frame per HOP samples
+void Sensors::spectrum_run() {
+#if IMU_GYRO_NOTCH
+  GyroVec v;
+  while (_gyro_ring.pop(v)) {
+    if (!_spec.push(v.g)) continue;
+    {
+      PROFILE_ZONE(SPEC);
+      _spec.process();
+    }
+    _gyro_peaks.write(_spec.peaks());
+  }
+#endif
 }
 
 void Sensors::very_slow_read() {
   _s.t_very_slow_ms = millis();
 
+  // IMU housekeeping (gyro bias -> NVS once calibrated)
+  _imu.service();
+
+  // Power, pressure, mag: take what the reads queued last period
+  // returned, then queue this period's. Values are one period (1 s) old;
+  // none of this group waits on the bus.
+
   // Power
-  PowerSample power_s = _power.read();
+  const PowerSample power_s = _power.read();
   _s.power = power_s;
   _s.power_valid = power_s.valid;
   _s.power_err = _power.errorCount();
@@ -105,27 +370,113 @@ void Sensors::very_slow_read() {
   _mag.read(mag_s);
   _s.mag = mag_s;
   _s.mag_valid = mag_s.valid;
+
+  _power.request();
+  _pres.request();
+  _mag.request();
 }
 
 void Sensors::printSample() const {
   // IMU
   if (_s.imu_valid) {
-    Serial.printf("[imu SI] acc=%.3f %.3f %.3f  gyr=%.3f %.3f %.3f\n",
+    Serial.printf("[imu SI] acc=%.3f %.3f %.3f  gyr=%.3f %.3f %.3f  fifo n=%u%s skipped=%lu read_err=%lu\n",
                   _s.imu.ax, _s.imu.ay, _s.imu.az,
-                  _s.imu.gx, _s.imu.gy, _s.imu.gz);
+                  _s.imu.gx, _s.imu.gy, _s.imu.gz,
+                  (unsigned)_s.imu_batch.count, _s.imu_batch.backlog ? "+" : "",
+                  (unsigned long)_s.imu_skipped, (unsigned long)_imu.readErrors());
+  } else {
+    Serial.printf("[imu SI] -- read_err=%lu\n", (unsigned long)_imu.readErrors());
+  }
+  if (_imu.irqEnabled()) {
+    const ImuIrqStats& irq = _imu.irqStats();
+    Serial.printf("[imu irq] edges=%lu irq_reads=%lu polled=%lu lat last=%luus avg=%luus max=%luus\n",
+                  (unsigned long)irq.edges, (unsigned long)irq.irq_reads,
+                  (unsigned long)irq.polled_reads, (unsigned long)irq.last_lat_us,
+                  (unsigned long)irq.avg_lat_us(), (unsigned long)irq.max_lat_us);
+  } else {
+    Serial.println("[imu irq] off (polling)");
+  }
+  const GyroCalibrator& cal = _imu.gyroCal();
+  if (cal.done()) {
+    Serial.printf("[imu cal] done (%s)\n",
+                  cal.source() == GyroCalibrator::Source::SEED ? "NVS seed" : "measured");
   } else {
-    Serial.println("[imu SI] --");
+    Serial.printf("[imu cal] %u/%u %s resets=%lu%s\n",
+                  (unsigned)cal.still_count(), (unsigned)cal.target(),
+                  cal.still() ? "still" : "MOVING", (unsigned long)cal.motion_resets(),
+                  cal.seed_rejected() ? " (seed rejected)" : "");
+  }
+  const GyroTempBias& tb = _imu.gyroTempBias();
+  if (_s.imu_temp_valid && tb.ready()) {
+    constexpr float MDPS = 180000.0f / 3.14159265f;   // rad/s -> mdps
+    Serial.printf("[imu temp] T=%.2fC model %s bins=%u obs=%lu rejected=%lu span=%.1f..%.1fC slope=%.2f %.2f %.2f mdps/C\n",
+                  _s.imu_temp_c, tb.sloped() ? "T-fit" : "offset", (unsigned)tb.bins_used(),
+                  (unsigned long)tb.observations(), (unsigned long)tb.windows_rejected(),
+                  tb.t_lo(), tb.t_hi(),
+                  tb.slope(0) * MDPS, tb.slope(1) * MDPS, tb.slope(2) * MDPS);
+  } else if (_s.imu_temp_valid) {
+    Serial.printf("[imu temp] T=%.2fC model --\n", _s.imu_temp_c);
   }
 
+#if IMU_GYRO_NOTCH
+  GyroPeaks pk;
+  if (_gyro_peaks.read(pk)) {
+    Serial.printf("[gyro spec] frames=%lu dropped=%lu notches=%u retunes=%lu |",
+                  (unsigned long)pk.frame, (unsigned long)_gyro_ring.dropped(),
+                  (unsigned)_notch.active_count(), (unsigned long)_notch.retunes());
+    for (int a = 0; a < 3; a++) {
+      Serial.printf(" %c:", "xyz"[a]);
+      for (int k = 0; k < GyroPeaks::K; k++) {
+        const GyroPeak &p = pk.axis[a][k];
+        if (p.valid) Serial.printf(" %.1fHz/%.0fdB", p.hz, p.snr_db);
+        else Serial.print(" --");
+      }
+    }
+    Serial.println();
+  } else {
+    Serial.println("[gyro spec] --");
+  }
+#endif
+
   // Flow
   if (_s.flow_valid) {
-    Serial.printf("[flow raw] dx= %.3f dy= %.3f motion= %u quality= %u\n",
+    Serial.printf("[flow raw] dx= %.3f dy= %.3f motion= %u quality= %u shutter= %u\n",
                   _s.flow.dx, _s.flow.dy,
                   (unsigned)_s.flow.motion,
-                  (unsigned)_s.flow.quality);
+                  (unsigned)_s.flow.quality,
+                  (unsigned)_s.flow.shutter);
   } else {
     Serial.println("[flow raw] --");
   }
+  if (_s.flow_delta_valid) {
+    const FlowDelta &d = _s.flow_delta;
+    Serial.printf("[flow sync] n=%lu dt=%luus d=%d %d gyro=%.4f %.4f %.4f rad%s dropped=%lu gaps=%lu gyro_lost=%lu ring_dropped=%lu\n",
+                  (unsigned long)_s.flow_deltas, (unsigned long)(d.t1_us - d.t0_us),
+                  (int)d.dx, (int)d.dy, d.gyro_rad[0], d.gyro_rad[1], d.gyro_rad[2],
+                  d.gyro_ok ? "" : " (no gyro)",
+                  (unsigned long)_flow_sync.dropped(), (unsigned long)_flow_sync.gaps(),
+                  (unsigned long)_flow_sync.gyro_restarts(),
+                  (unsigned long)_flow_gyro_ring.dropped());
+  } else {
+    Serial.println("[flow sync] --");
+  }
+#if FLOW_BURST
+  const FlowAsyncStats& fa = _flow.asyncStats();
+  Serial.printf("[flow async] reads=%lu spun=%lu spin avg=%luus max=%luus\n",
+                (unsigned long)fa.reads, (unsigned long)fa.spun,
+                (unsigned long)(fa.spun ? fa.spin_us / fa.spun : 0),
+                (unsigned long)fa.max_spin_us);
+#endif
+
+#if FLOW_FRAME_CAPTURE
+  const FlowFrameStats& ff = _flow.frameStats();
+  if (ff.grabs) {
+    Serial.printf("[flow frame] grabs=%lu failed=%lu reinit_failed=%lu not_ready=%lu out_of_order=%lu\n",
+                  (unsigned long)ff.grabs, (unsigned long)ff.failed,
+                  (unsigned long)ff.reinit_failed, (unsigned long)ff.not_ready,
+                  (unsigned long)ff.out_of_order);
+  }
+#endif
 
   // ToF
   auto print_one = [](const char *name, const TofSample &ts) {
@@ -142,7 +493,84 @@ void Sensors::printSample() const {
 
   Serial.print("[tof] ");
   print_one("down", _s.tof_down);
+  print_one("front", _s.tof_front);
   Serial.println();
+  auto print_sched = [this](const char *name, int i) {
+    if (!_tof_sched.enabled(i)) {
+      Serial.printf("[tof sched] %s: off\n", name);
+      return;
+    }
+    const TofChannelStats& st = _tof_sched.stats(i);
+    Serial.printf("[tof sched] %s: %.1f Hz results=%lu range=%lu/%luus lat avg=%luus max=%luus missed=%lu timeouts=%lu overlaps=%lu\n",
+                  name, st.rate_hz(), (unsigned long)st.results,
+                  (unsigned long)st.last_range_us, (unsigned long)st.max_range_us,
+                  (unsigned long)st.avg_lat_us(), (unsigned long)st.max_lat_us,
+                  (unsigned long)st.slot_missed, (unsigned long)st.timeouts,
+                  (unsigned long)st.overlaps);
+  };
+  print_sched("down", TOF_DOWN);
+  print_sched("front", TOF_FRONT);
+  Serial.print("[tof profile] down:");
+  for (int p = 0; p < TOF_PROFILE_COUNT; p++) {
+    const TofChannelStats& st = _tof_prof_stats[p];
+    Serial.printf(" %s%s %.1f Hz n=%lu lat avg=%luus max=%luus |", TOF_PROFILES[p].name,
+                  p == _tof_down_sel.current() ? "*" : "", st.rate_hz(),
+                  (unsigned long)st.results, (unsigned long)st.avg_lat_us(),
+                  (unsigned long)st.max_lat_us);
+  }
+  Serial.printf(" switches=%lu errors=%lu\n", (unsigned long)_tof_down_sel.switches(),
+                (unsigned long)_tof_prof_errors);
+  // Copies taken on the bus task (tof_fetch_()): one result's objects and
+  // its selection stay together even if a fetch lands mid-print
+  TofDiag diag[2];
+  bool diag_ok[2];
+  for (int ch = 0; ch < 2; ch++) diag_ok[ch] = _tof_diag[ch].read(diag[ch]);
+  const char* tof_name[2] = {"down", "front"};
+  for (int ch = 0; ch < 2; ch++) {
+    if (!diag_ok[ch]) continue;
+    const TofTargetStats& st = diag[ch].tgt;
+    const TofSample& ts = diag[ch].last;
+    Serial.printf("[tof targets] %s: results=%lu multi=%lu none=%lu rejected:",
+                  tof_name[ch], (unsigned long)st.results, (unsigned long)st.multi,
+                  (unsigned long)st.none);
+    for (int r = 1; r < TOF_TARGET_REJECT_COUNT; r++) {
+      Serial.printf(" %s=%lu", tof_target_reject_name((TofTargetReject)r),
+                    (unsigned long)st.rejected[r]);
+    }
+    // Last fresh result's objects, selected one marked
+    Serial.print(" |");
+    for (int i = 0; i < ts.n_targets; i++) {
+      const TofTarget& t = ts.targets[i];
+      Serial.printf(" %s%umm/%.2fMcps/%.0fmm%s%s", i == ts.target ? "*" : "",
+                    (unsigned)t.range_mm, t.signal_mcps, t.sigma_mm,
+                    t.reject == TofTargetReject::NONE ? "" : "/",
+                    t.reject == TofTargetReject::NONE ? "" : tof_target_reject_name(t.reject));
+    }
+    Serial.println();
+  }
+  for (int ch = 0; ch < 2; ch++) {
+    if (!diag_ok[ch]) continue;
+    if (!diag[ch].irq_on) {
+      Serial.printf("[tof irq] %s: off (polling)\n", tof_name[ch]);
+      continue;
+    }
+    const TofIrqStats& irq = diag[ch].irq;
+    Serial.printf("[tof irq] %s: edges=%lu irq_reads=%lu level=%lu polled=%lu/%lu idle=%lu lat last=%luus avg=%luus max=%luus\n",
+                  tof_name[ch], (unsigned long)irq.edges, (unsigned long)irq.irq_reads,
+                  (unsigned long)irq.level_reads, (unsigned long)irq.polled_reads,
+                  (unsigned long)irq.polls, (unsigned long)irq.idle,
+                  (unsigned long)irq.last_lat_us, (unsigned long)irq.avg_lat_us(),
+                  (unsigned long)irq.max_lat_us);
+  }
+  for (int ch = 0; ch < 2; ch++) {
+    if (!diag_ok[ch]) continue;
+    const TofRecoveryStats& st = diag[ch].rec;
+    Serial.printf("[tof recovery] %s: %s started=%lu recovered=%lu failed=%lu waits=%lu last=%lums max=%lums\n",
+                  tof_name[ch], tof_rec_state_name(diag[ch].rec_state), (unsigned long)st.started,
+                  (unsigned long)st.recovered, (unsigned long)st.failed_attempts,
+                  (unsigned long)st.waits,
+                  (unsigned long)(st.last_us / 1000), (unsigned long)(st.max_us / 1000));
+  }
 
   // Power
   if (!_s.power_valid) {
@@ -3,12 +3,26 @@
 #include <Arduino.h>
 #include <Wire.h>
 
+#include "board/i2c_bus.h"
 #include "config/pins.h"
+#include "config/tof_config.h"
+#include "utils/spsc.h"
+
+// IMU_GYRO_NOTCH=1: FFT the decimated gyro in the spec group and notch the
+// tracked vibration peaks out of the fast loop's gyro (GyroSpectrum +
+// GyroNotchBank). 0: gyro passes through untouched.
+#ifndef IMU_GYRO_NOTCH
+#define IMU_GYRO_NOTCH 1
+#endif
 
 // Drivers
 #include "sensors/imu/imu_bmi270.h"
+#include "sensors/imu/gyro_spectrum.h"
+#include "sensors/imu/gyro_notch.h"
 #include "sensors/flow/flow_pmw3901.h"
+#include "sensors/flow/flow_gyro_sync.h"
 #include "sensors/tof/tof_vl53l3.h"
+#include "sensors/tof/tof_stagger.h"
 #include "sensors/power/power_ina3221.h"
 #include "sensors/pres/pres_bmp280.h"
 #include "sensors/mag/mag_bmm150.h"
@@ -17,20 +31,35 @@
 struct SensorsSample {
   // Timestamps for when each rate-group last updated
   uint32_t t_fast_ms = 0;
+  uint32_t t_flow_ms = 0;
   uint32_t t_slow_ms = 0;
   uint32_t t_very_slow_ms = 0;
 
-  // IMU
+  // IMU (imu = newest sample of imu_batch)
   bool imu_valid = false;
   ImuSample imu{};
+  ImuBatch imu_batch{};
+  uint32_t imu_skipped = 0;      // running total of frames lost to FIFO overflow
+  bool imu_cal_done = false;     // gyro bias converged (gyro not trustworthy before)
+  bool imu_temp_valid = false;
+  float imu_temp_c = 0;          // BMI270 die temperature
 
-  // Flow
+  // Flow (flow = last read; flow_delta = newest interval paired with the gyro)
   bool flow_valid = false;
   FlowSample flow{};
+  bool flow_delta_valid = false;
+  FlowDelta flow_delta{};
+  uint32_t flow_deltas = 0;      // running total handed out
+  // Every interval the last flow_read() handed out, oldest first (usually
+  // one; two or more after the gyro lagged)
+  FlowDelta flow_delta_batch[FlowGyroSync::PENDING];
+  uint8_t flow_delta_count = 0;
+  bool flow_paused = false;      // frame capture has the sensor
 
   // ToF (down)
   bool tof_down_valid = false;
   TofSample tof_down{};
+  uint8_t tof_down_profile = 0;  // TOF_PROFILES index the down sensor is on
 
   // ToF (front)
   bool tof_front_valid = false;
@@ -54,13 +83,29 @@ class Sensors {
 public:
   Sensors() = default;
 
-  bool begin(TwoWire& wire);     // init all sensors
-  void fast_read();              // 250 Hz group
-  void slow_read();              // 20 Hz group
-  void very_slow_read();         // 1 Hz group (power, etc.)
+  bool begin(I2cBus& i2c);       // init all sensors (before i2c.start())
+  void fast_read();              // 400 Hz group (IMU)
+  void flow_read();              // flow group, PMW3901 frame rate
+  void slow_read();              // slow group: queues one ToF slot per tick
+  void very_slow_read();         // 1 Hz group (power, etc.; queued on the bus)
+  void spectrum_run();           // low-priority group: gyro FFT + peak tracking
+
+  // Raw PMW3901 frame (FLOW_FRAME_CAPTURE). Pauses flow_read(), grabs,
+  // re-inits the sensor, resumes. Blocks ~0.25 s: call from a core 0 group,
+  // never from the flow group itself.
+  bool flow_capture(FlowFrame& f);
+  const FlowFrameStats& flowFrameStats() const { return _flow.frameStats(); }
 
   const SensorsSample& sample() const { return _s; }
 
+  // Newest down range straight from the bus task (any group, any core);
+  // false until the first one. sample().tof_down is the slow group's copy.
+  bool tof_down(TofSample& out) const;
+  const TofStagger& tofSchedule() const { return _tof_sched; }
+
+  // BMI270 INT1 hook (set before begin()); see ImuBmi270::onDataReady
+  void set_imu_data_ready(ImuBmi270::DataReadyFn fn) { _imu.onDataReady(fn); }
+
   void printSample() const;
 
 private:
@@ -70,7 +115,8 @@ private:
   ImuBmi270 _imu;
   FlowPmw3901 _flow;
   TofVl53L3 _tof_down;
-  TofVl53L3 _tof_front;          // optional future
+  TofVl53L3 _tof_front;
+  TofRecoveryToken _tof_rec_token;   // one ToF on the default address at a time
   PowerINA3221 _power;
   PresBmp280 _pres;
   MagBmm150 _mag;
@@ -80,4 +126,67 @@ private:
   TofPins _frontPins{PIN_TOF2_XSHUT, PIN_TOF2_GPIO1};
 
   bool _power_ok = false;
+
+  // All I2C goes through the bus task. The ToF slot (the VL53LX driver
+  // talks to Wire itself) runs there as one job per slow tick; a GPIO1
+  // edge queues its sensor's fetch at once instead of waiting for it.
+  I2cBus* _i2c = nullptr;
+  I2cTxn _tof_txn;
+  I2cTxn _tof_fetch_txn[2];             // TOF_DOWN, TOF_FRONT
+
+  // ToF results leave the bus task (core 0) only through this snapshot;
+  // _tof_pub is the bus task's own copy it is written from
+  struct TofPair {
+    TofSample down, front;
+    uint8_t down_profile;
+  };
+  TofPair _tof_pub{};
+  SpscSnapshot<TofPair> _tof_out;
+  // Driver diagnostics for printSample(), copied after each fetch the same
+  // way (TOF_DOWN, TOF_FRONT): the report task never reads the drivers
+  struct TofDiag {
+    TofSample last;               // last fresh result, targets and all
+    TofTargetStats tgt;
+    TofIrqStats irq;
+    bool irq_on;
+    TofRecState rec_state;
+    TofRecoveryStats rec;
+  };
+  SpscSnapshot<TofDiag> _tof_diag[2];
+  void tof_slot_();
+  void tof_fetch_(int ch);
+  static bool tof_slot_job_(void* ctx);
+  static bool tof_fetch_down_job_(void* ctx);
+  static bool tof_fetch_front_job_(void* ctx);
+  static void tof_down_ready_(void* ctx);
+  static void tof_front_ready_(void* ctx);
+
+  // Down and front range in alternating slow-group slots
+  TofStagger _tof_sched{2, TOF_STUCK_US};
+  // Down's profile follows the range; rate and latency kept per profile
+  TofProfileSelector _tof_down_sel{TOF_PROFILES, TOF_PROFILE_COUNT, TOF_DOWN_START_PROFILE};
+  TofChannelStats _tof_prof_stats[TOF_PROFILE_COUNT];
+  uint32_t _tof_prof_errors = 0;
+
+  // Post-notch gyro, fast -> flow, for the rotation over each flow interval
+  struct GyroStamped { uint32_t t_us; float g[3]; };
+  SpscRing<GyroStamped, 64> _flow_gyro_ring;   // 160 ms at 400 Hz
+  FlowGyroSync _flow_sync;
+
+  // Frame capture hand-shake: capture sets _flow_pause_req, the flow group
+  // acknowledges with _flow_paused between two reads (no burst open)
+  volatile bool _flow_pause_req = false;
+  volatile bool _flow_paused = false;
+  uint16_t _flow_frame_seq = 0;
+
+#if IMU_GYRO_NOTCH
+  // Raw (pre-notch) gyro goes fast -> spec through the ring; tracked peaks
+  // come back through the snapshot and retune the notches in the fast loop.
+  struct GyroVec { float g[3]; };
+  SpscRing<GyroVec, 256> _gyro_ring;     // 640 ms at 400 Hz
+  SpscSnapshot<GyroPeaks> _gyro_peaks;
+  GyroSpectrum _spec{(float)IMU_OUT_HZ};
+  GyroNotchBank _notch{(float)IMU_OUT_HZ};
+  uint32_t _notch_frame = 0;             // last GyroPeaks::frame applied
+#endif
 };
@@ -0,0 +1,38 @@
+#include "tof_profile.h"
+
+TofProfileSelector::TofProfileSelector(const TofProfile* profiles, int n, int start)
+    : p_(profiles), n_(n < 1 ? 1 : n), cur_(start < 0 ? 0 : (start >= n ? n - 1 : start))
+{
+}
+
+bool TofProfileSelector::update(bool valid, uint16_t range_mm)
+{
+  const TofProfile& p = p_[cur_];
+  const bool can_out = cur_ + 1 < n_;
+  const bool can_in = cur_ > 0;
+
+  bool want_out = false, want_in = false;
+  if (valid) {
+    invalid_ = 0;
+    want_out = can_out && range_mm > p.max_mm;
+    want_in = can_in && range_mm < p.min_mm;
+  } else {
+    // No target: out of this mode's reach (or nothing there at all; the
+    // far profile then just keeps trying)
+    if (invalid_ < 255) invalid_++;
+    want_out = can_out && invalid_ >= NO_TARGET;
+  }
+
+  out_ = want_out ? (uint8_t)(out_ + 1) : 0;
+  in_ = want_in ? (uint8_t)(in_ + 1) : 0;
+
+  int next = cur_;
+  if (want_out && (out_ >= CONFIRM || invalid_ >= NO_TARGET)) next = cur_ + 1;
+  else if (in_ >= CONFIRM) next = cur_ - 1;
+  if (next == cur_) return false;
+
+  cur_ = next;
+  out_ = in_ = invalid_ = 0;
+  switches_++;
+  return true;
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <stdint.h>
+
+// VL53L3 ranging profiles (distance mode + timing budget) and the switch
+// between them as the range changes.
+//
+// Short mode copes best with ambient light and ranges fast but only sees
+// to ~1.3 m; long mode reaches ~4 m and needs a longer budget for the same
+// noise. Near the ground (take-off, landing, hover) the altitude loop wants
+// the fast profile; higher up only long mode sees the floor at all.
+//
+// Profiles are ordered near -> far. The selector moves one step out when
+// the range passes max_mm, or when results keep coming back without a
+// target (beyond what this mode can see), and one step in below min_mm of
+// the current profile. Each move needs CONFIRM results in a row, and
+// max_mm of a profile sits above min_mm of the next one, so it doesn't
+// flap at the boundary.
+//
+// No Arduino dependencies (host test: test/tof_profile_test.cpp).
+
+// Same values as VL53LX_DISTANCEMODE_*
+enum class TofDistanceMode : uint8_t {
+  SHORT = 1,
+  MEDIUM = 2,
+  LONG = 3,
+};
+
+struct TofProfile {
+  const char* name;
+  TofDistanceMode mode;
+  uint32_t budget_us;   // VL53LX measurement timing budget
+  uint8_t slots;        // TofStagger slots one range takes
+  uint16_t min_mm;      // below: step in (0 = nearest profile)
+  uint16_t max_mm;      // above: step out (0xFFFF = farthest profile)
+};
+
+class TofProfileSelector {
+ public:
+  static constexpr uint8_t CONFIRM = 3;        // results in a row to move
+  static constexpr uint8_t NO_TARGET = 5;      // invalid results in a row: step out
+
+  TofProfileSelector(const TofProfile* profiles, int n, int start = 0);
+
+  // One fetched result (valid = fresh range that passed the driver's
+  // gating). True when the profile changed; current() is the new one.
+  bool update(bool valid, uint16_t range_mm);
+
+  int current() const { return cur_; }
+  const TofProfile& profile() const { return p_[cur_]; }
+  uint32_t switches() const { return switches_; }
+
+ private:
+  const TofProfile* p_;
+  int n_;
+  int cur_;
+  uint8_t out_ = 0;       // results in a row asking to step out
+  uint8_t in_ = 0;        // ... to step in
+  uint8_t invalid_ = 0;
+  uint32_t switches_ = 0;
+};
@@ -0,0 +1,108 @@
+#include "tof_recovery.h"
+
+void TofRecovery::enter_(TofRecState s, uint32_t now_us)
+{
+  state_ = s;
+  t_state_us_ = now_us;
+}
+
+void TofRecovery::start(TofRecoveryIo& io, uint32_t now_us)
+{
+  if (active()) return;
+  io.xshut(false);
+  st_.started++;
+  t_start_us_ = now_us;
+  backoff_us_ = BACKOFF_US;
+  enter_(TofRecState::RESET, now_us);
+}
+
+void TofRecovery::give_()
+{
+  if (token_) token_->give(this);
+}
+
+// Held in reset until the next attempt (quiet on the bus, and a clean
+// power-on when it comes)
+void TofRecovery::fail_(TofRecoveryIo& io, uint32_t now_us)
+{
+  io.xshut(false);
+  give_();
+  st_.failed_attempts++;
+  enter_(TofRecState::BACKOFF, now_us);
+}
+
+bool TofRecovery::step(TofRecoveryIo& io, uint32_t now_us)
+{
+  const uint32_t in_state = now_us - t_state_us_;
+
+  switch (state_) {
+    case TofRecState::IDLE:
+      return false;
+
+    case TofRecState::RESET:
+      if (in_state < RESET_HOLD_US) return false;
+      // Out of reset it answers on 0x29: nobody else may be there
+      if (token_ && !token_->take(this)) {
+        st_.waits++;
+        return false;
+      }
+      if (!io.peer_clear()) {
+        give_();
+        st_.waits++;
+        return false;
+      }
+      io.xshut(true);
+      boot_tries_ = 0;
+      enter_(TofRecState::BOOT, now_us);
+      return false;
+
+    case TofRecState::BOOT:
+      if (in_state < BOOT_US) return false;
+      if (!io.boot_and_address()) {
+        st_.boot_polls++;
+        if (++boot_tries_ >= BOOT_TRIES) fail_(io, now_us);
+        return false;
+      }
+      give_();   // on its own address: 0x29 is free again
+      enter_(TofRecState::INIT, now_us);
+      return false;
+
+    case TofRecState::INIT:
+      if (io.data_init()) enter_(TofRecState::CONFIG, now_us);
+      else fail_(io, now_us);
+      return false;
+
+    case TofRecState::CONFIG: {
+      if (!io.configure()) {
+        fail_(io, now_us);
+        return false;
+      }
+      const uint32_t took = now_us - t_start_us_;
+      st_.recovered++;
+      st_.last_us = took;
+      if (took > st_.max_us) st_.max_us = took;
+      enter_(TofRecState::IDLE, now_us);
+      return true;
+    }
+
+    case TofRecState::BACKOFF:
+      if (in_state < backoff_us_) return false;
+      backoff_us_ = (backoff_us_ * 2 > BACKOFF_MAX_US) ? BACKOFF_MAX_US : backoff_us_ * 2;
+      enter_(TofRecState::RESET, now_us);   // XSHUT already low
+      return false;
+  }
+  return false;
+}
+
+const char* tof_rec_state_name(TofRecState s)
+{
+  switch (s) {
+    case TofRecState::IDLE: return "idle";
+    case TofRecState::RESET: return "reset";
+    case TofRecState::BOOT: return "boot";
+    case TofRecState::INIT: return "init";
+    case TofRecState::CONFIG: return "config";
+    case TofRecState::BACKOFF: return "backoff";
+  }
+  return "?";
+}
@@ -0,0 +1,120 @@
+#pragma once
+#include <stdint.h>
+
+// Brings a stuck VL53L3 back without blocking the slow group: XSHUT low,
+// XSHUT high, wait for it to answer on the default address, move it to
+// its own address, DataInit, reapply the profile. One step per call (one
+// call per slow tick), each step a bounded I2C exchange, no delays.
+//
+//   IDLE -start-> RESET (XSHUT low, RESET_HOLD_US; then wait for the token
+//                        and for the other sensor to be off 0x29)
+//        -> BOOT (XSHUT high; poll for the default address, BOOT_TRIES calls)
+//        -> INIT (DataInit) -> CONFIG (profile, rules) -> IDLE (recovered)
+//   any failure -> BACKOFF (XSHUT held low) -> RESET, backoff doubling
+//
+// Both sensors come back from reset at the default 0x29, so neither may
+// live there while the other one recovers (pins.h). Two rules keep them
+// apart:
+//   - a TofRecoveryToken shared by both: only its holder may raise XSHUT,
+//     and it keeps it until its sensor is on its own address (or back in
+//     reset)
+//   - before raising XSHUT, peer_clear(): the other sensor is held in
+//     reset or answers on its own address (a brown-out can put it back
+//     on 0x29 without anyone recovering it)
+//
+// No Arduino dependencies (host test: test/tof_recovery_test.cpp).
+
+// What the state machine drives (TofVl53L3; a fake on the host)
+class TofRecoveryIo {
+ public:
+  virtual ~TofRecoveryIo() {}
+  virtual void xshut(bool high) = 0;
+  // Sensor answers on the default address: take it to its own. False while
+  // it hasn't booted yet.
+  virtual bool boot_and_address() = 0;
+  virtual bool data_init() = 0;
+  // Profile and target rules back on; ranging restarts on the next kick
+  virtual bool configure() = 0;
+  // The other sensor can't answer on the default address: held in reset,
+  // or confirmed on its own. May put it into reset to get there. True
+  // when there is no other sensor.
+  virtual bool peer_clear() { return true; }
+};
+
+// Who may have a sensor out of reset and not yet on its own address.
+// Owned by whoever owns both sensors (Sensors); every recovery step runs
+// on the I2C bus task, so no locking.
+class TofRecoveryToken {
+ public:
+  bool take(const void* who)
+  {
+    if (owner_ && owner_ != who) return false;
+    owner_ = who;
+    return true;
+  }
+  void give(const void* who)
+  {
+    if (owner_ == who) owner_ = nullptr;
+  }
+  const void* owner() const { return owner_; }
+
+ private:
+  const void* owner_ = nullptr;
+};
+
+enum class TofRecState : uint8_t {
+  IDLE = 0,
+  RESET,
+  BOOT,
+  INIT,
+  CONFIG,
+  BACKOFF,
+};
+
+struct TofRecoveryStats {
+  uint32_t started = 0;
+  uint32_t recovered = 0;
+  uint32_t failed_attempts = 0;   // attempts that ended in BACKOFF
+  uint32_t boot_polls = 0;        // BOOT calls that found nothing yet
+  uint32_t waits = 0;             // RESET calls held back (token taken, other sensor on 0x29)
+  uint32_t last_us = 0;           // start -> recovered
+  uint32_t max_us = 0;
+};
+
+class TofRecovery {
+ public:
+  static constexpr uint32_t RESET_HOLD_US = 10000;     // XSHUT low at least this long
+  static constexpr uint32_t BOOT_US = 2000;            // tBOOT is 1.2 ms
+  static constexpr uint8_t BOOT_TRIES = 4;             // calls polling for the boot
+  static constexpr uint32_t BACKOFF_US = 1000000;      // first retry after 1 s ...
+  static constexpr uint32_t BACKOFF_MAX_US = 8000000;  // ... doubling up to 8 s
+
+  // Shared with the other sensor's recovery (nullptr: alone on the bus)
+  void set_token(TofRecoveryToken* t) { token_ = t; }
+
+  // Puts the sensor in reset; step() takes it from there
+  void start(TofRecoveryIo& io, uint32_t now_us);
+
+  // One step. True on the call that completes the recovery.
+  bool step(TofRecoveryIo& io, uint32_t now_us);
+
+  bool active() const { return state_ != TofRecState::IDLE; }
+  TofRecState state() const { return state_; }
+  uint32_t backoff_us() const { return backoff_us_; }
+  const TofRecoveryStats& stats() const { return st_; }
+
+ private:
+  void enter_(TofRecState s, uint32_t now_us);
+  void fail_(TofRecoveryIo& io, uint32_t now_us);
+  void give_();
+
+  TofRecState state_ = TofRecState::IDLE;
+  uint32_t t_state_us_ = 0;
+  uint32_t t_start_us_ = 0;
+  uint32_t backoff_us_ = BACKOFF_US;
+  uint8_t boot_tries_ = 0;
+  TofRecoveryToken* token_ = nullptr;
+  TofRecoveryStats st_;
+};
+
+const char* tof_rec_state_name(TofRecState s);
@@ -0,0 +1,116 @@
+#include "tof_stagger.h"
+
+TofStagger::TofStagger(int sensors, uint32_t stuck_us)
+    : n_(sensors < 1 ? 1 : (sensors > MAX_SENSORS ? MAX_SENSORS : sensors)),
+      stuck_us_(stuck_us)
+{
+}
+
+void TofStagger::enable(int i, bool on)
+{
+  if (!ok_(i)) return;
+  ch_[i].enabled = on;
+  if (!on) ch_[i].ranging = false;
+}
+
+void TofStagger::set_slots(int i, uint8_t slots)
+{
+  if (!ok_(i)) return;
+  ch_[i].slots = slots < 1 ? 1 : (slots > MAX_SLOTS ? MAX_SLOTS : slots);
+}
+
+int TofStagger::tick(uint32_t now_us, bool& kick)
+{
+  kick = false;
+
+  // Owner's range still has slots to run in
+  if (hold_ > 0 && owner_ >= 0 && ch_[owner_].enabled) {
+    hold_--;
+    return owner_;
+  }
+
+  // Next enabled sensor after the previous owner
+  int owner = -1;
+  for (int k = 1; k <= n_; k++) {
+    const int i = (owner_ + k + n_) % n_;
+    if (ch_[i].enabled) {
+      owner = i;
+      break;
+    }
+  }
+  owner_ = owner;
+  hold_ = 0;
+  if (owner < 0) return -1;
+
+  Channel& c = ch_[owner];
+  if (c.ranging && (uint32_t)(now_us - c.kick_us) >= stuck_us_) {
+    c.st.timeouts++;
+    c.ranging = false;
+  }
+  if (c.ranging) {
+    c.st.slot_missed++;
+    return owner;
+  }
+  kick = true;
+  hold_ = (uint8_t)(c.slots - 1);
+  return owner;
+}
+
+void TofStagger::kicked(int i, uint32_t t_us)
+{
+  if (!ok_(i)) return;
+  Channel& c = ch_[i];
+  c.ranging = true;
+  c.kick_us = t_us;
+  c.st.kicks++;
+}
+
+// Did another sensor range somewhere in (a, b)?
+bool TofStagger::overlaps_(int i, uint32_t a_us, uint32_t b_us) const
+{
+  for (int j = 0; j < n_; j++) {
+    if (j == i || !ch_[j].enabled) continue;
+    const Channel& o = ch_[j];
+    if (!o.ranging && !(o.st.results > 0 && o.st.kicks > 0)) continue;
+    // Its window: [kick, ready], or [kick, now) while still ranging
+    const uint32_t end = o.ranging ? b_us : o.st.last_ready_us;
+    if ((int32_t)(o.kick_us - b_us) < 0 && (int32_t)(end - a_us) > 0) return true;
+  }
+  return false;
+}
+
+void TofChannelStats::add_result(uint32_t t_ready_us, uint32_t t_fetch_us)
+{
+  if (chained) {
+    const uint32_t dt = t_ready_us - last_ready_us;
+    last_interval_us = dt;
+    if (avg_interval_us <= 0) avg_interval_us = (float)dt;
+    else avg_interval_us += ((float)dt - avg_interval_us) * 0.125f;
+  }
+
+  const uint32_t lat = t_fetch_us - t_ready_us;
+  last_lat_us = lat;
+  sum_lat_us += lat;
+  if (lat > max_lat_us) max_lat_us = lat;
+
+  results++;
+  last_ready_us = t_ready_us;
+  chained = true;
+}
+
+void TofStagger::fetched(int i, uint32_t t_ready_us, uint32_t t_fetch_us)
+{
+  if (!ok_(i)) return;
+  Channel& c = ch_[i];
+  TofChannelStats& st = c.st;
+
+  if (c.ranging) {
+    const uint32_t r = t_ready_us - c.kick_us;
+    st.last_range_us = r;
+    if (r > st.max_range_us) st.max_range_us = r;
+    if (overlaps_(i, c.kick_us, t_ready_us)) st.overlaps++;
+  }
+
+  st.add_result(t_ready_us, t_fetch_us);
+  c.ranging = false;
+}
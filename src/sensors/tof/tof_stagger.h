@@ -0,0 +1,94 @@
+#pragma once
+#include <stdint.h>
+
+// Time-slot plan for the VL53L3s sharing the I2C bus (and, through
+// reflections, each other's IR). The slow group ticks once per slot and
+// each tick belongs to one sensor in turn. At the start of its slot that
+// sensor's finished result is fetched and its next range kicked; with the
+// timing budget under one slot no two sensors range at the same time and
+// every tick carries about the same I2C traffic:
+//
+//   tick:  0           1                    2                    3
+//          kick down   fetch down,          fetch front,         fetch down,
+//                      kick front           kick down            kick front
+//
+// Each sensor ranges at 1 / (sensors * slot) and a result waits at most
+// slot - range time to be fetched. A sensor that is disabled (failed
+// begin()) gives its slots away, so the other one runs every tick.
+//
+// A slot whose owner is still ranging is skipped (no kick on top of a
+// running range); a range with no result after stuck_us is given up and
+// kicked again. A sensor on a longer timing budget can hold several slots
+// in a row (set_slots()); the other sensor's rate drops with it.
+//
+// Times are micros() values (wrap-safe). No Arduino dependencies (host
+// test: test/tof_stagger_test.cpp).
+
+struct TofChannelStats {
+  uint32_t kicks = 0;
+  uint32_t results = 0;
+  uint32_t slot_missed = 0;        // slot came round with the range still running
+  uint32_t timeouts = 0;           // no result within stuck_us: kicked again
+  uint32_t overlaps = 0;           // ranged while another sensor was ranging
+  uint32_t last_interval_us = 0;   // result -> result
+  float avg_interval_us = 0;       // EWMA, 1/8
+  uint32_t last_range_us = 0;      // kick -> result ready (budget + overhead)
+  uint32_t max_range_us = 0;
+  uint32_t last_lat_us = 0;        // result ready -> fetched
+  uint32_t max_lat_us = 0;
+  uint64_t sum_lat_us = 0;
+  uint32_t last_ready_us = 0;
+  bool chained = false;            // last_ready_us starts the next interval
+
+  float rate_hz() const { return avg_interval_us > 0 ? 1e6f / avg_interval_us : 0; }
+  uint32_t avg_lat_us() const { return results ? (uint32_t)(sum_lat_us / results) : 0; }
+
+  // Counts a result: interval, fetch latency
+  void add_result(uint32_t t_ready_us, uint32_t t_fetch_us);
+  // Next result starts a new run (no interval back to the last one)
+  void break_chain() { chained = false; }
+};
+
+class TofStagger {
+ public:
+  static constexpr int MAX_SENSORS = 2;
+  static constexpr uint8_t MAX_SLOTS = 4;
+
+  TofStagger(int sensors, uint32_t stuck_us);
+
+  void enable(int i, bool on);
+  bool enabled(int i) const { return ok_(i) && ch_[i].enabled; }
+  // Consecutive slots per turn (1..MAX_SLOTS); takes effect next turn
+  void set_slots(int i, uint8_t slots);
+  uint8_t slots(int i) const { return ok_(i) ? ch_[i].slots : 0; }
+
+  // Once per slow tick, after the fetches: whose slot this is (-1 if no
+  // sensor is enabled) and whether to kick it.
+  int tick(uint32_t now_us, bool& kick);
+
+  void kicked(int i, uint32_t t_us);
+  // A result that became ready at t_ready_us (the GPIO1 edge) was read at
+  // t_fetch_us
+  void fetched(int i, uint32_t t_ready_us, uint32_t t_fetch_us);
+
+  bool ranging(int i) const { return ok_(i) && ch_[i].ranging; }
+  const TofChannelStats& stats(int i) const { return ch_[ok_(i) ? i : 0].st; }
+
+ private:
+  struct Channel {
+    bool enabled = true;
+    bool ranging = false;     // kicked, result not fetched yet
+    uint8_t slots = 1;
+    uint32_t kick_us = 0;
+    TofChannelStats st;
+  };
+
+  bool ok_(int i) const { return i >= 0 && i < n_; }
+  bool overlaps_(int i, uint32_t a_us, uint32_t b_us) const;
+
+  int n_;
+  uint32_t stuck_us_;
+  int owner_ = -1;
+  uint8_t hold_ = 0;          // owner's slots left this turn
+  Channel ch_[MAX_SENSORS];
+};
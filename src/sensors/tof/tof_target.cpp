@@ -0,0 +1,70 @@
+#include "tof_target.h"
+
+int tof_select_target(TofTarget* t, int n, const TofTargetRules& r)
+{
+  if (n > TOF_MAX_TARGETS) n = TOF_MAX_TARGETS;
+
+  // Per-object checks
+  for (int i = 0; i < n; i++) {
+    TofTarget& o = t[i];
+    if (o.status != 0) o.reject = TofTargetReject::STATUS;
+    else if (o.range_mm < r.min_mm) o.reject = TofTargetReject::GLASS;
+    else if (o.range_mm > r.max_mm) o.reject = TofTargetReject::FAR;
+    else if (o.signal_mcps < r.min_signal_mcps) o.reject = TofTargetReject::WEAK;
+    else if (o.sigma_mm > r.max_sigma_mm) o.reject = TofTargetReject::SIGMA;
+    else o.reject = TofTargetReject::NONE;
+  }
+
+  // Blades: something real further out shows through them
+  if (r.prop_max_mm > r.prop_min_mm) {
+    for (int i = 0; i < n; i++) {
+      TofTarget& o = t[i];
+      if (o.reject != TofTargetReject::NONE) continue;
+      if (o.range_mm < r.prop_min_mm || o.range_mm > r.prop_max_mm) continue;
+      for (int j = 0; j < n; j++) {
+        if (t[j].reject == TofTargetReject::NONE && t[j].range_mm > r.prop_max_mm) {
+          o.reject = TofTargetReject::PROP;
+          break;
+        }
+      }
+    }
+  }
+
+  // Echoes of a stronger, nearer survivor
+  for (int i = 0; i < n; i++) {
+    TofTarget& o = t[i];
+    if (o.reject != TofTargetReject::NONE) continue;
+    for (int j = 0; j < n; j++) {
+      const TofTarget& s = t[j];
+      if (j == i || s.reject != TofTargetReject::NONE) continue;
+      if (s.range_mm >= o.range_mm || s.signal_mcps <= o.signal_mcps) continue;
+      const float d = (float)o.range_mm - 2.0f * s.range_mm;
+      if (d < r.echo_tol * s.range_mm && -d < r.echo_tol * s.range_mm) {
+        o.reject = TofTargetReject::ECHO;
+        break;
+      }
+    }
+  }
+
+  int best = -1;
+  for (int i = 0; i < n; i++) {
+    if (t[i].reject != TofTargetReject::NONE) continue;
+    if (best < 0 || t[i].range_mm < t[best].range_mm) best = i;
+  }
+  return best;
+}
+
+const char* tof_target_reject_name(TofTargetReject r)
+{
+  switch (r) {
+    case TofTargetReject::NONE: return "none";
+    case TofTargetReject::STATUS: return "status";
+    case TofTargetReject::GLASS: return "glass";
+    case TofTargetReject::FAR: return "far";
+    case TofTargetReject::WEAK: return "weak";
+    case TofTargetReject::SIGMA: return "sigma";
+    case TofTargetReject::PROP: return "prop";
+    case TofTargetReject::ECHO: return "echo";
+  }
+  return "?";
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <stdint.h>
+
+// Picks the real surface out of the VL53L3's multi-target histogram result.
+//
+// One range returns up to four objects (nearest first). Besides the floor
+// or the obstacle we want, they can be:
+//  - cover glass / dust on it: a return a few mm out (GLASS)
+//  - prop blades cutting the cone: short, intermittent, weaker than what's
+//    behind them (PROP, only if a target lies beyond)
+//  - the floor echo: near the ground the floor return bounces off the
+//    underside of the craft and comes back as a second, weaker target at
+//    about twice the range (ECHO)
+//  - noise: weak or wide-sigma detections (WEAK, SIGMA)
+// Each object gets a verdict; the nearest survivor is the measurement.
+//
+// No Arduino dependencies (host test: test/tof_target_test.cpp).
+
+static constexpr int TOF_MAX_TARGETS = 4;   // VL53LX_MAX_RANGE_RESULTS
+
+enum class TofTargetReject : uint8_t {
+  NONE = 0,
+  STATUS,       // RangeStatus != 0
+  GLASS,        // closer than min_mm
+  FAR,          // beyond max_mm
+  WEAK,         // signal under min_signal_mcps
+  SIGMA,        // sigma over max_sigma_mm
+  PROP,         // in the prop band with a farther target behind it
+  ECHO,         // ~2x a stronger nearer target
+};
+static constexpr int TOF_TARGET_REJECT_COUNT = 8;
+
+struct TofTarget {
+  uint16_t range_mm = 0;
+  uint16_t min_mm = 0, max_mm = 0;   // extent of the return
+  uint8_t status = 0;                // VL53LX RangeStatus
+  float sigma_mm = 0;
+  float signal_mcps = 0;             // return signal rate
+  float ambient_mcps = 0;
+  TofTargetReject reject = TofTargetReject::NONE;
+};
+
+struct TofTargetRules {
+  uint16_t min_mm;            // glass / near field
+  uint16_t max_mm;
+  float min_signal_mcps;
+  float max_sigma_mm;
+  uint16_t prop_min_mm;       // band where blades show up (0, 0 = none)
+  uint16_t prop_max_mm;
+  float echo_tol;             // ECHO if |r - 2 r_near| < echo_tol * r_near
+};
+
+// Sets every target's reject; returns the index of the selected one, or -1
+int tof_select_target(TofTarget* t, int n, const TofTargetRules& rules);
+
+const char* tof_target_reject_name(TofTargetReject r);
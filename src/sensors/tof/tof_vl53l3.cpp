@@ -1,5 +1,6 @@
 #include "tof_vl53l3.h"
 #include <cstring>
+#include <new>
 
 bool TofVl53L3::probe_(TwoWire& w, uint8_t addr7) {
   w.beginTransmission(addr7);
@@ -10,9 +11,48 @@ TofVl53L3::~TofVl53L3() {
   end();
 }
 
+void IRAM_ATTR TofVl53L3::gpio1_isr_(void* arg) {
+  TofVl53L3* self = static_cast<TofVl53L3*>(arg);
+  const uint32_t t = micros();
+  self->irq_seq_ = self->irq_seq_ + 1;   // odd: writing
+  spsc_fence();
+  self->irq_us_ = t;
+  spsc_fence();
+  self->irq_seq_ = self->irq_seq_ + 1;
+  if (self->drdy_fn_) self->drdy_fn_(self->drdy_ctx_);
+}
+
+void TofVl53L3::onDataReady(DataReadyFn fn, void* ctx) {
+  drdy_ctx_ = ctx;
+  drdy_fn_ = fn;
+}
+
+// Edge count and time of the same edge; false if the ISR kept
+// interfering (then this read sees no new edge, the next one will)
+bool TofVl53L3::edge_(uint32_t& edges, uint32_t& t_us) const {
+  for (int tries = 0; tries < 4; tries++) {
+    const uint32_t s0 = irq_seq_;
+    if (s0 & 1) continue;
+    spsc_fence();
+    const uint32_t t = irq_us_;
+    spsc_fence();
+    if (irq_seq_ == s0) {
+      edges = s0 / 2;
+      t_us = t;
+      return true;
+    }
+  }
+  return false;
+}
+
 void TofVl53L3::end() {
+  if (irq_ok_) {
+    detachInterrupt(digitalPinToInterrupt(pins_.gpio1));
+    irq_ok_ = false;
+  }
+
   if (dev_) {
-    delete dev_;
+    dev_->~VL53LX();
     dev_ = nullptr;
   }
 
@@ -22,39 +62,125 @@ void TofVl53L3::end() {
   }
 }
 
+void TofVl53L3::new_dev_() {
+  if (dev_) dev_->~VL53LX();
+  dev_ = new (dev_mem_) VL53LX(wire_, pins_.xshut);
+}
+
+// Same steps as the recovery, waited out back to back (boot only)
 bool TofVl53L3::begin(TofPins pins, uint8_t addr8_init, uint8_t addr7_expected) {
   pins_ = pins;
   addr8_ = addr8_init;
   addr7_ = addr7_expected;
 
-  // Release from reset
   pinMode(pins_.xshut, OUTPUT);
-  digitalWrite(pins_.xshut, HIGH);
-  delay(50);
-
-  // Recreate device on heap (avoid stack temporaries)
-  if (dev_) {
-    delete dev_;
-    dev_ = nullptr;
+  xshut(false);
+  delay(TofRecovery::RESET_HOLD_US / 1000);
+  xshut(true);
+
+  // Answers on the default address once booted; moved to its own
+  bool up = false;
+  for (int i = 0; i < 25 && !up; i++) {
+    delay(2);
+    up = boot_and_address();
   }
-  dev_ = new VL53LX(wire_, pins_.xshut);
-  if (!dev_) return false;
+  if (!up || !data_init()) return false;
+
+#if TOF_GPIO1_IRQ
+  // GPIO1 idles high and drops when a result is ready; the next
+  // ClearInterruptAndStartMeasurement() releases it.
+  if (pins_.gpio1 >= 0 && !irq_ok_) {
+    pinMode(pins_.gpio1, INPUT);
+    attachInterruptArg(digitalPinToInterrupt(pins_.gpio1), gpio1_isr_, this, FALLING);
+    irq_ok_ = true;
+  }
+#endif
+  return true;
+}
 
-  // InitSensor uses 8-bit address in this stack
-  // If your local InitSensor() returns void, remove the ret-check and rely on probe.
-  int ret = dev_->InitSensor(addr8_);
-  if (ret != 0) return false;
+void TofVl53L3::xshut(bool high) {
+  if (pins_.xshut >= 0) digitalWrite(pins_.xshut, high ? HIGH : LOW);
+  in_reset_ = !high && pins_.xshut >= 0;
+  if (!high) {
+    // Everything the sensor knew is gone
+    ranging_started_ = false;
+    wait_kick_ = false;
+  }
+}
 
-  delay(10);
+bool TofVl53L3::boot_and_address() {
+  if (!probe_(*wire_, TOF_ADDR7_DEFAULT)) return false;   // not up yet
 
-  // Verify it responds on expected 7-bit address
+  // Fresh driver state: it talks to the default address
+  new_dev_();
+  if (dev_->VL53LX_SetDeviceAddress(addr8_) != 0) return false;
+  if (dev_->VL53LX_WaitDeviceBooted() != 0) return false;
   return probe_(*wire_, addr7_);
 }
 
+bool TofVl53L3::data_init() {
+  return dev_ && dev_->VL53LX_DataInit() == 0;
+}
+
+bool TofVl53L3::configure() {
+  ranging_started_ = false;
+  wait_kick_ = false;
+  stopped_ = true;
+  last_fresh_us_ = micros();
+  return !profile_ || apply_profile_(*profile_);
+}
+
+void TofVl53L3::share_recovery(TofVl53L3& peer, TofRecoveryToken& token) {
+  peer_ = &peer;
+  recovery_.set_token(&token);
+}
+
+bool TofVl53L3::peer_clear() {
+  return !peer_ || peer_->off_default_();
+}
+
+// Asked by the other sensor's recovery before it raises its XSHUT
+bool TofVl53L3::off_default_() {
+  if (in_reset_ || probe_(*wire_, addr7_)) return true;
+  // Up but not on its own address: back at 0x29 after a brown-out, or
+  // hung. Into reset with it (already recovering: its next step fails and
+  // backs off); its own recovery brings it back in turn.
+  xshut(false);
+  recovery_.start(*this, micros());
+  return true;
+}
+
 bool TofVl53L3::present() const {
   return probe_(*wire_, addr7_);
 }
 
+bool TofVl53L3::set_profile(const TofProfile& p)
+{
+  if (!dev_) return false;
+
+  // Mid-recovery: configure() applies it
+  if (recovery_.active()) {
+    profile_ = &p;
+    return true;
+  }
+  return apply_profile_(p);
+}
+
+bool TofVl53L3::apply_profile_(const TofProfile& p)
+{
+  // Mode and budget only change while stopped
+  if (ranging_started_) {
+    dev_->VL53LX_StopMeasurement();
+    ranging_started_ = false;
+    stopped_ = true;
+  }
+  const bool ok =
+      dev_->VL53LX_SetDistanceMode((VL53LX_DistanceModes)p.mode) == 0 &&
+      dev_->VL53LX_SetMeasurementTimingBudgetMicroSeconds(p.budget_us) == 0;
+  if (ok) profile_ = &p;
+  return ok;
+}
+
 bool TofVl53L3::start_ranging()
 {
   if (!dev_) return false;
@@ -62,21 +188,81 @@ bool TofVl53L3::start_ranging()
   // This is the common pattern in ST VL53LX wrappers:
   // - clear any pending interrupt
   // - start measurement
-  dev_->VL53LX_ClearInterruptAndStartMeasurement();
+  // After a StopMeasurement() it takes a full start.
+  if (stopped_) {
+    dev_->VL53LX_StartMeasurement();
+    stopped_ = false;
+  } else {
+    dev_->VL53LX_ClearInterruptAndStartMeasurement();
+  }
   ranging_started_ = true;
+  wait_kick_ = false;
   last_fresh_us_ = micros();
+  uint32_t t;
+  edge_(last_edge_, t);
+  return true;
+}
+
+bool TofVl53L3::kick()
+{
+  if (!dev_ || recovery_.active()) return false;
+  if (!ranging_started_) return start_ranging();
+  dev_->VL53LX_ClearInterruptAndStartMeasurement();
+  wait_kick_ = false;
   return true;
 }
 
-bool TofVl53L3::read(TofSample& out)
+// Whether a result is waiting. With GPIO1 the pin says so without touching
+// I2C; the data-ready poll is only the fallback for a pin that has gone
+// quiet (missed edge on a level that was already low, broken pull-up).
+bool TofVl53L3::data_ready_(uint32_t now, bool& fresh_edge, uint32_t& edge_us)
+{
+  static constexpr uint32_t POLL_FALLBACK_US = 200000; // 200 ms, under HOLD_US
+
+  fresh_edge = false;
+  if (wait_kick_) return false;   // result already taken, GPIO1 still low until kick()
+  if (irq_ok_) {
+    uint32_t edges = last_edge_;
+    if (!edge_(edges, edge_us)) edges = last_edge_;
+    const bool new_edge = (edges != last_edge_);
+    last_edge_ = edges;
+    irq_.edges = edges;
+
+    if (digitalRead(pins_.gpio1) == LOW) {
+      if (new_edge) {
+        const uint32_t lat = micros() - edge_us;
+        fresh_edge = true;
+        irq_.irq_reads++;
+        irq_.sum_lat_us += lat;
+        irq_.last_lat_us = lat;
+        if (lat > irq_.max_lat_us) irq_.max_lat_us = lat;
+      } else {
+        irq_.level_reads++;
+      }
+      return true;
+    }
+
+    if ((now - last_fresh_us_) < POLL_FALLBACK_US) {
+      irq_.idle++;
+      return false;
+    }
+    irq_.polls++;
+  }
+
+  uint8_t ready = 0;
+  const int ret = dev_->VL53LX_GetMeasurementDataReady(&ready);
+  if (ret != 0 || ready == 0) return false;
+  if (irq_ok_) irq_.polled_reads++;
+  return true;
+}
+
+bool TofVl53L3::read(TofSample& out, bool rearm)
 {
   // Explicit invalid defaults (so callers never see "random" fields)
   out = TofSample{};
   out.t_us = micros();
 
   static constexpr uint32_t HOLD_US = 300000; // 300 ms
-  static constexpr uint16_t MIN_MM  = 20;
-  static constexpr uint16_t MAX_MM  = 4000;
 
   static constexpr uint16_t INVALID_U16 = 0xFFFF;
   static constexpr uint8_t  INVALID_U8  = 0xFF;
@@ -111,62 +297,85 @@ bool TofVl53L3::read(TofSample& out)
     return true;
   };
 
+  // Recovering: one step per read, last-good served meanwhile
+  if (recovery_.active()) {
+    if (recovery_.step(*this, out.t_us) && rearm) start_ranging();
+    return use_last_good();
+  }
+
   if (!dev_ || !ranging_started_) {
     set_invalid();
     return false;
   }
 
-  // Non-blocking ready check
-  uint8_t ready = 0;
-  int ret = dev_->VL53LX_GetMeasurementDataReady(&ready);
+  // Non-blocking ready check (GPIO1, or an I2C poll)
+  bool fresh_edge = false;
+  uint32_t edge_us = 0;
   static constexpr uint32_t STUCK_US = 400000; // 400 ms
-  if (ready == 0) {
-    // If we haven't seen a fresh frame for a while, re-kick
+  if (!data_ready_(out.t_us, fresh_edge, edge_us)) {
+    // Ranging but nothing for a while (a re-kick didn't help either):
+    // reset and re-init over the next ticks
     const uint32_t now = out.t_us;
-    if (last_fresh_us_ != 0 && (now - last_fresh_us_) > STUCK_US) {
-      //dev_->VL53LX_StartMeasurement();
-      last_fresh_us_ = now; // prevent rapid re-kicks
-      //Serial.print("ready="); Serial.print(ready); Serial.print(" ret=");Serial.println(ret);
+    if (!wait_kick_ && last_fresh_us_ != 0 && (now - last_fresh_us_) > STUCK_US) {
+      recovery_.start(*this, now);
     }
     return use_last_good();
   }
-  if (ret != 0) {
-    return use_last_good();
-  }
+
+  // The edge is when the result landed, not when this tick got to it
+  if (fresh_edge) out.t_us = edge_us;
 
   // Read multi-ranging data
   VL53LX_MultiRangingData_t data;
   std::memset(&data, 0, sizeof(data));
 
-  ret = dev_->VL53LX_GetMultiRangingData(&data);
+  int ret = dev_->VL53LX_GetMultiRangingData(&data);
   last_fresh_us_ = out.t_us;
   if (ret != 0) {
     return use_last_good();
   }
-
-  // Populate from first object
-  const auto& r0 = data.RangeData[0];
-
-  out.range_mm     = r0.RangeMilliMeter;
-  out.range_status = r0.RangeStatus;
+  out.fresh = true;
+
+  // Every object the histogram returned, judged by the target rules
+  out.n_targets = data.NumberOfObjectsFound < TOF_MAX_TARGETS ? data.NumberOfObjectsFound
+                                                              : TOF_MAX_TARGETS;
+  for (int i = 0; i < out.n_targets; i++) {
+    const auto& r = data.RangeData[i];
+    TofTarget& t = out.targets[i];
+    t.range_mm = r.RangeMilliMeter > 0 ? (uint16_t)r.RangeMilliMeter : 0;
+    t.min_mm = r.RangeMinMilliMeter > 0 ? (uint16_t)r.RangeMinMilliMeter : 0;
+    t.max_mm = r.RangeMaxMilliMeter > 0 ? (uint16_t)r.RangeMaxMilliMeter : 0;
+    t.status = r.RangeStatus;
+    t.sigma_mm = fix1616_(r.SigmaMilliMeter);
+    t.signal_mcps = fix1616_(r.SignalRateRtnMegaCps);
+    t.ambient_mcps = fix1616_(r.AmbientRateRtnMegaCps);
+  }
+  out.target = (int8_t)tof_select_target(out.targets, out.n_targets, rules_);
   out.stream_count = data.StreamCount;
 
-  out.ambient = r0.AmbientRateRtnMegaCps;
-  out.signal  = r0.SignalRateRtnMegaCps;
-
-  // Re-arm for next measurement ASAP
-  dev_->VL53LX_ClearInterruptAndStartMeasurement();
-
-  // Validity gating
-  const bool sane_range =
-      (out.range_mm != 8191) &&
-      (out.range_mm >= MIN_MM) &&
-      (out.range_mm <= MAX_MM);
-
-  const bool ok_status = (out.range_status == 0);
+  tgt_.results++;
+  if (out.n_targets > 1) tgt_.multi++;
+  if (out.target < 0) tgt_.none++;
+  for (int i = 0; i < out.n_targets; i++) tgt_.rejected[(int)out.targets[i].reject]++;
+
+  // Re-arm for next measurement ASAP (or in this sensor's next slot)
+  if (rearm) dev_->VL53LX_ClearInterruptAndStartMeasurement();
+  else wait_kick_ = true;
+
+  // Selected target is the measurement
+  if (out.target >= 0) {
+    const TofTarget& t = out.targets[out.target];
+    out.range_mm = t.range_mm;
+    out.range_status = t.status;
+    out.signal = kcps_(t.signal_mcps);
+    out.ambient = kcps_(t.ambient_mcps);
+  } else if (out.n_targets > 0) {
+    out.range_status = out.targets[0].status;
+  }
 
-  out.valid = ok_status && sane_range;
+  out.valid = (out.target >= 0);
   out.stale = false;
+  last_result_ = out;
 
   if (out.valid) {
     // Save full last-good packet
@@ -5,6 +5,19 @@
 #include <stdint.h>
 #include <vl53lx_class.h>
 
+#include "tof_profile.h"
+#include "tof_recovery.h"
+#include "tof_target.h"
+#include "utils/spsc.h"
+
+// TOF_GPIO1_IRQ=1: GPIO1 (active-low data ready) is an interrupt; read()
+// only touches I2C when a result is waiting and stamps it with the edge.
+// onDataReady() lets the edge itself queue the read.
+// 0: poll VL53LX_GetMeasurementDataReady every read (the old behaviour).
+#ifndef TOF_GPIO1_IRQ
+#define TOF_GPIO1_IRQ 1
+#endif
+
 struct TofPins {
   int xshut = -1;
   int gpio1 = -1;
@@ -18,38 +31,139 @@ struct TofSample {
 
   bool valid = false;
   bool stale = false;
+  bool fresh = false;     // a result was fetched by this read (any status)
 
-  uint16_t range_mm = 0;
+  uint16_t range_mm = 0;     // selected target
   uint8_t range_status = 0;
 
-  uint16_t ambient = 0;
-  uint16_t signal = 0;
+  uint16_t ambient = 0;      // kcps, selected target
+  uint16_t signal = 0;       // kcps
   uint8_t  stream_count = 0;
+
+  // All objects of a fresh result, with their verdicts (tof_target.h)
+  uint8_t n_targets = 0;
+  int8_t target = -1;        // selected index, -1 = none usable
+  TofTarget targets[TOF_MAX_TARGETS];
+};
+
+// Target selection accounting, updated by read()
+struct TofTargetStats {
+  uint32_t results = 0;
+  uint32_t multi = 0;          // more than one object returned
+  uint32_t none = 0;           // no object survived
+  uint32_t rejected[TOF_TARGET_REJECT_COUNT] = {};   // by TofTargetReject
+};
+
+// GPIO1 accounting, updated by read()
+struct TofIrqStats {
+  uint32_t edges = 0;          // falling edges seen by the ISR
+  uint32_t irq_reads = 0;      // results fetched after a fresh edge
+  uint32_t level_reads = 0;    // GPIO1 low without a new edge (edge missed)
+  uint32_t polled_reads = 0;   // found by the I2C fallback poll
+  uint32_t polls = 0;          // I2C data-ready polls (fallback only)
+  uint32_t idle = 0;           // reads that skipped I2C entirely
+  uint32_t max_lat_us = 0;     // edge -> read
+  uint32_t last_lat_us = 0;
+  uint64_t sum_lat_us = 0;
+
+  uint32_t avg_lat_us() const { return irq_reads ? (uint32_t)(sum_lat_us / irq_reads) : 0; }
 };
 
+// Every VL53L3 comes out of reset here
+static constexpr uint8_t TOF_ADDR7_DEFAULT = 0x29;
 
-class TofVl53L3 {
+class TofVl53L3 : private TofRecoveryIo {
 public:
+  // Called from the GPIO1 ISR (keep it short, IRAM)
+  using DataReadyFn = void (*)(void* ctx);
+
   ~TofVl53L3();
 
   bool begin(TofPins pins, uint8_t addr8_init, uint8_t addr7_expected);
   void end();               // optional
   bool present() const;
   uint8_t addr7() const { return addr7_; }
+  // Distance mode + timing budget. Stops a running range; the next kick()
+  // starts ranging with the new settings.
+  bool set_profile(const TofProfile& p);
+  const TofProfile* profile() const { return profile_; }
   bool start_ranging();              // call once after both sensors are up
-  bool read(TofSample& out);         // non-blocking: valid=false if nothing new
+  bool kick();                       // start the next range (rearm=false reads)
+  // Non-blocking: valid=false if nothing new. rearm=false leaves starting
+  // the next range to kick() (TofStagger).
+  bool read(TofSample& out, bool rearm = true);
+
+  void set_target_rules(const TofTargetRules& r) { rules_ = r; }
+  const TofTargetStats& targetStats() const { return tgt_; }
+  const TofSample& lastResult() const { return last_result_; }   // last fresh read
+
+  // Must be set before begin() enables the interrupt to see every edge.
+  void onDataReady(DataReadyFn fn, void* ctx);
+  bool irqEnabled() const { return irq_ok_; }
+  const TofIrqStats& irqStats() const { return irq_; }
+
+  // Stuck-sensor recovery (reset + re-init across slow ticks, tof_recovery.h)
+  const TofRecovery& recovery() const { return recovery_; }
+  // The other sensor on this bus and the token both recoveries share: a
+  // recovery only brings its sensor up while the peer is off 0x29.
+  // Both read() on the same task (the I2C bus task).
+  void share_recovery(TofVl53L3& peer, TofRecoveryToken& token);
 
 private:
   static bool probe_(TwoWire& w, uint8_t addr7);
+  static void gpio1_isr_(void* arg);
+  // Rates/sigma are FixPoint1616_t in the ST driver (float in some ports)
+  static float fix1616_(uint32_t v) { return v * (1.0f / 65536.0f); }
+  static float fix1616_(float v) { return v; }
+  // Saturates below 0xFFFF (= invalid)
+  static uint16_t kcps_(float mcps) { return mcps >= 65.534f ? 0xFFFE : (uint16_t)(mcps * 1000.0f + 0.5f); }
+  bool data_ready_(uint32_t now, bool& fresh_edge, uint32_t& edge_us);
+  bool edge_(uint32_t& edges, uint32_t& t_us) const;
+  void new_dev_();
+  bool apply_profile_(const TofProfile& p);
+  bool off_default_();
+
+  // TofRecoveryIo
+  void xshut(bool high) override;
+  bool boot_and_address() override;
+  bool data_init() override;
+  bool configure() override;
+  bool peer_clear() override;
 
   TwoWire* wire_ = &Wire;
   TofPins pins_;
   uint8_t addr7_ = 0x00;
   uint8_t addr8_ = 0x00;
   bool ranging_started_ = false;
-  uint32_t last_fresh_us_ = 0; // last good reading (used to decide if reset of sensor is necces.)
+  bool wait_kick_ = false;     // fetched with rearm=false, next range not started
+  bool stopped_ = false;       // StopMeasurement()ed / re-inited: needs a full start
+  bool in_reset_ = false;      // XSHUT held low
+  const TofProfile* profile_ = nullptr;
+  uint32_t last_fresh_us_ = 0; // last result (no result for STUCK_US: recovery)
 
+  // The ST driver object lives here, not on the heap; rebuilt in place
+  // whenever the sensor comes back at the default address
   VL53LX* dev_ = nullptr;
+  alignas(VL53LX) unsigned char dev_mem_[sizeof(VL53LX)];
+  TofRecovery recovery_;
+  TofVl53L3* peer_ = nullptr;
+
+  // GPIO1 edge capture (written by the ISR only). irq_seq_ is odd while the
+  // ISR writes and counts two per edge, so the reader, on the other core,
+  // never pairs one edge's count with another's time (edge_()).
+  volatile uint32_t irq_us_ = 0;
+  volatile uint32_t irq_seq_ = 0;
+  DataReadyFn drdy_fn_ = nullptr;
+  void* drdy_ctx_ = nullptr;
+  bool irq_ok_ = false;
+  uint32_t last_edge_ = 0;
+  TofIrqStats irq_;
+
+  // Until set_target_rules(): the old single-target gating (status 0,
+  // 20..4000 mm)
+  TofTargetRules rules_ = {20, 4000, 0.0f, 1e6f, 0, 0, 0.0f};
+  TofTargetStats tgt_;
+  TofSample last_result_;
 
   struct LastGood_ {
     bool has = false;
@@ -0,0 +1,96 @@
+#pragma once
+#include <stdint.h>
+#include <math.h>
+
+// Fixed-size real FFT (float), power spectrum only.
+//
+// N real inputs go through one N/2-point complex radix-2 FFT (even samples
+// as real, odd as imaginary) plus the usual split step, so a 128-point
+// spectrum costs a 64-point complex FFT. Twiddles, bit-reversal and the
+// window table are built once in the constructor; power() allocates
+// nothing and uses ~N floats of scratch in the object.
+//
+// The ESP32-S3 has a single-precision FPU but no float SIMD the compiler
+// can reach, so this is plain scalar C++ (host tested:
+// test/gyro_spectrum_test.cpp, cost: test/gyro_spectrum_bench.cpp).
+template <uint16_t N>
+class RealFft {
+ public:
+  static_assert(N >= 8 && (N & (N - 1)) == 0, "FFT size must be a power of two >= 8");
+  static constexpr uint16_t M = N / 2;        // complex FFT size
+  static constexpr uint16_t BINS = M + 1;     // DC .. Nyquist
+
+  RealFft()
+  {
+    const float PI = 3.14159265358979f;
+    for (uint16_t k = 0; k < M; k++) {
+      cos_[k] = cosf(2.0f * PI * k / N);
+      sin_[k] = sinf(2.0f * PI * k / N);
+    }
+    for (uint16_t n = 0; n < N; n++) win_[n] = 0.5f - 0.5f * cosf(2.0f * PI * n / N);   // Hann
+    uint16_t bits = 0;
+    while ((1u << bits) < M) bits++;
+    for (uint16_t i = 0; i < M; i++) {
+      uint16_t r = 0;
+      for (uint16_t b = 0; b < bits; b++) r |= ((i >> b) & 1u) << (bits - 1 - b);
+      rev_[i] = r;
+    }
+  }
+
+  // p[k] = |X[k]|^2 for k = 0..M of x (mean removed, Hann windowed when
+  // window is set). x is not modified.
+  void power(const float x[N], float p[BINS], bool window = true)
+  {
+    float mean = 0;
+    for (uint16_t n = 0; n < N; n++) mean += x[n];
+    mean /= N;
+
+    // Pack even/odd pairs straight into bit-reversed order
+    for (uint16_t i = 0; i < M; i++) {
+      const uint16_t r = rev_[i];
+      const float w0 = window ? win_[2 * i] : 1.0f;
+      const float w1 = window ? win_[2 * i + 1] : 1.0f;
+      re_[r] = (x[2 * i] - mean) * w0;
+      im_[r] = (x[2 * i + 1] - mean) * w1;
+    }
+
+    // Iterative radix-2 DIT; stage twiddle W_M^j = W_N^(2j)
+    for (uint16_t len = 2; len <= M; len <<= 1) {
+      const uint16_t half = len >> 1;
+      const uint16_t step = (uint16_t)(N / len);   // index into the W_N table
+      for (uint16_t base = 0; base < M; base += len) {
+        for (uint16_t j = 0; j < half; j++) {
+          const float c = cos_[j * step], s = sin_[j * step];
+          const uint16_t a = base + j, b = a + half;
+          const float tr = re_[b] * c + im_[b] * s;    // (re + j im) * (c - j s)
+          const float ti = im_[b] * c - re_[b] * s;
+          re_[b] = re_[a] - tr;
+          im_[b] = im_[a] - ti;
+          re_[a] += tr;
+          im_[a] += ti;
+        }
+      }
+    }
+
+    // Split: X[k] = E[k] + W_N^k O[k], with E/O from Z[k] and conj(Z[M-k])
+    p[0] = (re_[0] + im_[0]) * (re_[0] + im_[0]);
+    p[M] = (re_[0] - im_[0]) * (re_[0] - im_[0]);
+    for (uint16_t k = 1; k < M; k++) {
+      const float zr = re_[k], zi = im_[k];
+      const float cr = re_[M - k], ci = -im_[M - k];
+      const float er = 0.5f * (zr + cr), ei = 0.5f * (zi + ci);
+      const float dr = zr - cr, di = zi - ci;
+      const float or_ = 0.5f * di, oi = -0.5f * dr;     // (Z - conj) / 2j
+      const float c = cos_[k], s = sin_[k];
+      const float xr = er + or_ * c + oi * s;
+      const float xi = ei + oi * c - or_ * s;
+      p[k] = xr * xr + xi * xi;
+    }
+  }
+
+ private:
+  float cos_[M], sin_[M];
+  float win_[N];
+  uint16_t rev_[M];
+  float re_[M], im_[M];
+};
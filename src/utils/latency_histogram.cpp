@@ -0,0 +1,105 @@
+#include "latency_histogram.h"
+#include <string.h>
+
+static constexpr uint8_t DUMP_MAGIC = 'H';
+static constexpr uint8_t DUMP_VERSION = 1;
+
+void LatencyHistogram::clear() {
+  memset(counts_, 0, sizeof(counts_));
+  total_ = 0;
+  max_ = 0;
+}
+
+uint32_t LatencyHistogram::bucket_lower(uint16_t i) {
+  if (i < SUB) return i;
+  const uint32_t octave = (i - SUB) / SUB;  // 0 -> [2^SUB_BITS, 2^(SUB_BITS+1))
+  const uint32_t sub = (i - SUB) % SUB;
+  return (SUB + sub) << octave;
+}
+
+uint32_t LatencyHistogram::bucket_upper(uint16_t i) {
+  if (i < SUB) return i;
+  const uint32_t octave = (i - SUB) / SUB;
+  return bucket_lower(i) + (1u << octave) - 1;
+}
+
+uint32_t LatencyHistogram::percentile(float pct) const {
+  if (total_ == 0) return 0;
+  if (pct <= 0.0f) pct = 0.0f;
+  if (pct >= 100.0f) return max_;
+
+  // Rank of the sample we're after (1-based, rounded up)
+  uint32_t rank = (uint32_t)(pct * 0.01f * (float)total_);
+  if ((float)rank < pct * 0.01f * (float)total_) rank++;
+  if (rank == 0) rank = 1;
+
+  uint32_t seen = 0;
+  for (uint16_t i = 0; i < BUCKETS; i++) {
+    seen += counts_[i];
+    if (seen >= rank) {
+      const uint32_t v = bucket_upper(i);
+      return v < max_ ? v : max_;
+    }
+  }
+  return max_;  // only reachable when bucket counts saturated
+}
+
+void LatencyHistogram::move_to(LatencyHistogram& out) {
+  memcpy(out.counts_, counts_, sizeof(counts_));
+  out.total_ = total_;
+  out.max_ = max_;
+  clear();
+}
+
+static void put_u16(uint8_t* p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+static void put_u32(uint8_t* p, uint32_t v) { put_u16(p, (uint16_t)v); put_u16(p + 2, (uint16_t)(v >> 16)); }
+static uint16_t get_u16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static uint32_t get_u32(const uint8_t* p) { return get_u16(p) | ((uint32_t)get_u16(p + 2) << 16); }
+
+// Layout:
+//   [0]    'H'
+//   [1]    version
+//   [2]    SUB_BITS
+//   [3]    MAX_EXP
+//   [4..7]  total (u32)
+//   [8..11] max   (u32)
+//   then per non-empty bucket: index (u16), count (u16)
+size_t LatencyHistogram::dump(uint8_t* buf, size_t cap) const {
+  uint16_t nnz = 0;
+  for (uint16_t i = 0; i < BUCKETS; i++) nnz += counts_[i] ? 1 : 0;
+
+  const size_t len = 12 + 4 * (size_t)nnz;
+  if (!buf || cap < len) return 0;
+
+  buf[0] = DUMP_MAGIC;
+  buf[1] = DUMP_VERSION;
+  buf[2] = SUB_BITS;
+  buf[3] = MAX_EXP;
+  put_u32(buf + 4, total_);
+  put_u32(buf + 8, max_);
+
+  uint8_t* p = buf + 12;
+  for (uint16_t i = 0; i < BUCKETS; i++) {
+    if (!counts_[i]) continue;
+    put_u16(p, i);
+    put_u16(p + 2, counts_[i]);
+    p += 4;
+  }
+  return len;
+}
+
+bool LatencyHistogram::load(const uint8_t* buf, size_t len) {
+  if (!buf || len < 12 || ((len - 12) % 4) != 0) return false;
+  if (buf[0] != DUMP_MAGIC || buf[1] != DUMP_VERSION) return false;
+  if (buf[2] != SUB_BITS || buf[3] != MAX_EXP) return false;
+
+  clear();
+  total_ = get_u32(buf + 4);
+  max_ = get_u32(buf + 8);
+  for (const uint8_t* p = buf + 12; p < buf + len; p += 4) {
+    const uint16_t i = get_u16(p);
+    if (i >= BUCKETS) return false;
+    counts_[i] = get_u16(p + 2);
+  }
+  return true;
+}
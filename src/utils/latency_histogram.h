@@ -0,0 +1,62 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// Fixed-memory, log-bucketed latency histogram (HDR-style), microseconds.
+//
+// Values below 64 us get one bucket each; above that every power of two is
+// split into 32 linear sub-buckets, so a bucket is at most ~3% wide. Values
+// at or above 2^20 us (~1 s) land in the last bucket (max() stays exact).
+//
+// record() is a handful of integer ops (one CLZ) and never allocates or
+// locks, so it is safe to call from a rate-group task.
+class LatencyHistogram {
+ public:
+  static constexpr uint8_t SUB_BITS = 5;
+  static constexpr uint32_t SUB = 1u << SUB_BITS;
+  static constexpr uint8_t MAX_EXP = 19;  // last full octave: [2^19, 2^20)
+  static constexpr uint16_t BUCKETS = SUB + (MAX_EXP - SUB_BITS + 1) * SUB;  // 512
+
+  // Binary dump: 12-byte header + 4 bytes per non-empty bucket
+  static constexpr size_t DUMP_MAX_BYTES = 12 + 4 * (size_t)BUCKETS;
+
+  void clear();
+
+  void record(uint32_t v_us) {
+    uint16_t& c = counts_[index_of(v_us)];
+    if (c != 0xFFFF) c++;  // saturate; windows are expected to be short
+    total_++;
+    if (v_us > max_) max_ = v_us;
+  }
+
+  uint32_t total() const { return total_; }
+  uint32_t max() const { return max_; }
+  uint16_t count(uint16_t i) const { return counts_[i]; }
+
+  // Smallest recorded bucket value such that pct % of samples are <= it.
+  // Returns the bucket's upper edge (clamped to max()), 0 when empty.
+  uint32_t percentile(float pct) const;
+
+  // Copy into out and clear this one.
+  void move_to(LatencyHistogram& out);
+
+  // Compact little-endian dump of the non-empty buckets. Returns bytes
+  // written, or 0 if cap is too small. load() is the matching decoder.
+  size_t dump(uint8_t* buf, size_t cap) const;
+  bool load(const uint8_t* buf, size_t len);
+
+  static uint16_t index_of(uint32_t v_us) {
+    if (v_us < 2 * SUB) return (uint16_t)v_us;
+    const uint32_t e = 31u - (uint32_t)__builtin_clz(v_us);
+    if (e > MAX_EXP) return BUCKETS - 1;
+    const uint32_t sub = (v_us >> (e - SUB_BITS)) & (SUB - 1);
+    return (uint16_t)(SUB + (e - SUB_BITS) * SUB + sub);
+  }
+  static uint32_t bucket_lower(uint16_t i);
+  static uint32_t bucket_upper(uint16_t i);
+
+ private:
+  uint16_t counts_[BUCKETS] = {0};
+  uint32_t total_ = 0;
+  uint32_t max_ = 0;
+};
@@ -6,6 +6,20 @@ void LoopStats::reset() {
   max_dt_us_ = 0;
   sum_dt_us_ = 0;
   samples_ = 0;
+
+  jobs_ = 0;
+  max_wake_lat_us_ = 0;
+  sum_wake_lat_us_ = 0;
+  max_exec_us_ = 0;
+  sum_exec_us_ = 0;
+  deadline_misses_ = 0;
+  missed_ticks_ = 0;
+
+  for (int b = 0; b < 2; b++) {
+    dt_hist_[b].clear();
+    exec_hist_[b].clear();
+  }
+  bank_ = 0;
 }
 
 bool LoopStats::ready(uint32_t now_us, uint32_t period_us) const {
@@ -20,6 +34,25 @@ void LoopStats::tick(uint32_t now_us) {
     if (dt > max_dt_us_) max_dt_us_ = dt;
     sum_dt_us_ += dt;
     samples_++;
+    dt_hist_[bank_].record(dt);
   }
   last_us_ = now_us;
 }
+
+void LoopStats::record(uint32_t wake_lat_us, uint32_t exec_us, bool deadline_met) {
+  jobs_++;
+  if (wake_lat_us > max_wake_lat_us_) max_wake_lat_us_ = wake_lat_us;
+  sum_wake_lat_us_ += wake_lat_us;
+  if (exec_us > max_exec_us_) max_exec_us_ = exec_us;
+  sum_exec_us_ += exec_us;
+  if (!deadline_met) deadline_misses_++;
+  exec_hist_[bank_].record(exec_us);
+}
+
+void LoopStats::read_window(LatencyHistogram& dt, LatencyHistogram& exec) {
+  const uint8_t done = bank_;
+  bank_ = done ^ 1;  // writer moves to the (already cleared) other bank
+
+  dt_hist_[done].move_to(dt);
+  exec_hist_[done].move_to(exec);
+}
@@ -1,24 +1,65 @@
 #pragma once
 #include <stdint.h>
 
+#include "utils/latency_histogram.h"
+
 // Simple loop dt statistics (microseconds).
 // Use for Phase 0 to validate scheduler timing and jitter.
+//
+// When a group is driven by the rate scheduler it also records, per job:
+//  - wake-up latency: release (timer tick) -> start of the job
+//  - execution time:  start -> return
+//  - whether it returned before the next release (deadline)
+// and how many releases were skipped because the job was still running.
+//
+// dt (period) and execution time also go into log-bucketed histograms for
+// percentiles. They are double-buffered: tick()/record() write the active
+// bank, read_window() flips banks and hands back the finished one, so the
+// writer never takes a lock. A sample racing the flip may land in either
+// window (or, rarely, be dropped) — fine for diagnostics.
 class LoopStats {
  public:
   void reset();
   void tick(uint32_t now_us);
   bool ready(uint32_t now_us, uint32_t period_us) const;
 
+  void record(uint32_t wake_lat_us, uint32_t exec_us, bool deadline_met);
+  void record_missed_ticks(uint32_t n) { missed_ticks_ += n; }
+
+  // Reset-on-read: returns the dt / exec histograms collected since the
+  // previous call and starts a new window. Call from one reader only.
+  void read_window(LatencyHistogram& dt, LatencyHistogram& exec);
+
   uint32_t last_us() const { return last_us_; }
   uint32_t min_dt_us() const { return min_dt_us_; }
   uint32_t max_dt_us() const { return max_dt_us_; }
   uint32_t avg_dt_us() const { return samples_ ? (sum_dt_us_ / samples_) : 0; }
   uint32_t samples() const { return samples_; }
 
+  uint32_t jobs() const { return jobs_; }
+  uint32_t max_wake_lat_us() const { return max_wake_lat_us_; }
+  uint32_t avg_wake_lat_us() const { return jobs_ ? (uint32_t)(sum_wake_lat_us_ / jobs_) : 0; }
+  uint32_t max_exec_us() const { return max_exec_us_; }
+  uint32_t avg_exec_us() const { return jobs_ ? (uint32_t)(sum_exec_us_ / jobs_) : 0; }
+  uint32_t deadline_misses() const { return deadline_misses_; }
+  uint32_t missed_ticks() const { return missed_ticks_; }
+
  private:
   uint32_t last_us_ = 0;
   uint32_t min_dt_us_ = 0xFFFFFFFF;
   uint32_t max_dt_us_ = 0;
   uint64_t sum_dt_us_ = 0;
   uint32_t samples_ = 0;
+
+  uint32_t jobs_ = 0;
+  uint32_t max_wake_lat_us_ = 0;
+  uint64_t sum_wake_lat_us_ = 0;
+  uint32_t max_exec_us_ = 0;
+  uint64_t sum_exec_us_ = 0;
+  uint32_t deadline_misses_ = 0;
+  uint32_t missed_ticks_ = 0;
+
+  LatencyHistogram dt_hist_[2];
+  LatencyHistogram exec_hist_[2];
+  volatile uint8_t bank_ = 0;
 };
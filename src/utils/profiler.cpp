@@ -0,0 +1,50 @@
+#include "profiler.h"
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <xtensa/hal.h>
+#else
+#include <chrono>
+#endif
+
+namespace prof {
+
+ProfZoneStats g_zones[PROF_ZONE_COUNT];
+
+static const char* const ZONE_NAMES[PROF_ZONE_COUNT] = {
+#define PROF_ZONE_NAME(id, name) name,
+  PROFILE_ZONE_LIST(PROF_ZONE_NAME)
+#undef PROF_ZONE_NAME
+};
+
+#ifdef ARDUINO
+uint32_t now() {
+  return xthal_get_ccount();
+}
+
+float ticks_to_us(uint32_t ticks) {
+  return (float)ticks / (float)getCpuFrequencyMhz();
+}
+#else
+uint32_t now() {
+  using namespace std::chrono;
+  return (uint32_t)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+float ticks_to_us(uint32_t ticks) {
+  return (float)ticks * 0.001f;
+}
+#endif
+
+const char* zone_name(ProfZone z) {
+  return ((int)z < PROF_ZONE_COUNT) ? ZONE_NAMES[(int)z] : "?";
+}
+
+void read_and_reset(ProfZoneStats (&out)[PROF_ZONE_COUNT]) {
+  for (int i = 0; i < PROF_ZONE_COUNT; i++) {
+    out[i] = g_zones[i];
+    g_zones[i] = ProfZoneStats{};
+  }
+}
+
+}  // namespace prof
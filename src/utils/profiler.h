@@ -0,0 +1,88 @@
+#pragma once
+#include <stdint.h>
+
+// Scoped per-stage profiler.
+//
+//   void Sensors::fast_read() {
+//     { PROFILE_ZONE(IMU); _imu.readFRU(imu_s); }
+//   }
+//
+// Zones are a compile-time table (PROFILE_ZONE_LIST below); each one keeps
+// count / total / max in a static slot, so a zone costs two timestamp reads
+// and a few adds. Time source: CCOUNT cycle counter on the ESP32-S3 (per
+// core; our tasks are pinned), std::chrono on host.
+//
+// A zone must only be entered from one task (no locking). Build with
+// -DPROFILE_ZONES=0 to compile every zone out.
+
+#ifndef PROFILE_ZONES
+#define PROFILE_ZONES 1
+#endif
+
+// Add a line here for every new stage (estimators, PIDs, ...).
+#define PROFILE_ZONE_LIST(X) \
+  X(IMU,   "imu")            \
+  X(FLOW,  "flow")           \
+  X(TOF,   "tof")            \
+  X(POWER, "power")          \
+  X(NOTCH, "notch")          \
+  X(SPEC,  "spec")
+
+enum class ProfZone : uint8_t {
+#define PROF_ZONE_ENUM(id, name) id,
+  PROFILE_ZONE_LIST(PROF_ZONE_ENUM)
+#undef PROF_ZONE_ENUM
+  COUNT
+};
+
+static constexpr int PROF_ZONE_COUNT = (int)ProfZone::COUNT;
+
+struct ProfZoneStats {
+  uint32_t count = 0;
+  uint32_t max_ticks = 0;
+  uint64_t sum_ticks = 0;
+};
+
+namespace prof {
+
+// Raw timestamp in profiler ticks (CPU cycles on target, ns on host)
+uint32_t now();
+float ticks_to_us(uint32_t ticks);
+
+const char* zone_name(ProfZone z);
+
+// Window stats since the last read_and_reset(). The reset races a zone that
+// is closing at the same instant; at worst one sample moves to the next window.
+void read_and_reset(ProfZoneStats (&out)[PROF_ZONE_COUNT]);
+
+extern ProfZoneStats g_zones[PROF_ZONE_COUNT];
+
+inline void add(ProfZone z, uint32_t ticks) {
+  ProfZoneStats& s = g_zones[(int)z];
+  s.count++;
+  s.sum_ticks += ticks;
+  if (ticks > s.max_ticks) s.max_ticks = ticks;
+}
+
+}  // namespace prof
+
+class ProfileScope {
+ public:
+  explicit ProfileScope(ProfZone z) : zone_(z), t0_(prof::now()) {}
+  ~ProfileScope() { prof::add(zone_, prof::now() - t0_); }
+
+  ProfileScope(const ProfileScope&) = delete;
+  ProfileScope& operator=(const ProfileScope&) = delete;
+
+ private:
+  ProfZone zone_;
+  uint32_t t0_;
+};
+
+#if PROFILE_ZONES
+#define PROF_CAT_(a, b) a##b
+#define PROF_CAT(a, b) PROF_CAT_(a, b)
+#define PROFILE_ZONE(id) ProfileScope PROF_CAT(prof_scope_, __LINE__)(ProfZone::id)
+#else
+#define PROFILE_ZONE(id) do {} while (0)
+#endif
@@ -0,0 +1,20 @@
+#include "rate_group.h"
+
+void RateGroupStats::reset() {
+  *this = RateGroupStats{};
+}
+
+void RateGroupStats::on_run(uint32_t release_us, uint32_t start_us, uint32_t finish_us,
+                            uint32_t period_us) {
+  const uint32_t lat = (uint32_t)(start_us - release_us);
+  const uint32_t resp = (uint32_t)(finish_us - release_us);
+  const uint32_t exec = (uint32_t)(finish_us - start_us);  // includes preemption
+
+  runs++;
+  if (resp > period_us) deadline_misses++;
+
+  if (lat > max_start_lat_us) max_start_lat_us = lat;
+  if (resp > max_response_us) max_response_us = resp;
+  if (exec > max_exec_us) max_exec_us = exec;
+  last_response_us = resp;
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <stdint.h>
+
+// Upper bound on rate groups per scheduler (fixed arrays, no heap).
+static constexpr int RATE_GROUP_MAX = 6;
+
+// What releases a group's job.
+//  RTOS_TICK: FreeRTOS tick (period must be a whole number of ticks, 1 ms)
+//  HW_TIMER:  esp_timer periodic alarm (any period, no drift vs. the
+//             previous pass, sub-tick wake-up latency)
+//  EXTERNAL:  an ISR (e.g. sensor data-ready) via release_from_isr(); the
+//             group follows the device's clock. period_us is the nominal
+//             period: if no release arrives within 1.5 periods the group
+//             falls back to polling every period_us until one does.
+enum class RateClock : uint8_t {
+  RTOS_TICK = 0,
+  HW_TIMER,
+  EXTERNAL,
+};
+
+// Static description of one periodic rate group.
+// The same definitions drive the FreeRTOS scheduler on target and the
+// virtual-clock simulator on host (see config/rate_groups.h).
+struct RateGroupDef {
+  const char* name;
+  uint32_t period_us;      // release period; deadline = next release
+  uint8_t priority;        // FreeRTOS convention: higher runs first
+  int8_t core;             // pinned core (0/1)
+  uint32_t stack_bytes;    // task stack (ESP-IDF counts bytes, not words)
+  RateClock clock;
+};
+
+// Per-group deadline accounting (microseconds).
+//  - release:  when the job should have started
+//  - start:    when it actually started (latency = start - release)
+//  - finish:   when it returned (response = finish - release)
+// A deadline miss is a job whose response exceeded its period.
+// An overrun is a release that was dropped because the previous job was
+// still running past it. fallback_runs counts EXTERNAL jobs released by the
+// polling fallback instead of the ISR.
+struct RateGroupStats {
+  uint32_t runs = 0;
+  uint32_t overruns = 0;
+  uint32_t deadline_misses = 0;
+  uint32_t fallback_runs = 0;
+
+  uint32_t max_start_lat_us = 0;
+  uint32_t max_response_us = 0;
+  uint32_t max_exec_us = 0;
+  uint32_t last_response_us = 0;
+
+  void reset();
+  void on_run(uint32_t release_us, uint32_t start_us, uint32_t finish_us, uint32_t period_us);
+  void on_overrun() { overruns++; }
+  uint32_t releases() const { return runs + overruns; }
+};
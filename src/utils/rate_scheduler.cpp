@@ -0,0 +1,158 @@
+#include "rate_scheduler.h"
+
+static constexpr uint32_t TICK_US = 1000000UL / configTICK_RATE_HZ;
+
+bool RateScheduler::add(const RateGroupDef& def, GroupFn fn, LoopStats* loop_stats) {
+  if (started_ || n_ >= RATE_GROUP_MAX || !fn || def.period_us == 0) return false;
+  if (def.clock == RateClock::RTOS_TICK &&
+      (def.period_us < TICK_US || (def.period_us % TICK_US) != 0)) {
+    return false;
+  }
+
+  Group& g = groups_[n_++];
+  g.def = def;
+  g.fn = fn;
+  g.loop_stats = loop_stats;
+  g.stats.reset();
+  return true;
+}
+
+bool RateScheduler::start() {
+  if (started_) return false;
+
+  for (int i = 0; i < n_; i++) {
+    Group& g = groups_[i];
+    BaseType_t ok = xTaskCreatePinnedToCore(task_entry, g.def.name, g.def.stack_bytes, &g,
+                                            g.def.priority, &g.task, g.def.core);
+    if (ok != pdPASS) return false;
+
+    if (g.def.clock == RateClock::HW_TIMER) {
+      esp_timer_create_args_t args = {};
+      args.callback = timer_cb;
+      args.arg = &g;
+      args.dispatch_method = ESP_TIMER_TASK;
+      args.name = g.def.name;
+      if (esp_timer_create(&args, &g.timer) != ESP_OK) return false;
+      if (esp_timer_start_periodic(g.timer, g.def.period_us) != ESP_OK) return false;
+    }
+  }
+
+  started_ = true;
+  return true;
+}
+
+// esp_timer task context (core 0, high priority): stamp and wake, nothing else
+void RateScheduler::timer_cb(void* arg) {
+  Group& g = *static_cast<Group*>(arg);
+  g.tick_us = micros();
+  xTaskNotifyGive(g.task);
+}
+
+// GPIO ISR context
+void IRAM_ATTR RateScheduler::release_from_isr(int i, uint32_t t_us) {
+  if (i < 0 || i >= n_ || !groups_[i].task) return;
+  Group& g = groups_[i];
+  g.tick_us = t_us;
+  BaseType_t woken = pdFALSE;
+  vTaskNotifyGiveFromISR(g.task, &woken);
+  if (woken) portYIELD_FROM_ISR();
+}
+
+void RateScheduler::task_entry(void* arg) {
+  Group& g = *static_cast<Group*>(arg);
+  switch (g.def.clock) {
+    case RateClock::HW_TIMER: run_timer_(g); break;
+    case RateClock::EXTERNAL: run_external_(g); break;
+    default:                  run_tick_(g); break;
+  }
+}
+
+void RateScheduler::run_job_(Group& g, uint32_t release_us) {
+  const uint32_t start_us = micros();
+  if (g.loop_stats) g.loop_stats->tick(start_us);
+
+  g.fn();
+
+  const uint32_t finish_us = micros();
+  g.stats.on_run(release_us, start_us, finish_us, g.def.period_us);
+  if (g.loop_stats) {
+    g.loop_stats->record((uint32_t)(start_us - release_us), (uint32_t)(finish_us - start_us),
+                         (uint32_t)(finish_us - release_us) <= g.def.period_us);
+  }
+}
+
+void RateScheduler::missed_(Group& g, uint32_t n) {
+  for (uint32_t i = 0; i < n; i++) g.stats.on_overrun();
+  if (g.loop_stats) g.loop_stats->record_missed_ticks(n);
+}
+
+void RateScheduler::run_timer_(Group& g) {
+  for (;;) {
+    // Notifications accumulate while the job runs; more than one pending
+    // means ticks went by unserved. Run once for the latest tick.
+    const uint32_t pending = ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    if (pending == 0) continue;
+    if (pending > 1) missed_(g, pending - 1);
+
+    run_job_(g, g.tick_us);
+  }
+}
+
+void RateScheduler::run_external_(Group& g) {
+  const uint32_t period_ticks = (g.def.period_us + TICK_US - 1) / TICK_US;
+  const TickType_t irq_timeout = (TickType_t)(period_ticks + (period_ticks + 1) / 2);
+  bool polling = false;
+
+  for (;;) {
+    // Interrupts arriving: wait for them, with a 1.5 period watchdog.
+    // Polling: still take an interrupt the moment one shows up again.
+    const uint32_t pending = ulTaskNotifyTake(pdTRUE, polling ? (TickType_t)period_ticks : irq_timeout);
+
+    if (pending == 0) {
+      polling = true;
+      g.stats.fallback_runs++;
+      run_job_(g, micros());
+      continue;
+    }
+
+    polling = false;
+    if (pending > 1) missed_(g, pending - 1);
+    run_job_(g, g.tick_us);
+  }
+}
+
+void RateScheduler::run_tick_(Group& g) {
+  const TickType_t period_ticks = (TickType_t)(g.def.period_us / TICK_US);
+
+  // Align the first release with a tick boundary so the us and tick
+  // timelines below advance in lock-step.
+  vTaskDelay(1);
+  TickType_t release_tick = xTaskGetTickCount();
+  uint32_t release_us = micros();
+
+  for (;;) {
+    run_job_(g, release_us);
+
+    // Next release. If we finished late, run the most recent missed release
+    // immediately and count the ones before it as overruns (no catch-up burst).
+    release_tick += period_ticks;
+    release_us += g.def.period_us;
+
+    const TickType_t now = xTaskGetTickCount();
+    uint32_t missed = 0;
+    while ((int32_t)(now - (release_tick + period_ticks)) >= 0) {
+      release_tick += period_ticks;
+      release_us += g.def.period_us;
+      missed++;
+    }
+    if (missed) missed_(g, missed);
+
+    // DelayUntil (not Delay) so a tick landing between the read above and
+    // this call doesn't push the wake-up one tick late.
+    const int32_t wait = (int32_t)(release_tick - now);
+    if (wait > 0) {
+      TickType_t from = now;
+      vTaskDelayUntil(&from, (TickType_t)wait);
+    }
+  }
+}
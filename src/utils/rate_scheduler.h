@@ -0,0 +1,61 @@
+#pragma once
+#include <Arduino.h>
+#include <esp_timer.h>
+
+#include "utils/rate_group.h"
+#include "utils/loop_stats.h"
+
+// Preemptive rate-group scheduler (FreeRTOS).
+// Each group runs as its own task, pinned to def.core at def.priority, and is
+// released every def.period_us by its clock (RTOS tick, esp_timer or an
+// external interrupt, see RateClock). A slow low-priority group (I2C reads,
+// Serial prints) can no longer delay a higher-priority one, and a job's start
+// time no longer depends on how long the previous one took.
+//
+// Usage:
+//   g_sched.add(RG_FAST, fast_group, &fast_stats);
+//   g_sched.start();
+class RateScheduler {
+ public:
+  using GroupFn = void (*)();
+
+  // Register a group before start(). Returns false when the table is full or
+  // an RTOS_TICK period is not a whole number of ticks.
+  bool add(const RateGroupDef& def, GroupFn fn, LoopStats* loop_stats = nullptr);
+  bool start();
+
+  int count() const { return n_; }
+  const RateGroupDef& def(int i) const { return groups_[i].def; }
+  const RateGroupStats& stats(int i) const { return groups_[i].stats; }
+
+  // EXTERNAL groups: call from the releasing ISR with the time it captured
+  // (that stamp becomes the job's release time for latency accounting).
+  void IRAM_ATTR release_from_isr(int i, uint32_t t_us);
+
+ private:
+  struct Group {
+    RateGroupDef def{};
+    GroupFn fn = nullptr;
+    LoopStats* loop_stats = nullptr;
+    RateGroupStats stats{};
+    TaskHandle_t task = nullptr;
+
+    // HW_TIMER only
+    esp_timer_handle_t timer = nullptr;
+
+    // HW_TIMER / EXTERNAL: last release, written by timer_cb() / the ISR
+    volatile uint32_t tick_us = 0;
+  };
+
+  static void task_entry(void* arg);
+  static void timer_cb(void* arg);
+  static void run_tick_(Group& g);
+  static void run_timer_(Group& g);
+  static void run_external_(Group& g);
+  static void run_job_(Group& g, uint32_t release_us);
+  static void missed_(Group& g, uint32_t n);
+
+  Group groups_[RATE_GROUP_MAX];
+  int n_ = 0;
+  bool started_ = false;
+};
@@ -0,0 +1,113 @@
+#include "rate_scheduler_sim.h"
+
+RateSchedulerSim::RateSchedulerSim(uint32_t start_us) : now_us_(start_us) {}
+
+bool RateSchedulerSim::add(const RateGroupDef& def, ExecModel exec, void* ctx,
+                           LoopStats* loop_stats) {
+  if (n_ >= RATE_GROUP_MAX || !exec || def.period_us == 0) return false;
+  if (def.core < 0 || def.core >= CORES) return false;
+
+  Group& g = groups_[n_++];
+  g = Group{};
+  g.def = def;
+  g.exec = exec;
+  g.ctx = ctx;
+  g.loop_stats = loop_stats;
+  g.next_release_us = now_us_;  // all groups released together (worst case)
+  return true;
+}
+
+void RateSchedulerSim::release_due_() {
+  for (int i = 0; i < n_; i++) {
+    Group& g = groups_[i];
+    if (g.active || g.next_release_us > now_us_) continue;
+    g.active = true;
+    g.started = false;
+    g.release_us = g.next_release_us;
+    g.remaining_us = g.exec(g.job++, g.ctx);
+  }
+}
+
+int RateSchedulerSim::pick_(int core) const {
+  int best = -1;
+  for (int i = 0; i < n_; i++) {
+    const Group& g = groups_[i];
+    if (!g.active || g.def.core != core) continue;
+    if (best < 0 || g.def.priority > groups_[best].def.priority) best = i;
+  }
+  return best;
+}
+
+void RateSchedulerSim::finish_(int gi) {
+  Group& g = groups_[gi];
+  g.stats.on_run((uint32_t)g.release_us, (uint32_t)g.start_us, (uint32_t)now_us_,
+                 g.def.period_us);
+  if (g.loop_stats) {
+    g.loop_stats->record((uint32_t)(g.start_us - g.release_us), (uint32_t)(now_us_ - g.start_us),
+                         now_us_ - g.release_us <= g.def.period_us);
+  }
+
+  // Same rule as RateScheduler::run_tick_() (missed_() for the notify-count
+  // groups): keep the latest missed release, drop the ones before it.
+  g.next_release_us = g.release_us + g.def.period_us;
+  while (g.next_release_us + g.def.period_us <= now_us_) {
+    g.next_release_us += g.def.period_us;
+    g.stats.on_overrun();
+    if (g.loop_stats) g.loop_stats->record_missed_ticks(1);
+  }
+
+  g.active = false;
+  running_[g.def.core] = -1;
+}
+
+void RateSchedulerSim::run_for(uint32_t duration_us) {
+  const uint64_t end_us = now_us_ + duration_us;
+
+  for (;;) {
+    release_due_();
+
+    // Dispatch: highest-priority ready job per core (ties -> lower index)
+    bool finished_any = false;
+    for (int c = 0; c < CORES; c++) {
+      const int best = pick_(c);
+      const int prev = running_[c];
+      if (prev >= 0 && prev != best) groups_[prev].preemptions++;
+      running_[c] = best;
+      if (best < 0) continue;
+
+      Group& g = groups_[best];
+      if (!g.started) {
+        g.started = true;
+        g.start_us = now_us_;
+        if (g.loop_stats) g.loop_stats->tick((uint32_t)now_us_);
+      }
+      if (g.remaining_us == 0) {
+        finish_(best);
+        finished_any = true;
+      }
+    }
+    if (finished_any) continue;  // zero-length jobs may free a core now
+    if (now_us_ >= end_us) break;
+
+    // Advance to the next event: a completion, a release or the end
+    uint64_t next_us = end_us;
+    for (int c = 0; c < CORES; c++) {
+      if (running_[c] < 0) continue;
+      const uint64_t done = now_us_ + groups_[running_[c]].remaining_us;
+      if (done < next_us) next_us = done;
+    }
+    for (int i = 0; i < n_; i++) {
+      const Group& g = groups_[i];
+      if (!g.active && g.next_release_us < next_us) next_us = g.next_release_us;
+    }
+
+    const uint64_t dt = next_us - now_us_;
+    now_us_ = next_us;
+    for (int c = 0; c < CORES; c++) {
+      const int gi = running_[c];
+      if (gi < 0) continue;
+      groups_[gi].remaining_us -= dt;
+      if (groups_[gi].remaining_us == 0) finish_(gi);
+    }
+  }
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <stdint.h>
+
+#include "utils/rate_group.h"
+#include "utils/loop_stats.h"
+
+// Host-side model of RateScheduler on a virtual microsecond clock.
+// Fixed-priority preemptive scheduling with one ready queue per core and the
+// same release/overrun rules as the firmware, so the group table in
+// config/rate_groups.h can be checked for jitter and preemption on Linux.
+// Job execution times come from a caller-supplied model; context-switch cost
+// and the RTOS tick / esp_timer dispatch latency (RateClock) are not modelled,
+// so every release happens exactly on its period.
+class RateSchedulerSim {
+ public:
+  // Returns the execution time (us) of the job-th release of a group.
+  using ExecModel = uint32_t (*)(uint32_t job, void* ctx);
+
+  static constexpr int CORES = 2;
+
+  explicit RateSchedulerSim(uint32_t start_us = 1000000);
+
+  bool add(const RateGroupDef& def, ExecModel exec, void* ctx = nullptr,
+           LoopStats* loop_stats = nullptr);
+  void run_for(uint32_t duration_us);
+
+  uint32_t now_us() const { return (uint32_t)now_us_; }
+  int count() const { return n_; }
+  const RateGroupDef& def(int i) const { return groups_[i].def; }
+  const RateGroupStats& stats(int i) const { return groups_[i].stats; }
+  uint32_t preemptions(int i) const { return groups_[i].preemptions; }
+
+ private:
+  struct Group {
+    RateGroupDef def{};
+    ExecModel exec = nullptr;
+    void* ctx = nullptr;
+    LoopStats* loop_stats = nullptr;
+    RateGroupStats stats{};
+    uint32_t preemptions = 0;
+
+    uint32_t job = 0;
+    uint64_t next_release_us = 0;
+
+    // Current job
+    bool active = false;
+    bool started = false;
+    uint64_t release_us = 0;
+    uint64_t start_us = 0;
+    uint64_t remaining_us = 0;
+  };
+
+  void release_due_();
+  int pick_(int core) const;
+  void finish_(int gi);
+
+  Group groups_[RATE_GROUP_MAX];
+  int running_[CORES] = {-1, -1};
+  int n_ = 0;
+  uint64_t now_us_ = 0;
+};
@@ -0,0 +1,86 @@
+#pragma once
+#include <stdint.h>
+
+// Lock-free hand-offs between tasks, safe across cores. No heap, no RTOS
+// calls, so every side can be any task priority and the writer never
+// blocks. SpscRing: exactly one writer and one reader. SpscSnapshot: one
+// writer, any number of readers.
+
+static inline void spsc_fence() { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+
+// Fixed-capacity FIFO. push() drops (and counts) when full.
+template <class T, uint16_t N>
+class SpscRing {
+ public:
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "ring size must be a power of two");
+
+  bool push(const T& v)
+  {
+    const uint16_t h = head_;
+    if ((uint16_t)(h - tail_) >= N) {
+      dropped_++;
+      return false;
+    }
+    buf_[h & (N - 1)] = v;
+    spsc_fence();
+    head_ = (uint16_t)(h + 1);
+    return true;
+  }
+
+  bool pop(T& out)
+  {
+    const uint16_t t = tail_;
+    if (t == head_) return false;
+    spsc_fence();
+    out = buf_[t & (N - 1)];
+    spsc_fence();
+    tail_ = (uint16_t)(t + 1);
+    return true;
+  }
+
+  uint32_t dropped() const { return dropped_; }
+
+ private:
+  T buf_[N];
+  volatile uint16_t head_ = 0;   // writer
+  volatile uint16_t tail_ = 0;   // reader
+  uint32_t dropped_ = 0;         // writer
+};
+
+// Latest-value mailbox (seqlock): one writer, any number of readers (read()
+// only looks). A reader retries while a write is in progress and gives up
+// after a few tries, keeping what it had.
+template <class T>
+class SpscSnapshot {
+ public:
+  void write(const T& v)
+  {
+    seq_ = seq_ + 1;   // odd: writing
+    spsc_fence();
+    val_ = v;
+    spsc_fence();
+    seq_ = seq_ + 1;
+  }
+
+  // False if nothing was written yet or the writer kept interfering
+  bool read(T& out) const
+  {
+    for (int tries = 0; tries < 4; tries++) {
+      const uint32_t s0 = seq_;
+      if (s0 == 0) return false;
+      if (s0 & 1) continue;
+      spsc_fence();
+      T v = val_;
+      spsc_fence();
+      if (seq_ == s0) {
+        out = v;
+        return true;
+      }
+    }
+    return false;
+  }
+
+ private:
+  T val_{};
+  volatile uint32_t seq_ = 0;
+};
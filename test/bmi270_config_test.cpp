@@ -0,0 +1,118 @@
+// Host tests for the compile-time BMI270 config (IMU_CFG and Bmi270Config).
+#include <string.h>
+
+#include "test_check.h"
+#include "config/imu_config.h"
+
+// Timing must fall out of IMU_CFG: 1.6 kHz sensor, decimated to 400 Hz
+static_assert(IMU_CFG.odr_hz() == 1600, "ODR");
+static_assert(IMU_CFG.period_us() == 625, "period");
+static_assert(IMU_CFG.sensortime_ticks() == 16, "sensortime ticks");
+static_assert(IMU_OUT_HZ == 400, "decimated rate");
+static_assert(IMU_CFG.acc_range_g() == 4.0f, "acc range");
+static_assert(IMU_CFG.gyr_range_dps() == 2000.0f, "gyr range");
+
+static bool same_bits(float a, float b)
+{
+  return memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+static void test_scale_matches_old_constants()
+{
+  constexpr float INV_32768 = 1.0f / 32768.0f;
+  constexpr float DEG2RAD = 3.14159265358979323846f / 180.0f;
+  constexpr float G = 9.80665f;
+  constexpr Bmi270Scale k = IMU_CFG.scale();
+
+  int bad = 0;
+  for (int32_t v = -32768; v <= 32767; v++) {
+    const int16_t acc[3] = { (int16_t)v, (int16_t)v, (int16_t)v };
+    float a[3], g[3];
+    bmi270_raw_to_si(acc, acc, k, a, g);
+    if (!same_bits(a[0], (v * INV_32768) * (4.0f * G))) bad++;
+    if (!same_bits(g[0], (v * INV_32768) * (2000.0f * DEG2RAD))) bad++;
+  }
+  CHECK(bad == 0);
+}
+
+static void test_ranges_and_odrs()
+{
+  const float acc_g[] = { 2, 4, 8, 16 };
+  for (uint8_t r = BMI2_ACC_RANGE_2G; r <= BMI2_ACC_RANGE_16G; r++) {
+    const Bmi270Config c = { r, BMI2_GYR_RANGE_2000, BMI2_ACC_ODR_400HZ, 0, 0, { {0, 1}, {1, 1}, {2, 1} } };
+    CHECK(c.acc_range_g() == acc_g[r]);
+    CHECK(c.valid());
+  }
+  const float gyr_dps[] = { 2000, 1000, 500, 250, 125 };
+  for (uint8_t r = BMI2_GYR_RANGE_2000; r <= BMI2_GYR_RANGE_125; r++) {
+    const Bmi270Config c = { BMI2_ACC_RANGE_4G, r, BMI2_ACC_ODR_400HZ, 0, 0, { {0, 1}, {1, 1}, {2, 1} } };
+    CHECK(c.gyr_range_dps() == gyr_dps[r]);
+  }
+  const uint32_t hz[] = { 100, 200, 400, 800, 1600 };
+  for (uint8_t o = BMI2_ACC_ODR_100HZ; o <= BMI2_ACC_ODR_1600HZ; o++) {
+    const Bmi270Config c = { BMI2_ACC_RANGE_4G, BMI2_GYR_RANGE_2000, o, 0, 0, { {0, 1}, {1, 1}, {2, 1} } };
+    CHECK(c.odr_hz() == hz[o - BMI2_ACC_ODR_100HZ]);
+    CHECK(c.sensortime_ticks() * hz[o - BMI2_ACC_ODR_100HZ] == 25600);
+  }
+
+  const Bmi270Config bad_odr = { BMI2_ACC_RANGE_4G, BMI2_GYR_RANGE_2000, BMI2_GYR_ODR_3200HZ, 0, 0, { {0, 1}, {1, 1}, {2, 1} } };
+  CHECK(!bad_odr.valid());
+  const Bmi270Config bad_range = { 4, BMI2_GYR_RANGE_2000, BMI2_ACC_ODR_400HZ, 0, 0, { {0, 1}, {1, 1}, {2, 1} } };
+  CHECK(!bad_range.valid());
+}
+
+static void test_axis_map()
+{
+  // IMU_CFG: the old mapSensorToFRU (x <- y, y <- x, z <- z)
+  const float s[3] = { 1.5f, -2.5f, 9.75f };
+  float b[3];
+  bmi270_to_body(IMU_CFG, s, b);
+  CHECK(b[0] == s[1]);
+  CHECK(b[1] == s[0]);
+  CHECK(b[2] == s[2]);
+
+  // Signs flip exactly
+  const Bmi270Config flip = { BMI2_ACC_RANGE_4G, BMI2_GYR_RANGE_2000, BMI2_ACC_ODR_400HZ, 0, 0,
+                              { {2, -1}, {0, 1}, {1, -1} } };
+  CHECK(flip.valid());
+  bmi270_to_body(flip, s, b);
+  CHECK(b[0] == -s[2]);
+  CHECK(b[1] == s[0]);
+  CHECK(b[2] == -s[1]);
+
+  // Not a permutation / bad sign
+  const Bmi270Config dup = { BMI2_ACC_RANGE_4G, BMI2_GYR_RANGE_2000, BMI2_ACC_ODR_400HZ, 0, 0,
+                             { {0, 1}, {0, 1}, {2, 1} } };
+  CHECK(!dup.valid());
+  const Bmi270Config zero_sign = { BMI2_ACC_RANGE_4G, BMI2_GYR_RANGE_2000, BMI2_ACC_ODR_400HZ, 0, 0,
+                                   { {0, 1}, {1, 0}, {2, 1} } };
+  CHECK(!zero_sign.valid());
+}
+
+static void test_fill_config()
+{
+  bmi2_sens_config acc, gyr;
+  memset(&acc, 0, sizeof(acc));
+  memset(&gyr, 0, sizeof(gyr));
+  bmi270_fill_config(IMU_CFG, acc, gyr);
+
+  // What begin() writes (1.6 kHz since the decimator went in)
+  CHECK(acc.cfg.acc.odr == BMI2_ACC_ODR_1600HZ);
+  CHECK(acc.cfg.acc.range == BMI2_ACC_RANGE_4G);
+  CHECK(acc.cfg.acc.bwp == BMI2_ACC_NORMAL_AVG4);
+  CHECK(acc.cfg.acc.filter_perf == BMI2_PERF_OPT_MODE);
+  CHECK(gyr.cfg.gyr.odr == BMI2_GYR_ODR_1600HZ);
+  CHECK(gyr.cfg.gyr.range == BMI2_GYR_RANGE_2000);
+  CHECK(gyr.cfg.gyr.bwp == BMI2_GYR_NORMAL_MODE);
+  CHECK(gyr.cfg.gyr.noise_perf == BMI2_PERF_OPT_MODE);
+  CHECK(gyr.cfg.gyr.filter_perf == BMI2_PERF_OPT_MODE);
+}
+
+int main()
+{
+  test_scale_matches_old_constants();
+  test_ranges_and_odrs();
+  test_axis_map();
+  test_fill_config();
+  return TEST_RESULT();
+}
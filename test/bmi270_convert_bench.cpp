@@ -0,0 +1,75 @@
+// Host microbenchmark: per-sample decode cost, Bosch parser + old scaling
+// (what bmi2_get_sensor_data did after its 24-byte read) vs the 12-byte
+// direct-register path. SPI time is not included; the burst also halves the
+// bytes on the wire (1 + 1 + 12 instead of 1 + 1 + 24).
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+
+#include "sensors/imu/bmi270_convert.h"
+
+extern "C" {
+  #include "bmi2.h"
+}
+
+static int8_t dummy_read(uint8_t, uint8_t *, uint32_t, void *) { return 0; }
+static int8_t dummy_write(uint8_t, const uint8_t *, uint32_t, void *) { return 0; }
+static void dummy_delay(uint32_t, void *) {}
+
+static volatile float g_sink;
+
+int main() {
+  constexpr uint32_t N = 10 * 1000 * 1000;
+  constexpr uint32_t IMAGES = 64;
+
+  bmi2_dev dev;
+  memset(&dev, 0, sizeof(dev));
+  dev.read = dummy_read;
+  dev.write = dummy_write;
+  dev.delay_us = dummy_delay;
+  dev.remap.y_axis = BMI2_MAP_Y_AXIS;
+  dev.remap.z_axis = BMI2_MAP_Z_AXIS;
+  dev.gyr_cross_sens_zx = 7;
+
+  // Register images to cycle through so nothing is constant-folded
+  static uint8_t burst[IMAGES][BMI2_ACC_GYR_AUX_SENSORTIME_NUM_BYTES];
+  uint32_t x = 12345;
+  for (uint32_t i = 0; i < IMAGES; i++) {
+    for (uint32_t b = 0; b < sizeof(burst[i]); b++) {
+      x = x * 1664525u + 1013904223u;
+      burst[i][b] = (uint8_t)(x >> 24);
+    }
+  }
+
+  constexpr float INV_32768 = 1.0f / 32768.0f;
+  constexpr float DEG2RAD = 3.14159265358979323846f / 180.0f;
+  constexpr float G = 9.80665f;
+  float acc_sum = 0;
+
+  auto t0 = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < N; i++) {
+    bmi2_sens_data data = {};
+    bmi2_parse_sensor_data(burst[i % IMAGES], &data, &dev);
+    acc_sum += (data.acc.x * INV_32768) * (4.0f * G) + (data.acc.y * INV_32768) * (4.0f * G)
+             + (data.acc.z * INV_32768) * (4.0f * G) + (data.gyr.x * INV_32768) * (2000.0f * DEG2RAD)
+             + (data.gyr.y * INV_32768) * (2000.0f * DEG2RAD) + (data.gyr.z * INV_32768) * (2000.0f * DEG2RAD);
+  }
+  auto t1 = std::chrono::steady_clock::now();
+
+  const Bmi270Scale k = Bmi270Scale::make(4.0f, 2000.0f);
+  for (uint32_t i = 0; i < N; i++) {
+    int16_t acc[3], gyr[3];
+    float a[3], g[3];
+    bmi270_unpack_regs(burst[i % IMAGES] + BMI2_ACC_START_INDEX, dev.gyr_cross_sens_zx, acc, gyr);
+    bmi270_raw_to_si(acc, gyr, k, a, g);
+    acc_sum += a[0] + a[1] + a[2] + g[0] + g[1] + g[2];
+  }
+  auto t2 = std::chrono::steady_clock::now();
+  g_sink = acc_sum;
+
+  const double bosch_ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / N;
+  const double lean_ns = std::chrono::duration<double, std::nano>(t2 - t1).count() / N;
+  printf("bosch parse + scale:   %.2f ns/sample\n", bosch_ns);
+  printf("direct regs + scale:   %.2f ns/sample\n", lean_ns);
+  return 0;
+}
@@ -0,0 +1,197 @@
+// Host tests for the direct-register BMI270 conversion (bmi270_convert).
+// Reference: the Bosch parser (bmi2_parse_sensor_data) plus the scaling the
+// old read_raw_sample() did; the lean path must match both bit for bit.
+#include <string.h>
+
+#include "test_check.h"
+#include "sensors/imu/bmi270_convert.h"
+
+extern "C" {
+  #include "bmi2.h"
+}
+
+// --- Reference: the pre-burst conversion, copied from read_raw_sample() --- //
+
+static void ref_to_si(const bmi2_sens_data &data, float a[3], float g[3])
+{
+  constexpr float INV_32768 = 1.0f / 32768.0f;
+  constexpr float DEG2RAD = 3.14159265358979323846f / 180.0f;
+  constexpr float G = 9.80665f;
+
+  constexpr float ACC_RANGE_G = 4.0f;
+  constexpr float GYR_RANGE_DPS = 2000.0f;
+
+  a[0] = (data.acc.x * INV_32768) * (ACC_RANGE_G * G);
+  a[1] = (data.acc.y * INV_32768) * (ACC_RANGE_G * G);
+  a[2] = (data.acc.z * INV_32768) * (ACC_RANGE_G * G);
+
+  g[0] = (data.gyr.x * INV_32768) * (GYR_RANGE_DPS * DEG2RAD);
+  g[1] = (data.gyr.y * INV_32768) * (GYR_RANGE_DPS * DEG2RAD);
+  g[2] = (data.gyr.z * INV_32768) * (GYR_RANGE_DPS * DEG2RAD);
+}
+
+// --- Bosch parser setup --- //
+
+static int8_t dummy_read(uint8_t, uint8_t *, uint32_t, void *) { return 0; }
+static int8_t dummy_write(uint8_t, const uint8_t *, uint32_t, void *) { return 0; }
+static void dummy_delay(uint32_t, void *) {}
+
+static bmi2_dev make_dev(int16_t cross_zx)
+{
+  bmi2_dev dev;
+  memset(&dev, 0, sizeof(dev));
+  dev.read = dummy_read;
+  dev.write = dummy_write;
+  dev.delay_us = dummy_delay;
+  // bmi2_sec_init() default: identity
+  dev.remap.x_axis = BMI2_MAP_X_AXIS;
+  dev.remap.y_axis = BMI2_MAP_Y_AXIS;
+  dev.remap.z_axis = BMI2_MAP_Z_AXIS;
+  dev.gyr_cross_sens_zx = cross_zx;
+  return dev;
+}
+
+static bool same_bits(float a, float b)
+{
+  return memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+static uint32_t g_rng = 1;
+static uint8_t rnd8()
+{
+  g_rng = g_rng * 1664525u + 1013904223u;
+  return (uint8_t)(g_rng >> 24);
+}
+
+// Lean path vs Bosch parser + old scaling on one 12-byte register image
+static bool matches_reference(const uint8_t regs[12], int16_t cross_zx)
+{
+  bmi2_dev dev = make_dev(cross_zx);
+
+  // bmi2_get_sensor_data reads 24 bytes from STATUS; data regs start at 9
+  uint8_t burst[BMI2_ACC_GYR_AUX_SENSORTIME_NUM_BYTES] = {0};
+  memcpy(burst + BMI2_ACC_START_INDEX, regs, 12);
+  bmi2_sens_data data;
+  memset(&data, 0, sizeof(data));
+  if (bmi2_parse_sensor_data(burst, &data, &dev) != BMI2_OK) return false;
+
+  float ra[3], rg[3];
+  ref_to_si(data, ra, rg);
+
+  int16_t acc[3], gyr[3];
+  float a[3], g[3];
+  bmi270_unpack_regs(regs, cross_zx, acc, gyr);
+  bmi270_raw_to_si(acc, gyr, Bmi270Scale::make(4.0f, 2000.0f), a, g);
+
+  if (acc[0] != data.acc.x || acc[1] != data.acc.y || acc[2] != data.acc.z) return false;
+  if (gyr[0] != data.gyr.x || gyr[1] != data.gyr.y || gyr[2] != data.gyr.z) return false;
+  for (int i = 0; i < 3; i++) {
+    if (!same_bits(a[i], ra[i]) || !same_bits(g[i], rg[i])) return false;
+  }
+  return true;
+}
+
+// Every int16 count on every axis, cross-axis term off
+static void test_all_counts_bit_exact()
+{
+  int bad = 0;
+  for (int32_t v = -32768; v <= 32767; v++) {
+    const uint8_t lo = (uint8_t)(v & 0xFF), hi = (uint8_t)((v >> 8) & 0xFF);
+    const uint8_t regs[12] = { lo, hi, hi, lo, lo, hi, lo, hi, hi, lo, lo, hi };
+    if (!matches_reference(regs, 0)) bad++;
+  }
+  CHECK(bad == 0);
+}
+
+// Random register images with the cross-axis correction in play,
+// including values that saturate gyro x
+static void test_cross_axis_bit_exact()
+{
+  const int16_t factors[] = { 0, 1, -1, 7, -13, 127, -128, 511, -512, 32767, -32768 };
+  int bad = 0;
+  for (int16_t f : factors) {
+    for (int n = 0; n < 20000; n++) {
+      uint8_t regs[12];
+      for (int i = 0; i < 12; i++) regs[i] = rnd8();
+      if (!matches_reference(regs, f)) bad++;
+    }
+    // Corners: gyro x and z at the rails
+    const uint8_t rails[][4] = { {0xFF, 0x7F, 0xFF, 0x7F}, {0x00, 0x80, 0x00, 0x80},
+                                 {0xFF, 0x7F, 0x00, 0x80}, {0x00, 0x80, 0xFF, 0x7F} };
+    for (const auto &r : rails) {
+      uint8_t regs[12] = {0};
+      regs[6] = r[0]; regs[7] = r[1];
+      regs[10] = r[2]; regs[11] = r[3];
+      if (!matches_reference(regs, f)) bad++;
+    }
+  }
+  CHECK(bad == 0);
+}
+
+static void test_scale_values()
+{
+  const Bmi270Scale k = Bmi270Scale::make(4.0f, 2000.0f);
+  CHECK_NEAR(k.acc * 8192.0f, 9.80665, 1e-5);                       // 1 g at ±4 g
+  CHECK_NEAR(k.gyr * 16.384f, 3.14159265358979 / 180.0, 1e-7);      // 1 dps at ±2000 dps
+
+  const uint8_t regs[12] = { 0x00, 0x20, 0, 0, 0, 0, 0, 0, 0, 0, 0x00, 0x80 };
+  int16_t acc[3], gyr[3];
+  float a[3], g[3];
+  bmi270_unpack_regs(regs, 0, acc, gyr);
+  bmi270_raw_to_si(acc, gyr, k, a, g);
+  CHECK(acc[0] == 8192);
+  CHECK(gyr[2] == -32768);
+  CHECK_NEAR(a[0], 9.80665, 1e-5);
+  CHECK_NEAR(g[2], -2000.0 * 3.14159265358979 / 180.0, 1e-4);
+}
+
+static void test_temperature()
+{
+  float t = 0;
+  const uint8_t zero[2] = { 0x00, 0x00 };
+  CHECK(bmi270_temp_c(zero, t));
+  CHECK(t == 23.0f);
+
+  const uint8_t plus10[2] = { 0x00, 0x14 };    // 10 * 512 = 0x1400
+  CHECK(bmi270_temp_c(plus10, t));
+  CHECK(t == 33.0f);
+
+  const uint8_t minus_half[2] = { 0x00, 0xFF }; // -256
+  CHECK(bmi270_temp_c(minus_half, t));
+  CHECK(t == 22.5f);
+
+  const uint8_t invalid[2] = { 0x00, 0x80 };
+  t = -1;
+  CHECK(!bmi270_temp_c(invalid, t));
+  CHECK(t == -1);
+}
+
+static void test_stuck_bus()
+{
+  uint8_t regs[12];
+  memset(regs, 0x00, sizeof(regs));
+  CHECK(bmi270_regs_stuck(regs));
+  memset(regs, 0xFF, sizeof(regs));
+  CHECK(bmi270_regs_stuck(regs));
+
+  // One real byte anywhere is a sample
+  regs[11] = 0xFE;
+  CHECK(!bmi270_regs_stuck(regs));
+  memset(regs, 0x00, sizeof(regs));
+  regs[4] = 0x20;   // acc z = +0.5 g
+  CHECK(!bmi270_regs_stuck(regs));
+
+  // Uniform but not a rail: a (strange) reading, not the bus
+  memset(regs, 0x55, sizeof(regs));
+  CHECK(!bmi270_regs_stuck(regs));
+}
+
+int main()
+{
+  test_all_counts_bit_exact();
+  test_cross_axis_bit_exact();
+  test_scale_values();
+  test_temperature();
+  test_stuck_bus();
+  return TEST_RESULT();
+}
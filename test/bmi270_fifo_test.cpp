@@ -0,0 +1,277 @@
+// Host test: BMI270 FIFO burst read + header-mode frame parsing.
+//
+// A fake SPI device stands in for the sensor: a register map for the FIFO
+// length/config registers and a byte stream behind FIFO_DATA (0x26) that
+// behaves like the real FIFO (sensortime frame appended when a read goes
+// past the last frame, 0x80 over-read bytes after that).
+#include "test_check.h"
+
+#include <string.h>
+
+#include "sensors/imu/bmi270_fifo.h"
+
+struct FakeBmi {
+  uint8_t regs[128];
+  uint8_t fifo[1024];
+  uint16_t fifo_len;
+  uint32_t sensor_time;  // value the sensortime frame reports at read
+  uint32_t fifo_reads;
+};
+
+static FakeBmi g_fake;
+
+static void fake_reset() {
+  memset(&g_fake, 0, sizeof(g_fake));
+  // FIFO_CONFIG_0/1: header + time + acc + gyr enabled
+  const uint16_t cfg = BMI2_FIFO_HEADER_EN | BMI2_FIFO_TIME_EN | BMI2_FIFO_ACC_EN | BMI2_FIFO_GYR_EN;
+  g_fake.regs[BMI2_FIFO_CONFIG_0_ADDR] = (uint8_t)(cfg & 0xFF);
+  g_fake.regs[BMI2_FIFO_CONFIG_0_ADDR + 1] = (uint8_t)(cfg >> 8);
+}
+
+static void fake_sync_length() {
+  g_fake.regs[BMI2_FIFO_LENGTH_0_ADDR] = (uint8_t)(g_fake.fifo_len & 0xFF);
+  g_fake.regs[BMI2_FIFO_LENGTH_0_ADDR + 1] = (uint8_t)(g_fake.fifo_len >> 8);
+}
+
+static void put16(uint8_t* p, int16_t v) {
+  p[0] = (uint8_t)(v & 0xFF);
+  p[1] = (uint8_t)((uint16_t)v >> 8);
+}
+
+// Header 0x8C: gyro xyz then accel xyz, little endian
+static void push_frame(int16_t seed) {
+  uint8_t* p = g_fake.fifo + g_fake.fifo_len;
+  p[0] = 0x8C;
+  put16(p + 1, (int16_t)(seed + 1));
+  put16(p + 3, (int16_t)(seed + 2));
+  put16(p + 5, (int16_t)(seed + 3));
+  put16(p + 7, (int16_t)(-seed - 1));
+  put16(p + 9, (int16_t)(-seed - 2));
+  put16(p + 11, (int16_t)(-seed - 3));
+  g_fake.fifo_len += 13;
+  fake_sync_length();
+}
+
+static void push_skip(uint8_t n) {
+  g_fake.fifo[g_fake.fifo_len++] = 0x40;
+  g_fake.fifo[g_fake.fifo_len++] = n;
+  fake_sync_length();
+}
+
+static int8_t fake_read(uint8_t reg, uint8_t* data, uint32_t len, void*) {
+  reg &= 0x7F;
+  data[0] = 0xFF;  // SPI dummy byte
+  uint8_t* out = data + 1;
+  const uint32_t n = len - 1;
+
+  if (reg != BMI2_FIFO_DATA_ADDR) {
+    for (uint32_t i = 0; i < n; i++) out[i] = g_fake.regs[(reg + i) & 0x7F];
+    return BMI2_INTF_RET_SUCCESS;
+  }
+
+  g_fake.fifo_reads++;
+  uint32_t i = 0;
+  const uint32_t avail = n < g_fake.fifo_len ? n : g_fake.fifo_len;
+  for (; i < avail; i++) out[i] = g_fake.fifo[i];
+  bool drained = (avail == g_fake.fifo_len);
+
+  // Consume what was read
+  memmove(g_fake.fifo, g_fake.fifo + avail, g_fake.fifo_len - avail);
+  g_fake.fifo_len = (uint16_t)(g_fake.fifo_len - avail);
+  fake_sync_length();
+
+  if (drained && i + 4 <= n) {
+    out[i++] = 0x44;
+    out[i++] = (uint8_t)(g_fake.sensor_time & 0xFF);
+    out[i++] = (uint8_t)((g_fake.sensor_time >> 8) & 0xFF);
+    out[i++] = (uint8_t)((g_fake.sensor_time >> 16) & 0xFF);
+  }
+  for (; i < n; i++) out[i] = 0x80;
+  return BMI2_INTF_RET_SUCCESS;
+}
+
+static int8_t fake_write(uint8_t reg, const uint8_t* data, uint32_t len, void*) {
+  for (uint32_t i = 0; i < len; i++) g_fake.regs[(reg + i) & 0x7F] = data[i];
+  return BMI2_INTF_RET_SUCCESS;
+}
+static void fake_delay(uint32_t, void*) {}
+
+static void make_dev(bmi2_dev& dev) {
+  memset(&dev, 0, sizeof(dev));
+  dev.intf = BMI2_SPI_INTF;
+  dev.read = fake_read;
+  dev.write = fake_write;
+  dev.delay_us = fake_delay;
+  dev.dummy_byte = 1;
+  dev.remap.x_axis = BMI2_MAP_X_AXIS;
+  dev.remap.y_axis = BMI2_MAP_Y_AXIS;
+  dev.remap.z_axis = BMI2_MAP_Z_AXIS;
+}
+
+static bool frame_matches(const Bmi270FifoFrame& f, int16_t seed) {
+  return f.gyr[0] == seed + 1 && f.gyr[1] == seed + 2 && f.gyr[2] == seed + 3 &&
+         f.acc[0] == -seed - 1 && f.acc[1] == -seed - 2 && f.acc[2] == -seed - 3;
+}
+
+static Bmi270Fifo g_fifo(64);   // 400 Hz
+static Bmi270FifoBatch g_batch;
+
+static void test_drain_with_sensortime() {
+  fake_reset();
+  bmi2_dev dev;
+  make_dev(dev);
+  for (int i = 0; i < 5; i++) push_frame((int16_t)(100 * i));
+  g_fake.sensor_time = 10 * 64 + 20;  // 20 ticks after the newest frame
+
+  CHECK(g_fifo.read(dev, g_batch) == BMI2_OK);
+  CHECK(g_fake.fifo_reads == 1);
+  CHECK(g_batch.fifo_bytes == 5 * 13);
+  CHECK(g_batch.count == 5);
+  CHECK(g_batch.unpaired == 0);
+  CHECK(g_batch.skipped == 0);
+  CHECK(g_batch.has_sensor_time);
+  CHECK(g_batch.sensor_time == 10 * 64 + 20);
+  for (int i = 0; i < 5; i++) {
+    CHECK(frame_matches(g_batch.f[i], (int16_t)(100 * i)));
+    CHECK(g_batch.f[i].sensor_time == (uint32_t)(6 + i) * 64);
+  }
+  CHECK(g_fake.fifo_len == 0);
+}
+
+static void test_empty() {
+  fake_reset();
+  bmi2_dev dev;
+  make_dev(dev);
+  CHECK(g_fifo.read(dev, g_batch) == BMI2_W_FIFO_EMPTY);
+  CHECK(g_batch.count == 0);
+  CHECK(g_fake.fifo_reads == 0);  // length check avoids the burst
+}
+
+static void test_skip_frame() {
+  fake_reset();
+  bmi2_dev dev;
+  make_dev(dev);
+  push_skip(3);
+  push_frame(7);
+  push_frame(8);
+  g_fake.sensor_time = 1000;
+
+  CHECK(g_fifo.read(dev, g_batch) == BMI2_OK);
+  CHECK(g_batch.count == 2);
+  CHECK(g_batch.skipped == 3);
+  CHECK(frame_matches(g_batch.f[0], 7));
+  CHECK(frame_matches(g_batch.f[1], 8));
+}
+
+static void test_backlog_split() {
+  fake_reset();
+  bmi2_dev dev;
+  make_dev(dev);
+  for (int i = 0; i < Bmi270FifoBatch::MAX_FRAMES + 8; i++) push_frame((int16_t)i);
+  g_fake.sensor_time = 5000;
+
+  // More than one batch queued: whole frames only, no sensortime yet
+  CHECK(g_fifo.read(dev, g_batch) == BMI2_OK);
+  CHECK(g_batch.count == Bmi270FifoBatch::MAX_FRAMES);
+  CHECK(!g_batch.has_sensor_time);
+  CHECK(g_batch.f[0].sensor_time == 0);
+  for (int i = 0; i < Bmi270FifoBatch::MAX_FRAMES; i++) CHECK(frame_matches(g_batch.f[i], (int16_t)i));
+  CHECK(g_fake.fifo_len == 8 * 13);
+
+  // Remainder drains with sensortime, still frame-aligned
+  CHECK(g_fifo.read(dev, g_batch) == BMI2_OK);
+  CHECK(g_batch.count == 8);
+  CHECK(g_batch.has_sensor_time);
+  for (int i = 0; i < 8; i++) CHECK(frame_matches(g_batch.f[i], (int16_t)(Bmi270FifoBatch::MAX_FRAMES + i)));
+}
+
+static void test_full_batch_keeps_sensortime() {
+  fake_reset();
+  bmi2_dev dev;
+  make_dev(dev);
+  for (int i = 0; i < Bmi270FifoBatch::MAX_FRAMES; i++) push_frame((int16_t)i);
+  g_fake.sensor_time = 64 * 100;
+
+  CHECK(g_fifo.read(dev, g_batch) == BMI2_OK);
+  CHECK(g_batch.count == Bmi270FifoBatch::MAX_FRAMES);
+  CHECK(g_batch.has_sensor_time);
+  CHECK(g_batch.f[Bmi270FifoBatch::MAX_FRAMES - 1].sensor_time == 64 * 100);
+  CHECK(g_batch.f[0].sensor_time == 64 * (100 - (Bmi270FifoBatch::MAX_FRAMES - 1)));
+}
+
+static void test_sensortime_wrap() {
+  fake_reset();
+  bmi2_dev dev;
+  make_dev(dev);
+  for (int i = 0; i < 3; i++) push_frame((int16_t)i);
+  g_fake.sensor_time = 0x000010;  // counter just wrapped
+
+  CHECK(g_fifo.read(dev, g_batch) == BMI2_OK);
+  CHECK(g_batch.count == 3);
+  CHECK(g_batch.f[2].sensor_time == 0);
+  CHECK(g_batch.f[1].sensor_time == 0xFFFFC0);
+  CHECK(g_batch.f[0].sensor_time == 0xFFFF80);
+}
+
+// Captured dump (dummy byte + 2 frames + sensortime + over-read), parsed
+// without going through the fake device's FIFO stream.
+static void test_unpack_dump() {
+  fake_reset();
+  bmi2_dev dev;
+  make_dev(dev);
+
+  static const uint8_t dump[] = {
+    0xFF,
+    0x8C, 0x0A, 0x00, 0xF6, 0xFF, 0x00, 0x01, 0x00, 0x08, 0x00, 0xF8, 0x00, 0x00,
+    0x8C, 0x0B, 0x00, 0xF5, 0xFF, 0x01, 0x01, 0x01, 0x08, 0x01, 0xF8, 0xFF, 0xFF,
+    0x44, 0x50, 0x34, 0x12,
+    0x80, 0x00, 0x80, 0x00,
+  };
+  uint8_t buf[sizeof(dump)];
+  memcpy(buf, dump, sizeof(dump));
+
+  bmi2_fifo_frame fifo;
+  memset(&fifo, 0, sizeof(fifo));
+  fifo.data = buf;
+  fifo.length = sizeof(dump);
+  fifo.header_enable = 1;
+  fifo.data_enable = BMI2_FIFO_ACC_EN | BMI2_FIFO_GYR_EN;
+  fifo.acc_frm_len = 6;
+  fifo.gyr_frm_len = 6;
+  fifo.acc_gyr_frm_len = 12;
+
+  CHECK(g_fifo.unpack(fifo, dev, g_batch) == BMI2_OK);
+  CHECK(g_batch.count == 2);
+  CHECK(g_batch.f[0].gyr[0] == 10 && g_batch.f[0].gyr[1] == -10 && g_batch.f[0].gyr[2] == 256);
+  CHECK(g_batch.f[0].acc[0] == 2048 && g_batch.f[0].acc[1] == -2048 && g_batch.f[0].acc[2] == 0);
+  CHECK(g_batch.f[1].gyr[0] == 11 && g_batch.f[1].acc[2] == -1);
+  CHECK(g_batch.has_sensor_time);
+  CHECK(g_batch.sensor_time == 0x123450);
+  CHECK(g_batch.f[1].sensor_time == 0x123440);
+  CHECK(g_batch.f[0].sensor_time == 0x123400);
+}
+
+static void test_int1_watermark() {
+  fake_reset();
+  bmi2_dev dev;
+  make_dev(dev);
+
+  CHECK(g_fifo.enable_int1(dev, 2) == BMI2_OK);
+  const uint16_t wm = (uint16_t)(g_fake.regs[BMI2_FIFO_WTM_0_ADDR] | (g_fake.regs[BMI2_FIFO_WTM_0_ADDR + 1] << 8));
+  CHECK(wm == 2 * Bmi270Fifo::FRAME_BYTES);
+  CHECK(g_fake.regs[BMI2_INT1_IO_CTRL_ADDR] == 0x0A);     // output enable, push-pull, active high
+  CHECK(g_fake.regs[BMI2_INT_LATCH_ADDR] == 0x00);        // non-latched
+  CHECK(g_fake.regs[BMI2_INT_MAP_DATA_ADDR] == 0x02);     // fwm -> INT1
+}
+
+int main() {
+  test_drain_with_sensortime();
+  test_empty();
+  test_skip_frame();
+  test_backlog_split();
+  test_full_batch_keeps_sensortime();
+  test_sensortime_wrap();
+  test_unpack_dump();
+  test_int1_watermark();
+  return TEST_RESULT();
+}
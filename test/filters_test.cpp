@@ -0,0 +1,146 @@
+// Host tests for the fixed-point decimators in utils/filters.h.
+#include <math.h>
+
+#include "test_check.h"
+#include "utils/filters.h"
+
+static const double PI = 3.14159265358979323846;
+
+// Amplitude of a decimated sine: feed n inputs of amp*sin(2 pi f t) at fs,
+// return the peak |y| after the filter has settled
+template <class D>
+static double tone_gain(D &d, double f, double fs, double amp, int n)
+{
+  double peak = 0;
+  for (int i = 0; i < n; i++) {
+    const int16_t x[1] = { (int16_t)lround(amp * sin(2 * PI * f * i / fs)) };
+    int16_t y[1];
+    if (d.push(x, y) && i > n / 2) peak = fmax(peak, fabs((double)y[0]));
+  }
+  return peak / amp;
+}
+
+static void test_cic_dc_and_rate()
+{
+  CicDecimator<4, 2, 3> cic;
+  int outputs = 0;
+  int16_t y[3] = {0, 0, 0};
+  for (int i = 0; i < 400; i++) {
+    const int16_t x[3] = { 1000, -2500, 32767 };
+    if (cic.push(x, y)) outputs++;
+  }
+  CHECK(outputs == 100);
+  // Settled: exact DC gain, channels independent
+  CHECK(y[0] == 1000);
+  CHECK(y[1] == -2500);
+  CHECK(y[2] == 32767);
+
+  const int16_t m[3] = { -32768, -32768, -32768 };
+  for (int i = 0; i < 16; i++) cic.push(m, y);
+  CHECK(y[0] == -32768);
+}
+
+// R = 4, N = 2: impulse response is the triangle 1 2 3 4 3 2 1 (/16),
+// sampled every 4th input. Impulse at input 1, outputs at inputs 3, 7, 11.
+static void test_cic_impulse()
+{
+  CicDecimator<4, 2> cic;
+  int16_t y[1];
+  int16_t out[6];
+  int n = 0;
+  for (int i = 0; i < 24; i++) {
+    const int16_t x[1] = { (int16_t)(i == 1 ? 1600 : 0) };
+    if (cic.push(x, y)) out[n++] = y[0];
+  }
+  CHECK(n == 6);
+  CHECK(out[0] == 300);    // 1600 * 3 / 16
+  CHECK(out[1] == 100);    // 1600 * 1 / 16
+  CHECK(out[2] == 0);
+}
+
+// Integrators wrap around; the combs must still give the right answer after
+// many full-scale samples
+static void test_cic_wraparound()
+{
+  CicDecimator<8, 4> cic;
+  int16_t y[1] = {0};
+  for (int i = 0; i < 2000000; i++) {
+    const int16_t x[1] = { 32767 };
+    cic.push(x, y);
+  }
+  CHECK(y[0] == 32767);
+}
+
+static void test_cic_response()
+{
+  // Passband droop matches sinc^2 within rounding
+  CicDecimator<4, 2> a;
+  const double g50 = tone_gain(a, 50, 1600, 20000, 16000);
+  const double s50 = sin(PI * 50 * 4 / 1600) / (4 * sin(PI * 50 / 1600));
+  CHECK_NEAR(g50, s50 * s50, 0.01);
+
+  // A 400 Hz tone (vibration at the output rate) would alias to DC when
+  // simply subsampled; the CIC nulls it
+  CicDecimator<4, 2> b;
+  CHECK(tone_gain(b, 400, 1600, 20000, 16000) < 0.001);
+
+  // 380 Hz aliases to 20 Hz: knocked down > 25 dB
+  CicDecimator<4, 2> c;
+  CHECK(tone_gain(c, 380, 1600, 20000, 16000) < 0.05);
+}
+
+static void test_fir_dc_and_stopband()
+{
+  FirDecimator<4, 16, 2> fir(FIR_DECIM4_16_Q15);
+  int sum = 0;
+  for (int k = 0; k < 16; k++) sum += FIR_DECIM4_16_Q15[k];
+  CHECK(sum == 32768);
+
+  int16_t y[2] = {0, 0};
+  for (int i = 0; i < 64; i++) {
+    const int16_t x[2] = { 12345, -32768 };
+    fir.push(x, y);
+  }
+  CHECK(y[0] == 12345);
+  CHECK(y[1] == -32768);
+
+  FirDecimator<4, 16> a(FIR_DECIM4_16_Q15);
+  CHECK_NEAR(tone_gain(a, 50, 1600, 20000, 16000), 0.91, 0.02);   // -0.8 dB
+  FirDecimator<4, 16> b(FIR_DECIM4_16_Q15);
+  CHECK(tone_gain(b, 380, 1600, 20000, 16000) < 0.003);            // < -50 dB
+}
+
+// A 4-tap boxcar FIR decimating by 4 is a first-order CIC
+static void test_fir_boxcar_equals_cic1()
+{
+  static const int16_t box[4] = { 8192, 8192, 8192, 8192 };
+  FirDecimator<4, 4> fir(box);
+  CicDecimator<4, 1> cic;
+  uint32_t rng = 3;
+  int bad = 0, outputs = 0;
+  for (int i = 0; i < 40000; i++) {
+    rng = rng * 1664525u + 1013904223u;
+    const int16_t x[1] = { (int16_t)(rng >> 16) };
+    int16_t yf[1], yc[1];
+    const bool of = fir.push(x, yf);
+    const bool oc = cic.push(x, yc);
+    if (of != oc) bad++;
+    if (of && oc) {
+      outputs++;
+      if (yf[0] != yc[0]) bad++;
+    }
+  }
+  CHECK(outputs == 10000);
+  CHECK(bad == 0);
+}
+
+int main()
+{
+  test_cic_dc_and_rate();
+  test_cic_impulse();
+  test_cic_wraparound();
+  test_cic_response();
+  test_fir_dc_and_stopband();
+  test_fir_boxcar_equals_cic1();
+  return TEST_RESULT();
+}
@@ -0,0 +1,142 @@
+// Host tests for FlowGyroSync: flow intervals paired with the gyro
+// integral over the same interval, with IMU data arriving late in batches
+// as it does from the fast group.
+#include <math.h>
+
+#include "test_check.h"
+#include "sensors/flow/flow_gyro_sync.h"
+
+static const uint32_t IMU_DT = 2500;    // 400 Hz
+static const uint32_t FLOW_DT = 8264;   // ~121 Hz
+
+// Gyro x: constant 0.5 rad/s + 3 Hz sine; exact integral available
+static float gx(double t) { return 0.5f + 0.8f * (float)sin(2 * M_PI * 3.0 * t); }
+static double gx_int(double a, double b)
+{
+  const double w = 2 * M_PI * 3.0;
+  return 0.5 * (b - a) - 0.8 / w * (cos(w * b) - cos(w * a));
+}
+
+static void test_integral_matches_analytic()
+{
+  FlowGyroSync s;
+  const uint32_t t0 = 100000;
+  for (int i = 0; i < 60; i++) {
+    const uint32_t t = t0 + i * IMU_DT;
+    const float g[3] = { gx(t * 1e-6), -1.0f, 0.0f };
+    s.add_gyro(t, g);
+  }
+  float out[3];
+  // Interval not on sample boundaries
+  const uint32_t a = t0 + 3 * IMU_DT + 700, b = a + FLOW_DT;
+  CHECK(s.integrate(a, b, out));
+  CHECK_NEAR(out[0], gx_int(a * 1e-6, b * 1e-6), 2e-4);
+  CHECK_NEAR(out[1], -(double)FLOW_DT * 1e-6, 1e-6);
+  CHECK_NEAR(out[2], 0.0, 1e-9);
+
+  // Outside the history
+  CHECK(!s.integrate(t0 - 10, b, out));
+  CHECK(!s.integrate(a, t0 + 59 * IMU_DT + 1, out));
+}
+
+// Fast group pushes the IMU samples older than 2 ms every 5 ms (decimation
+// delay + batching); the flow group reads every 8.264 ms and pops what's
+// complete.
+static void test_live_pairing()
+{
+  FlowGyroSync s;
+  uint32_t t_imu = 1000000;      // next IMU sample time
+  uint32_t t_flow = 1000000 + 1234;
+  uint32_t popped = 0, ok = 0;
+  double worst = 0;
+  uint32_t last_t1 = 0;
+  bool chain = true;
+
+  for (uint32_t now = 1000000; now < 1000000 + 2000000; now += 100) {
+    // Fast tick: samples up to now - 2 ms (decimation delay + batching)
+    if (now % 5000 == 0) {
+      while ((int32_t)(now - 2000 - t_imu) >= 0) {
+        const float g[3] = { gx(t_imu * 1e-6), 0.1f, 0.0f };
+        s.add_gyro(t_imu, g);
+        t_imu += IMU_DT;
+      }
+    }
+    if ((int32_t)(now - t_flow) >= 0) {
+      s.add_flow(t_flow, 10, -3, 90, true);
+      t_flow += FLOW_DT;
+      FlowDelta d;
+      while (s.pop(d, now)) {
+        popped++;
+        if (last_t1 && d.t0_us != last_t1) chain = false;
+        last_t1 = d.t1_us;
+        if (!d.gyro_ok) continue;
+        ok++;
+        const double err = fabs(d.gyro_rad[0] - gx_int(d.t0_us * 1e-6, d.t1_us * 1e-6));
+        if (err > worst) worst = err;
+        CHECK(d.dx == 10 && d.dy == -3 && d.motion);
+      }
+    }
+  }
+  CHECK(popped > 230);           // ~242 intervals in 2 s
+  CHECK(ok == popped);           // the gyro always caught up in time
+  CHECK(chain);                  // contiguous intervals, nothing skipped
+  CHECK(worst < 2e-4);
+  CHECK(s.dropped() == 0 && s.gaps() == 0 && s.gyro_restarts() == 0);
+}
+
+static void test_waits_for_gyro_then_gives_up()
+{
+  FlowGyroSync s;
+  const float g[3] = { 1, 0, 0 };
+  for (int i = 0; i < 4; i++) s.add_gyro(i * IMU_DT, g);
+  s.add_flow(5000, 0, 0, 50, false);
+  s.add_flow(5000 + FLOW_DT, 4, 4, 50, false);   // no motion: deltas forced to 0
+
+  FlowDelta d;
+  CHECK(!s.pop(d, 5000 + FLOW_DT));              // gyro only up to 7.5 ms
+  for (int i = 4; i < 7; i++) s.add_gyro(i * IMU_DT, g);
+  CHECK(s.pop(d, 5000 + FLOW_DT));
+  CHECK(d.gyro_ok && !d.motion && d.dx == 0 && d.dy == 0);
+  CHECK_NEAR(d.gyro_rad[0], FLOW_DT * 1e-6, 1e-6);
+
+  // Gyro stops: handed out after MAX_WAIT_US without it
+  s.add_flow(5000 + 2 * FLOW_DT, 1, 1, 50, true);
+  CHECK(!s.pop(d, 5000 + 2 * FLOW_DT + FlowGyroSync::MAX_WAIT_US - 1));
+  CHECK(s.pop(d, 5000 + 2 * FLOW_DT + FlowGyroSync::MAX_WAIT_US));
+  CHECK(!d.gyro_ok && d.dx == 1);
+}
+
+static void test_gaps_and_wrap()
+{
+  FlowGyroSync s;
+  // Missed flow reads: the long interval is dropped, the next one is fine
+  s.add_flow(0, 0, 0, 0, true);
+  s.add_flow(FlowGyroSync::MAX_FLOW_DT_US + 1, 0, 0, 0, true);
+  CHECK(s.gaps() == 1);
+  FlowDelta d;
+  CHECK(!s.pop(d, 0xFFFFFFu));
+
+  // Gyro hole restarts the history
+  const float g[3] = { 1, 1, 1 };
+  s.add_gyro(0, g);
+  s.add_gyro(IMU_DT, g);
+  s.add_gyro(IMU_DT + FlowGyroSync::MAX_GYRO_DT_US + 1, g);
+  CHECK(s.gyro_restarts() == 1);
+
+  // Interval straddling the micros() wrap
+  FlowGyroSync w;
+  const uint32_t base = 0xFFFFFFFFu - 20000;
+  for (int i = 0; i < 20; i++) w.add_gyro(base + i * IMU_DT, g);
+  float out[3];
+  CHECK(w.integrate(base + 10000, base + 10000 + FLOW_DT, out));
+  CHECK_NEAR(out[0], FLOW_DT * 1e-6, 1e-6);
+}
+
+int main()
+{
+  test_integral_matches_analytic();
+  test_live_pairing();
+  test_waits_for_gyro_then_gives_up();
+  test_gaps_and_wrap();
+  return TEST_RESULT();
+}
@@ -0,0 +1,155 @@
+// Host tests for flow_velocity(): synthetic rotation-only and
+// translation-only intervals through the airframe's FLOW_OPTICS.
+#include <math.h>
+
+#include "test_check.h"
+#include "config/flow_config.h"
+
+static const FlowOptics& O = FLOW_OPTICS;
+static const uint32_t DT_US = 8264;
+
+// Body-frame image motion (rad) -> sensor counts, inverting O.body
+static void to_counts(const float flow_b[2], int16_t& dx, int16_t& dy)
+{
+  float c[2] = {0, 0};
+  for (int i = 0; i < 2; i++) {
+    c[O.body[i].src] = (O.body[i].sign < 0 ? -flow_b[i] : flow_b[i]) * O.px_per_rad;
+  }
+  dx = (int16_t)lroundf(c[0]);
+  dy = (int16_t)lroundf(c[1]);
+}
+
+// Body F/R rotation (rad) -> FRU gyro integral, inverting O.rot
+static void to_gyro(const float rot_b[2], float g[3])
+{
+  g[0] = g[1] = g[2] = 0;
+  for (int i = 0; i < 2; i++) {
+    g[O.rot[i].src] = O.rot[i].sign < 0 ? -rot_b[i] : rot_b[i];
+  }
+}
+
+static FlowDelta delta(int16_t dx, int16_t dy, const float g[3])
+{
+  FlowDelta d;
+  d.t0_us = 5000000;
+  d.t1_us = d.t0_us + DT_US;
+  d.dx = dx;
+  d.dy = dy;
+  d.gyro_rad[0] = g[0];
+  d.gyro_rad[1] = g[1];
+  d.gyro_rad[2] = g[2];
+  d.squal = 100;
+  d.motion = (dx || dy);
+  d.gyro_ok = true;
+  return d;
+}
+
+static void test_translation_only()
+{
+  // Whole counts so the check isn't about quantization
+  const float h = 0.5f, dt = DT_US * 1e-6f;
+  const float flow_b[2] = { 12 / O.px_per_rad, -5 / O.px_per_rad };
+  int16_t dx, dy;
+  to_counts(flow_b, dx, dy);
+  const float g0[3] = { 0, 0, 0 };
+
+  FlowVelocity v;
+  CHECK(flow_velocity(delta(dx, dy, g0), h, O, v));
+  CHECK(v.valid && v.reject == FlowReject::NONE);
+  CHECK_NEAR(v.v_m_s[0], flow_b[0] * h / dt, 1e-4);
+  CHECK_NEAR(v.v_m_s[1], flow_b[1] * h / dt, 1e-4);
+  CHECK(v.v_m_s[0] > 0 && v.v_m_s[1] < 0);
+  CHECK_NEAR(v.dt_s, dt, 1e-9);
+  CHECK(v.t_us == 5000000 + DT_US / 2);
+
+  // Same image motion twice as high: twice as fast
+  FlowVelocity v2;
+  CHECK(flow_velocity(delta(dx, dy, g0), 2 * h, O, v2));
+  CHECK_NEAR(v2.v_m_s[0], 2 * v.v_m_s[0], 1e-4);
+
+  // Hover, no motion: zero, not rejected
+  CHECK(flow_velocity(delta(0, 0, g0), h, O, v));
+  CHECK(v.v_m_s[0] == 0 && v.v_m_s[1] == 0);
+}
+
+static void test_rotation_only()
+{
+  // Pitch/roll over a fixed point: the image moves, the craft doesn't
+  const float h = 0.8f;
+  for (int k = -3; k <= 3; k++) {
+    const float rot_b[2] = { k * 7 / O.px_per_rad, -k * 4 / O.px_per_rad };
+    int16_t dx, dy;
+    to_counts(rot_b, dx, dy);
+    float g[3];
+    to_gyro(rot_b, g);
+    g[2] = 0.05f;   // yaw doesn't move a centred image
+
+    FlowVelocity v;
+    CHECK(flow_velocity(delta(dx, dy, g), h, O, v));
+    CHECK_NEAR(v.v_m_s[0], 0.0, 1e-4);
+    CHECK_NEAR(v.v_m_s[1], 0.0, 1e-4);
+    CHECK_NEAR(v.rot_rad[0], rot_b[0], 1e-7);
+    CHECK_NEAR(v.flow_rad[0], rot_b[0], 1e-7);
+    // Uncompensated this would have read ~k * 1.4 m/s
+  }
+}
+
+static void test_translation_plus_rotation()
+{
+  const float h = 1.2f, dt = DT_US * 1e-6f;
+  const float trans_b[2] = { 9 / O.px_per_rad, 3 / O.px_per_rad };
+  const float rot_b[2] = { -4 / O.px_per_rad, 6 / O.px_per_rad };
+  const float flow_b[2] = { trans_b[0] + rot_b[0], trans_b[1] + rot_b[1] };
+  int16_t dx, dy;
+  to_counts(flow_b, dx, dy);
+  float g[3];
+  to_gyro(rot_b, g);
+
+  FlowVelocity v;
+  CHECK(flow_velocity(delta(dx, dy, g), h, O, v));
+  CHECK_NEAR(v.v_m_s[0], trans_b[0] * h / dt, 1e-4);
+  CHECK_NEAR(v.v_m_s[1], trans_b[1] * h / dt, 1e-4);
+}
+
+static void test_gating()
+{
+  const float g0[3] = { 0, 0, 0 };
+  FlowVelocity v;
+
+  FlowDelta d = delta(10, 10, g0);
+  d.squal = O.min_squal - 1;
+  CHECK(!flow_velocity(d, 0.5f, O, v));
+  CHECK(v.reject == FlowReject::QUALITY && !v.valid);
+  CHECK(v.v_m_s[0] == 0 && v.flow_rad[0] != 0);   // diagnostics still filled
+  d.squal = O.min_squal;
+  CHECK(flow_velocity(d, 0.5f, O, v));
+
+  d = delta(10, 10, g0);
+  d.gyro_ok = false;
+  CHECK(!flow_velocity(d, 0.5f, O, v) && v.reject == FlowReject::NO_GYRO);
+
+  d = delta(10, 10, g0);
+  CHECK(!flow_velocity(d, 0.05f, O, v) && v.reject == FlowReject::HEIGHT);
+  CHECK(!flow_velocity(d, 5.0f, O, v) && v.reject == FlowReject::HEIGHT);
+  CHECK(!flow_velocity(d, NAN, O, v) && v.reject == FlowReject::HEIGHT);
+
+  d.t1_us = d.t0_us;
+  CHECK(!flow_velocity(d, 0.5f, O, v) && v.reject == FlowReject::INTERVAL);
+
+  // 7.4 rad/s over 8.264 ms is ~30 counts
+  d = delta(40, 0, g0);
+  CHECK(!flow_velocity(d, 0.5f, O, v) && v.reject == FlowReject::RATE);
+  d = delta(2, 0, g0);
+  CHECK(flow_velocity(d, 0.5f, O, v));
+
+  CHECK(flow_reject_name(FlowReject::QUALITY)[0] == 's');
+}
+
+int main()
+{
+  test_translation_only();
+  test_rotation_only();
+  test_translation_plus_rotation();
+  test_gating();
+  return TEST_RESULT();
+}
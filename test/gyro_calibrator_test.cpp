@@ -0,0 +1,175 @@
+// Host tests for GyroCalibrator with synthetic still / moving IMU streams.
+#include <math.h>
+
+#include "test_check.h"
+#include "sensors/imu/gyro_calibrator.h"
+
+static const float BIAS[3] = { 0.012f, -0.021f, 0.004f };   // rad/s
+
+// Deterministic noise in [-amp, amp]
+static uint32_t g_rng = 1;
+static float noise(float amp)
+{
+  g_rng = g_rng * 1664525u + 1013904223u;
+  return amp * ((float)(g_rng >> 8) / 8388608.0f - 1.0f);
+}
+
+// Level, still: 1 g on z, gyro = bias + noise
+static void still_sample(float a[3], float g[3])
+{
+  a[0] = noise(0.05f);
+  a[1] = noise(0.05f);
+  a[2] = GyroCalibrator::G + noise(0.05f);
+  for (int i = 0; i < 3; i++) g[i] = BIAS[i] + noise(0.01f);
+}
+
+// Being turned by hand: ~1 rad/s about z
+static void moving_sample(float a[3], float g[3])
+{
+  still_sample(a, g);
+  g[2] += 1.0f;
+}
+
+// Feed n samples; returns how many add() calls returned true
+static int feed(GyroCalibrator &cal, int n, void (*gen)(float *, float *))
+{
+  int finished = 0;
+  for (int i = 0; i < n; i++) {
+    float a[3], g[3];
+    gen(a, g);
+    if (cal.add(a, g)) finished++;
+  }
+  return finished;
+}
+
+static void test_still_converges()
+{
+  GyroCalibrator cal;
+  cal.start();
+  CHECK(!cal.has_bias());
+
+  CHECK(feed(cal, GyroCalibrator::TARGET_SAMPLES - 1, still_sample) == 0);
+  CHECK(!cal.done());
+  CHECK(cal.still());
+  CHECK_NEAR(cal.progress(), (GyroCalibrator::TARGET_SAMPLES - 1) / (double)GyroCalibrator::TARGET_SAMPLES, 1e-6);
+
+  CHECK(feed(cal, 1, still_sample) == 1);
+  CHECK(cal.done());
+  CHECK(cal.source() == GyroCalibrator::Source::MEASURED);
+  for (int i = 0; i < 3; i++) CHECK_NEAR(cal.bias()[i], BIAS[i], 0.002);
+
+  // Done: further samples are ignored
+  const float b0 = cal.bias()[0];
+  CHECK(feed(cal, 100, moving_sample) == 0);
+  CHECK(cal.bias()[0] == b0);
+  CHECK(cal.samples() == GyroCalibrator::TARGET_SAMPLES);
+}
+
+static void test_moving_never_converges()
+{
+  GyroCalibrator cal;
+  cal.start();
+  CHECK(feed(cal, 5000, moving_sample) == 0);
+  CHECK(!cal.done());
+  CHECK(!cal.still());
+  CHECK(cal.still_count() == 0);
+  CHECK(!cal.has_bias());
+}
+
+// Motion part-way through restarts the window; the bias excludes it
+static void test_motion_resets_window()
+{
+  GyroCalibrator cal;
+  cal.start();
+  feed(cal, 300, still_sample);
+  feed(cal, 10, moving_sample);
+  CHECK(cal.still_count() == 0);
+  CHECK(cal.motion_resets() == 1);
+
+  feed(cal, 50, still_sample);
+  feed(cal, 1, moving_sample);
+  CHECK(cal.motion_resets() == 2);
+
+  CHECK(feed(cal, GyroCalibrator::TARGET_SAMPLES, still_sample) == 1);
+  CHECK(cal.done());
+  for (int i = 0; i < 3; i++) CHECK_NEAR(cal.bias()[i], BIAS[i], 0.002);
+}
+
+// Free fall / being carried: gyro quiet but |acc| far from 1 g
+static void test_accel_gate()
+{
+  GyroCalibrator cal;
+  cal.start();
+  for (int i = 0; i < 1000; i++) {
+    float a[3], g[3];
+    still_sample(a, g);
+    a[2] = 2.0f;
+    CHECK(!cal.add(a, g));
+  }
+  CHECK(!cal.done());
+  CHECK(cal.still_count() == 0);
+}
+
+// Warm boot: a good seed is usable at once and confirmed in SEED_CHECK_SAMPLES
+static void test_seed_confirmed()
+{
+  const float seed[3] = { BIAS[0] + 0.001f, BIAS[1] - 0.001f, BIAS[2] };
+  GyroCalibrator cal;
+  cal.start(seed);
+  CHECK(cal.has_bias());
+  CHECK(!cal.done());
+  CHECK(cal.target() == GyroCalibrator::SEED_CHECK_SAMPLES);
+  CHECK(cal.bias()[0] == seed[0]);
+
+  CHECK(feed(cal, GyroCalibrator::SEED_CHECK_SAMPLES, still_sample) == 1);
+  CHECK(cal.done());
+  CHECK(cal.source() == GyroCalibrator::Source::SEED);
+  CHECK(!cal.seed_rejected());
+  CHECK(cal.bias()[1] == seed[1]);
+  // 32 samples at 400 Hz
+  CHECK(GyroCalibrator::SEED_CHECK_SAMPLES * 2500 <= 100000);
+}
+
+// Stale seed: rejected after the short check, full window measured instead
+static void test_seed_rejected()
+{
+  const float seed[3] = { BIAS[0] + 0.03f, BIAS[1], BIAS[2] };
+  GyroCalibrator cal;
+  cal.start(seed);
+
+  CHECK(feed(cal, GyroCalibrator::SEED_CHECK_SAMPLES, still_sample) == 0);
+  CHECK(cal.seed_rejected());
+  CHECK(!cal.done());
+  CHECK(cal.source() == GyroCalibrator::Source::SEED);   // still used meanwhile
+  CHECK(cal.target() == GyroCalibrator::TARGET_SAMPLES);
+
+  // Continues from the samples already collected
+  CHECK(feed(cal, GyroCalibrator::TARGET_SAMPLES - GyroCalibrator::SEED_CHECK_SAMPLES, still_sample) == 1);
+  CHECK(cal.done());
+  CHECK(cal.source() == GyroCalibrator::Source::MEASURED);
+  for (int i = 0; i < 3; i++) CHECK_NEAR(cal.bias()[i], BIAS[i], 0.002);
+}
+
+static void test_restart()
+{
+  GyroCalibrator cal;
+  cal.start();
+  feed(cal, GyroCalibrator::TARGET_SAMPLES, still_sample);
+  CHECK(cal.done());
+  cal.start();
+  CHECK(!cal.done());
+  CHECK(cal.samples() == 0);
+  CHECK(!cal.has_bias());
+}
+
+int main()
+{
+  test_still_converges();
+  test_moving_never_converges();
+  test_motion_resets_window();
+  test_accel_gate();
+  test_seed_confirmed();
+  test_seed_rejected();
+  test_restart();
+  return TEST_RESULT();
+}
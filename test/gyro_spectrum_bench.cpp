@@ -0,0 +1,91 @@
+// Host microbenchmark: gyro analyzer cost per frame (GyroSpectrum::process,
+// 3 axes of 128-point FFT + peak search) and notch bank cost per sample
+// (GyroNotchBank::apply with every notch on). Cycles are TSC cycles on x86
+// (ns otherwise). On target the same numbers show up as the "spec" and
+// "notch" [prof] zones.
+#include <stdio.h>
+#include <math.h>
+#include <chrono>
+
+#include "sensors/imu/gyro_spectrum.h"
+#include "sensors/imu/gyro_notch.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+static inline uint64_t cycles() { return __rdtsc(); }
+#define HAVE_CYCLES 1
+#else
+static inline uint64_t cycles() { return 0; }
+#define HAVE_CYCLES 0
+#endif
+
+static volatile float g_sink;
+
+static void report(const char *name, uint64_t cyc, double ns, uint32_t n, const char *unit)
+{
+#if HAVE_CYCLES
+  printf("%-26s %9.1f cycles/%s  %8.2f us/%s\n", name, (double)cyc / n, unit, ns / n * 1e-3, unit);
+#else
+  (void)cyc;
+  printf("%-26s %8.2f us/%s\n", name, ns / n * 1e-3, unit);
+#endif
+}
+
+int main()
+{
+  const float FS = 400.0f;
+  static GyroSpectrum sp(FS);
+
+  // Two tones per axis so the peak search and tracker do real work
+  double ph = 0;
+  auto sample = [&](float g[3]) {
+    ph += 2.0 * 3.14159265358979 / FS;
+    g[0] = (float)(0.2 * sin(150.0 * ph) + 0.05 * sin(97.0 * ph));
+    g[1] = (float)(0.1 * sin(120.0 * ph) + 0.05 * sin(171.0 * ph));
+    g[2] = (float)(0.1 * sin(140.0 * ph));
+  };
+
+  float g[3];
+  for (int i = 0; i < GyroSpectrum::N; i++) {
+    sample(g);
+    sp.push(g);
+  }
+
+  constexpr uint32_t FRAMES = 20000;
+  uint64_t cyc = 0;
+  double ns = 0;
+  for (uint32_t f = 0; f < FRAMES; f++) {
+    for (int i = 0; i < GyroSpectrum::HOP; i++) {
+      sample(g);
+      sp.push(g);
+    }
+    const uint64_t c0 = cycles();
+    auto t0 = std::chrono::steady_clock::now();
+    sp.process();
+    auto t1 = std::chrono::steady_clock::now();
+    cyc += cycles() - c0;
+    ns += std::chrono::duration<double, std::nano>(t1 - t0).count();
+  }
+  g_sink = sp.peaks().axis[0][0].hz;
+  report("GyroSpectrum::process", cyc, ns, FRAMES, "frame");
+
+  GyroNotchBank nb(FS);
+  nb.set(sp.peaks());
+  printf("  (notches on: %u)\n", (unsigned)nb.active_count());
+
+  constexpr uint32_t SAMPLES = 4 * 1000 * 1000;
+  float acc = 0;
+  const uint64_t c0 = cycles();
+  auto t0 = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < SAMPLES; i++) {
+    float v[3] = { (float)(i & 255), (float)((i >> 3) & 255), 1.0f };
+    nb.apply(v);
+    acc += v[0] + v[1] + v[2];
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  const uint64_t c1 = cycles();
+  g_sink = acc;
+  report("GyroNotchBank::apply", c1 - c0, std::chrono::duration<double, std::nano>(t1 - t0).count(),
+         SAMPLES, "sample");
+  return 0;
+}
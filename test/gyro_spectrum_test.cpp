@@ -0,0 +1,248 @@
+// Host tests for the gyro vibration analyzer and dynamic notch bank
+// (RealFft, GyroSpectrum, GyroNotchBank) on synthetic gyro streams at the
+// decimated IMU rate, plus the ring/snapshot that carry data between the
+// fast and spec groups.
+#include <math.h>
+
+#include "test_check.h"
+#include "utils/fft.h"
+#include "utils/spsc.h"
+#include "sensors/imu/gyro_spectrum.h"
+#include "sensors/imu/gyro_notch.h"
+
+static const float FS = 400.0f;
+static const float PI = 3.14159265358979f;
+
+static uint32_t g_rng = 11;
+static float noise(float amp)
+{
+  g_rng = g_rng * 1664525u + 1013904223u;
+  return amp * ((float)(g_rng >> 8) / 8388608.0f - 1.0f);
+}
+
+// Body motion (5 Hz, outside the band) + broadband noise + motor tones
+struct Tone {
+  float hz;
+  float amp;
+};
+
+struct Synth {
+  double phase[3][2] = {};
+  uint32_t n = 0;
+
+  void next(const Tone tones[3][2], float g[3])
+  {
+    const float t = n++ / FS;
+    for (int a = 0; a < 3; a++) {
+      float v = 0.4f * sinf(2 * PI * 5.0f * t + a) + noise(0.02f);
+      for (int k = 0; k < 2; k++) {
+        phase[a][k] += 2.0 * PI * tones[a][k].hz / FS;
+        v += tones[a][k].amp * (float)sin(phase[a][k]);
+      }
+      g[a] = v;
+    }
+  }
+};
+
+// Run the analyzer for `seconds` on fixed tones
+static void run(GyroSpectrum& sp, Synth& syn, const Tone tones[3][2], float seconds)
+{
+  const int n = (int)(seconds * FS);
+  for (int i = 0; i < n; i++) {
+    float g[3];
+    syn.next(tones, g);
+    if (sp.push(g)) sp.process();
+  }
+}
+
+static void test_fft_matches_dft()
+{
+  constexpr uint16_t N = 128;
+  static RealFft<N> fft;
+  float x[N], p[RealFft<N>::BINS];
+  for (int i = 0; i < N; i++) x[i] = noise(1.0f) + 0.3f * sinf(2 * PI * 17 * i / N);
+  fft.power(x, p, false);
+
+  float mean = 0;
+  for (int i = 0; i < N; i++) mean += x[i];
+  mean /= N;
+  double worst = 0, peak = 0;
+  for (int k = 0; k <= N / 2; k++) {
+    double re = 0, im = 0;
+    for (int i = 0; i < N; i++) {
+      re += (x[i] - mean) * cos(2.0 * M_PI * k * i / N);
+      im -= (x[i] - mean) * sin(2.0 * M_PI * k * i / N);
+    }
+    const double ref = re * re + im * im;
+    if (ref > peak) peak = ref;
+    if (fabs(p[k] - ref) > worst) worst = fabs(p[k] - ref);
+  }
+  CHECK(worst < 1e-4 * peak);
+  CHECK(p[17] > 0.5 * peak);
+}
+
+static void test_tracks_fixed_tones()
+{
+  GyroSpectrum sp(FS);
+  Synth syn;
+  const Tone tones[3][2] = {
+    { {150.0f, 0.20f}, {0, 0} },
+    { {97.3f, 0.10f}, {171.0f, 0.05f} },
+    { {0, 0}, {0, 0} },                    // z: noise and body motion only
+  };
+  run(sp, syn, tones, 2.0f);
+
+  const GyroPeaks& pk = sp.peaks();
+  CHECK(pk.frame > 20);
+
+  CHECK(pk.axis[0][0].valid);
+  CHECK_NEAR(pk.axis[0][0].hz, 150.0, 0.5);
+  CHECK(!pk.axis[0][1].valid);
+
+  // Strongest claims slot 0
+  CHECK(pk.axis[1][0].valid && pk.axis[1][1].valid);
+  CHECK_NEAR(pk.axis[1][0].hz, 97.3, 0.5);
+  CHECK_NEAR(pk.axis[1][1].hz, 171.0, 0.5);
+  CHECK(pk.axis[1][0].snr_db > pk.axis[1][1].snr_db);
+
+  // Body motion at 5 Hz and white noise are not peaks
+  CHECK(!pk.axis[2][0].valid && !pk.axis[2][1].valid);
+}
+
+// Throttle ramp: 100 -> 160 Hz in 4 s. Lag is the window's own delay
+// (N/2 samples = 160 ms) plus the EMA.
+static void test_follows_sweep()
+{
+  GyroSpectrum sp(FS);
+  double phase = 0;
+  float worst = 0;
+  for (int i = 0; i < (int)(4.0f * FS); i++) {
+    const float t = i / FS;
+    const float f = 100.0f + 15.0f * t;
+    phase += 2.0 * PI * f / FS;
+    const float g[3] = { 0.15f * (float)sin(phase) + noise(0.02f), noise(0.02f), noise(0.02f) };
+    if (!sp.push(g)) continue;
+    sp.process();
+    if (t < 0.5f) continue;
+    const GyroPeak& p = sp.peaks().axis[0][0];
+    CHECK(p.valid);
+    const float err = fabsf(p.hz - f);
+    if (err > worst) worst = err;
+  }
+  CHECK(worst < 5.0f);
+}
+
+static void test_peak_drops_out()
+{
+  GyroSpectrum sp(FS);
+  Synth syn;
+  const Tone on[3][2] = { { {130.0f, 0.2f}, {0, 0} }, {}, {} };
+  const Tone off[3][2] = {};
+  run(sp, syn, on, 1.0f);
+  CHECK(sp.peaks().axis[0][0].valid);
+
+  // Motors stop: stays valid while the old tone is in the window, then
+  // HOLD_FRAMES more
+  run(sp, syn, off, (GyroSpectrum::N + GyroSpectrum::HOP * (GyroSpectrum::HOLD_FRAMES + 1)) / FS);
+  CHECK(!sp.peaks().axis[0][0].valid);
+}
+
+static float rms_gain(GyroNotchBank& nb, uint8_t axis, float hz)
+{
+  double in2 = 0, out2 = 0;
+  for (int i = 0; i < 4000; i++) {
+    float g[3] = { 0, 0, 0 };
+    g[axis] = sinf(2 * PI * hz * i / FS);
+    const float x = g[axis];
+    nb.apply(g);
+    if (i < 1000) continue;    // settle
+    in2 += x * x;
+    out2 += g[axis] * g[axis];
+  }
+  return (float)sqrt(out2 / in2);
+}
+
+static void test_notch_bank_on_tracked_peaks()
+{
+  GyroSpectrum sp(FS);
+  Synth syn;
+  const Tone tones[3][2] = { { {150.0f, 0.2f}, {0, 0} }, {}, {} };
+  run(sp, syn, tones, 2.0f);
+
+  GyroNotchBank nb(FS);
+  nb.set(sp.peaks());
+  CHECK(nb.active(0, 0));
+  CHECK(!nb.active(0, 1) && !nb.active(1, 0));
+  CHECK(nb.active_count() == 1);
+  CHECK(nb.retunes() == 1);
+
+  CHECK(rms_gain(nb, 0, 150.0f) < 0.1f);      // > 20 dB on the tone
+  CHECK(rms_gain(nb, 0, 20.0f) > 0.98f);      // control band untouched
+  CHECK(rms_gain(nb, 1, 150.0f) > 0.999f);    // no notch on y
+
+  // Small moves don't retune; invalid peaks switch the notch off
+  GyroPeaks p = sp.peaks();
+  p.axis[0][0].hz += 0.2f;
+  nb.set(p);
+  CHECK(nb.retunes() == 1);
+  p.axis[0][0].hz += 2.0f;
+  nb.set(p);
+  CHECK(nb.retunes() == 2);
+  CHECK_NEAR(nb.hz(0, 0), p.axis[0][0].hz, 1e-6);
+  p.axis[0][0].valid = false;
+  nb.set(p);
+  CHECK(nb.active_count() == 0);
+  CHECK(rms_gain(nb, 0, 150.0f) > 0.999f);
+}
+
+static void test_notch_response()
+{
+  BiquadCoeffs c = biquad_notch(100.0f, 4.0f, FS);
+  // |H| at DC = 1, at f0 = 0
+  CHECK_NEAR((c.b0 + c.b1 + c.b2) / (1 + c.a1 + c.a2), 1.0, 1e-5);
+  Biquad b;
+  b.set(c);
+  double out2 = 0;
+  for (int i = 0; i < 4000; i++) {
+    const float y = b.step(sinf(2 * PI * 100.0f * i / FS));
+    if (i >= 1000) out2 += y * y;
+  }
+  CHECK(sqrt(out2 / 1500.0) < 0.01);
+}
+
+static void test_ring_and_snapshot()
+{
+  SpscRing<int, 4> r;
+  int v = 0;
+  CHECK(!r.pop(v));
+  for (int i = 0; i < 4; i++) CHECK(r.push(i));
+  CHECK(!r.push(99));
+  CHECK(r.dropped() == 1);
+  for (int i = 0; i < 4; i++) CHECK(r.pop(v) && v == i);
+  CHECK(!r.pop(v));
+  // Indices wrap past uint16
+  for (int i = 0; i < 70000; i++) {
+    r.push(i);
+    CHECK(r.pop(v) && v == i);
+  }
+
+  SpscSnapshot<GyroPeaks> s;
+  GyroPeaks p;
+  CHECK(!s.read(p));
+  p.frame = 7;
+  s.write(p);
+  GyroPeaks q;
+  CHECK(s.read(q) && q.frame == 7);
+}
+
+int main()
+{
+  test_fft_matches_dft();
+  test_tracks_fixed_tones();
+  test_follows_sweep();
+  test_peak_drops_out();
+  test_notch_bank_on_tracked_peaks();
+  test_notch_response();
+  test_ring_and_snapshot();
+  return TEST_RESULT();
+}
@@ -0,0 +1,209 @@
+// Host tests for GyroTempBias with synthetic temperature ramps.
+#include <math.h>
+
+#include "test_check.h"
+#include "sensors/imu/gyro_temp_bias.h"
+
+// True bias: linear in temperature, different per axis (rad/s, rad/s/°C)
+static const float B25[3] = { 0.010f, -0.020f, 0.004f };
+static const float K[3] = { 0.0006f, -0.0004f, 0.0002f };   // ~34/-23/11 mdps/°C
+
+static void true_bias(float t, float b[3])
+{
+  for (int i = 0; i < 3; i++) b[i] = B25[i] + K[i] * (t - 25.0f);
+}
+
+static uint32_t g_rng = 7;
+static float noise(float amp)
+{
+  g_rng = g_rng * 1664525u + 1013904223u;
+  return amp * ((float)(g_rng >> 8) / 8388608.0f - 1.0f);
+}
+
+static void sample(float t, bool moving, float a[3], float g[3])
+{
+  float b[3];
+  true_bias(t, b);
+  a[0] = noise(0.05f);
+  a[1] = noise(0.05f);
+  a[2] = GyroTempBias::G + noise(0.05f);
+  for (int i = 0; i < 3; i++) g[i] = b[i] + noise(0.01f);
+  if (moving) g[0] += 0.8f;
+}
+
+static float max_err(const GyroTempBias &m, float t)
+{
+  float b[3], e[3];
+  true_bias(t, b);
+  m.bias(t, e);
+  float worst = 0;
+  for (int i = 0; i < 3; i++) worst = fmaxf(worst, fabsf(e[i] - b[i]));
+  return worst;
+}
+
+// Boot-calibrated at 25 °C, then the board warms to 45 °C over 2 min of
+// 400 Hz samples, still the whole time
+static void test_warmup_ramp_tracked()
+{
+  GyroTempBias m;
+  float b0[3];
+  true_bias(25.0f, b0);
+  m.seed(b0, 25.0f);
+  CHECK(m.ready());
+  CHECK(!m.sloped());
+
+  const int N = 120 * 400;
+  for (int i = 0; i < N; i++) {
+    const float t = 25.0f + 20.0f * i / N;
+    float a[3], g[3];
+    sample(t, false, a, g);
+    m.add(a, g, t);
+  }
+  CHECK(m.sloped());
+  CHECK(m.bins_used() >= 20);
+  for (int i = 0; i < 3; i++) CHECK_NEAR(m.slope(i), K[i], 0.00005);
+
+  // Within ~0.06 deg/s anywhere on the ramp; a static boot bias is off
+  // by 0.012 rad/s (0.7 deg/s) on x at 45 °C
+  CHECK(max_err(m, 45.0f) < 0.001f);
+  CHECK(max_err(m, 35.0f) < 0.001f);
+  CHECK(fabsf(B25[0] - (B25[0] + K[0] * 20.0f)) > 0.01f);
+}
+
+// Flying: mostly moving, short still stretches; motion is rejected and the
+// still windows still carry the model up the ramp
+static void test_ramp_with_motion()
+{
+  GyroTempBias m;
+  float b0[3];
+  true_bias(25.0f, b0);
+  m.seed(b0, 25.0f);
+
+  const int N = 300 * 400;
+  for (int i = 0; i < N; i++) {
+    const float t = 25.0f + 15.0f * i / N;
+    const bool moving = (i % 1950) < 1500;        // 3.75 s moving, 1.1 s still
+    float a[3], g[3];
+    sample(t, moving, a, g);
+    m.add(a, g, t);
+  }
+  CHECK(m.windows_rejected() > 0);
+  CHECK(m.sloped());
+  CHECK(max_err(m, 40.0f) < 0.0015f);
+}
+
+// A window broken by motion never becomes an observation
+static void test_partial_window_rejected()
+{
+  GyroTempBias m;
+  float a[3], g[3];
+  for (int i = 0; i < GyroTempBias::WINDOW - 1; i++) {
+    sample(30.0f, false, a, g);
+    CHECK(!m.add(a, g, 30.0f));
+  }
+  sample(30.0f, true, a, g);
+  CHECK(!m.add(a, g, 30.0f));
+  CHECK(m.windows_rejected() == 1);
+  CHECK(!m.ready());
+
+  for (int i = 0; i < GyroTempBias::WINDOW - 1; i++) {
+    sample(30.0f, false, a, g);
+    CHECK(!m.add(a, g, 30.0f));
+  }
+  sample(30.0f, false, a, g);
+  CHECK(m.add(a, g, 30.0f));
+  CHECK(m.ready());
+  CHECK(m.observations() == 1);
+}
+
+// Calm hover with a slow steady yaw: every sample is within GYRO_MAX_RAD_S
+// of the bias, but prop vibration makes the windows loud, so the yaw rate
+// never becomes bias
+static void test_hover_yaw_not_learned()
+{
+  GyroTempBias m;
+  float b0[3];
+  true_bias(30.0f, b0);
+  m.seed(b0, 30.0f);
+  const uint32_t obs0 = m.observations();
+
+  const float PI = 3.14159265f;
+  for (int i = 0; i < 10 * 400; i++) {
+    float a[3], g[3];
+    sample(30.0f, false, a, g);
+    const float vib = sinf(2.0f * PI * 150.0f * i / 400.0f);   // 150 Hz prop line
+    g[0] += 0.025f * vib;
+    g[1] -= 0.025f * vib;
+    g[2] += 0.02f;                                               // ~1.1 deg/s yaw
+    a[0] += 1.5f * vib;
+    a[1] += 1.5f * vib;
+    CHECK(!m.add(a, g, 30.0f));
+  }
+  CHECK(m.observations() == obs0);
+  CHECK(m.windows_rejected() > 0);
+  CHECK(max_err(m, 30.0f) < 1e-6f);
+
+  // Landed, motors off: quiet again, learning resumes (the window open at
+  // touchdown still holds hover samples and is thrown away)
+  float a[3], g[3];
+  for (int i = 0; i < 2 * GyroTempBias::WINDOW; i++) {
+    sample(30.0f, false, a, g);
+    m.add(a, g, 30.0f);
+  }
+  CHECK(m.observations() == obs0 + 1);
+}
+
+// Long dwell at one temperature doesn't drown a few windows elsewhere
+static void test_bins_balance_dwell()
+{
+  GyroTempBias m;
+  float b[3];
+  for (int i = 0; i < 2000; i++) {
+    true_bias(25.3f, b);
+    m.add_observation(b, 25.3f);
+  }
+  for (int i = 0; i < 3; i++) {
+    true_bias(35.5f, b);
+    m.add_observation(b, 35.5f);
+  }
+  CHECK(m.sloped());
+  for (int i = 0; i < 3; i++) CHECK_NEAR(m.slope(i), K[i], 1e-6);
+}
+
+// Narrow span: offset only; out-of-range temperatures are clamped
+static void test_span_and_clamp()
+{
+  GyroTempBias m;
+  float b[3], e[3];
+  true_bias(30.0f, b);
+  m.add_observation(b, 30.0f);
+  true_bias(31.5f, b);
+  m.add_observation(b, 31.5f);
+  CHECK(!m.sloped());
+  CHECK(m.slope(0) == 0.0f);
+
+  true_bias(40.0f, b);
+  m.add_observation(b, 40.0f);
+  CHECK(m.sloped());
+
+  // 80 °C is clamped to 45 °C (40 + EXTRAP_C)
+  float e45[3];
+  m.bias(80.0f, e);
+  m.bias(45.0f, e45);
+  for (int i = 0; i < 3; i++) CHECK(e[i] == e45[i]);
+
+  // Outside the bin table: ignored
+  CHECK(!m.add_observation(b, 200.0f));
+  CHECK(!m.add_observation(b, -40.0f));
+}
+
+int main()
+{
+  test_warmup_ramp_tracked();
+  test_ramp_with_motion();
+  test_partial_window_rejected();
+  test_hover_yaw_not_learned();
+  test_bins_balance_dwell();
+  test_span_and_clamp();
+  return TEST_RESULT();
+}
@@ -0,0 +1,135 @@
+// Host tests for the I2C bus manager's transaction queue and per-device
+// stats: priority order, FIFO within a priority, back-pressure, and the
+// wait / bus / latency bookkeeping the bus task does per transaction.
+#include "test_check.h"
+#include "board/i2c_queue.h"
+
+static void test_priority_then_fifo()
+{
+  I2cQueue q;
+  I2cTxn t[6];
+  const I2cPrio prio[6] = { I2cPrio::SENSOR, I2cPrio::BACKGROUND, I2cPrio::RANGING,
+                            I2cPrio::SENSOR, I2cPrio::RANGING, I2cPrio::SENSOR };
+  for (int i = 0; i < 6; i++) {
+    t[i].prio = prio[i];
+    CHECK(q.push(&t[i], 100 + i));
+    CHECK(t[i].state == I2cTxnState::QUEUED && t[i].busy());
+  }
+  CHECK(q.size() == 6 && q.max_depth() == 6);
+
+  // RANGING in submit order, then SENSOR, then BACKGROUND
+  const int order[6] = { 2, 4, 0, 3, 5, 1 };
+  for (int i = 0; i < 6; i++) {
+    I2cTxn* p = q.pop(1000 + i);
+    CHECK(p == &t[order[i]]);
+    if (!p) continue;
+    CHECK(p->state == I2cTxnState::ACTIVE && p->t_start_us == (uint32_t)(1000 + i));
+  }
+  CHECK(q.pop(2000) == nullptr && q.size() == 0);
+}
+
+static void test_interleaved_arrivals()
+{
+  // A RANGING job queued behind a backlog still goes next
+  I2cQueue q;
+  I2cTxn sensor[3], tof;
+  tof.prio = I2cPrio::RANGING;
+  for (int i = 0; i < 3; i++) q.push(&sensor[i], i);
+  CHECK(q.pop(10) == &sensor[0]);
+  q.push(&tof, 11);
+  CHECK(q.pop(12) == &tof);
+  CHECK(q.pop(13) == &sensor[1]);
+  sensor[0].complete();
+  q.push(&sensor[0], 14);   // done with, reused: goes behind sensor[2]
+  CHECK(q.pop(15) == &sensor[2]);
+  CHECK(q.pop(16) == &sensor[0]);
+}
+
+static void test_fifo_across_seq_wrap()
+{
+  I2cQueue q;
+  I2cTxn t[3];
+  for (int i = 0; i < 3; i++) q.push(&t[i], 0);
+  t[0].seq = 0xFFFFFFFEu;   // as if queued just before the wrap
+  t[1].seq = 0xFFFFFFFFu;
+  t[2].seq = 0;
+  CHECK(q.pop(0) == &t[0]);
+  CHECK(q.pop(0) == &t[1]);
+  CHECK(q.pop(0) == &t[2]);
+}
+
+static void test_backpressure()
+{
+  I2cQueue q;
+  I2cTxn t[I2cQueue::CAPACITY + 1];
+  for (int i = 0; i < I2cQueue::CAPACITY; i++) CHECK(q.push(&t[i], 0));
+  CHECK(!q.push(&t[I2cQueue::CAPACITY], 0));
+  CHECK(q.rejected() == 1);
+  CHECK(t[I2cQueue::CAPACITY].state == I2cTxnState::IDLE);
+
+  // Still queued or active: refused, not queued twice
+  I2cQueue q2;
+  I2cTxn a;
+  CHECK(q2.push(&a, 0));
+  CHECK(!q2.push(&a, 1));
+  CHECK(q2.pop(2) == &a);
+  CHECK(!q2.push(&a, 3));           // ACTIVE
+  a.ok = true;
+  a.complete();
+  CHECK(a.done() && !a.busy());
+  CHECK(q2.push(&a, 4));            // DONE: free to go again
+  CHECK(!a.ok && a.t_submit_us == 4);
+  CHECK(q2.rejected() == 2 && q2.size() == 1);
+}
+
+static void test_dev_stats()
+{
+  I2cDevStats st;
+  I2cTxn t;
+
+  // wait 200, bus 300
+  t.t_submit_us = 0xFFFFFF00u;      // across the micros() wrap
+  t.t_start_us = 0xFFFFFF00u + 200;
+  t.t_done_us = 0xFFFFFF00u + 500;
+  t.ok = true;
+  st.add(t);
+
+  // wait 0, bus 1000, failed
+  t.t_submit_us = 5000;
+  t.t_start_us = 5000;
+  t.t_done_us = 6000;
+  t.ok = false;
+  st.add(t);
+
+  CHECK(st.txns == 2 && st.errors == 1);
+  CHECK(st.avg_wait_us() == 100 && st.max_wait_us == 200);
+  CHECK(st.avg_bus_us() == 650 && st.max_bus_us == 1000);
+  CHECK(st.max_lat_us == 1000);
+
+  I2cDevStats empty;
+  CHECK(empty.avg_wait_us() == 0 && empty.avg_bus_us() == 0);
+}
+
+static void test_txn_helpers()
+{
+  static const uint8_t reg = 0xF7;
+  uint8_t buf[6];
+  I2cTxn t;
+  CHECK(t.dev == I2C_DEV_NONE && t.state == I2cTxnState::IDLE);
+  t.set_read(0x76, &reg, buf, sizeof(buf));
+  CHECK(t.addr7 == 0x76 && t.tx == &reg && t.tx_len == 1 && t.rx == buf && t.rx_len == 6);
+  const uint8_t w[2] = { 0xF4, 0x57 };
+  t.set_write(0x76, w, 2);
+  CHECK(t.tx == w && t.tx_len == 2 && t.rx == nullptr && t.rx_len == 0 && !t.job);
+}
+
+int main()
+{
+  test_priority_then_fifo();
+  test_interleaved_arrivals();
+  test_fifo_across_seq_wrap();
+  test_backpressure();
+  test_dev_stats();
+  test_txn_helpers();
+  return TEST_RESULT();
+}
@@ -0,0 +1,125 @@
+// Host test: LoopStats deadline counters and latency histograms.
+#include "test_check.h"
+
+#include <string.h>
+
+#include "utils/latency_histogram.h"
+#include "utils/loop_stats.h"
+
+static void test_bucket_layout() {
+  // Exact below 64 us
+  for (uint32_t v = 0; v < 64; v++) {
+    CHECK(LatencyHistogram::index_of(v) == v);
+    CHECK(LatencyHistogram::bucket_lower((uint16_t)v) == v);
+    CHECK(LatencyHistogram::bucket_upper((uint16_t)v) == v);
+  }
+
+  // Every value falls inside its bucket, buckets are contiguous and <= ~3% wide
+  uint16_t prev = 0;
+  for (uint32_t v = 1; v < (1u << 20); v += 1 + v / 97) {
+    const uint16_t i = LatencyHistogram::index_of(v);
+    CHECK(i >= prev);
+    CHECK(LatencyHistogram::bucket_lower(i) <= v);
+    CHECK(LatencyHistogram::bucket_upper(i) >= v);
+    const uint32_t w = LatencyHistogram::bucket_upper(i) - LatencyHistogram::bucket_lower(i) + 1;
+    CHECK(w * 32 <= LatencyHistogram::bucket_lower(i) || v < 64);
+    prev = i;
+  }
+  CHECK(LatencyHistogram::index_of(0xFFFFFFFFu) == LatencyHistogram::BUCKETS - 1);
+  CHECK(LatencyHistogram::bucket_upper(LatencyHistogram::BUCKETS - 1) == (1u << 20) - 1);
+}
+
+static void test_percentiles() {
+  LatencyHistogram h;
+  h.clear();
+  CHECK(h.percentile(50.0f) == 0);
+
+  // 1000 samples at 4000 us, 10 at 6000 us, 1 at 20000 us
+  for (int i = 0; i < 1000; i++) h.record(4000);
+  for (int i = 0; i < 10; i++) h.record(6000);
+  h.record(20000);
+
+  CHECK(h.total() == 1011);
+  CHECK(h.max() == 20000);
+  CHECK_NEAR(h.percentile(50.0f), 4000, 4000 / 32);
+  CHECK(h.percentile(50.0f) >= 4000);
+  CHECK_NEAR(h.percentile(99.0f), 6000, 6000 / 32);
+  CHECK_NEAR(h.percentile(99.9f), 6000, 6000 / 32);  // rank 1010 of 1011
+  CHECK(h.percentile(99.95f) == 20000);
+  CHECK(h.percentile(100.0f) == 20000);
+
+  // Uniform 1..10000: percentiles within one bucket of the exact answer
+  h.clear();
+  for (uint32_t v = 1; v <= 10000; v++) h.record(v);
+  CHECK_NEAR(h.percentile(50.0f), 5000, 5000 / 32 + 1);
+  CHECK_NEAR(h.percentile(99.0f), 9900, 9900 / 32 + 1);
+  CHECK_NEAR(h.percentile(99.9f), 9990, 9990 / 32 + 1);
+}
+
+static void test_dump_roundtrip() {
+  LatencyHistogram h, back;
+  h.clear();
+  for (uint32_t v = 0; v < 5000; v += 7) h.record(v);
+  h.record(3000000);  // overflow bucket
+
+  uint8_t buf[LatencyHistogram::DUMP_MAX_BYTES];
+  CHECK(h.dump(buf, 8) == 0);  // too small
+  const size_t n = h.dump(buf, sizeof(buf));
+  CHECK(n > 12 && n < sizeof(buf));
+
+  CHECK(back.load(buf, n));
+  CHECK(back.total() == h.total());
+  CHECK(back.max() == h.max());
+  for (uint16_t i = 0; i < LatencyHistogram::BUCKETS; i++) CHECK(back.count(i) == h.count(i));
+
+  buf[0] = 'X';
+  CHECK(!back.load(buf, n));
+}
+
+static void test_loop_stats_window() {
+  LoopStats s;
+  s.reset();
+
+  uint32_t t = 1000;
+  for (int i = 0; i < 100; i++) {
+    s.tick(t);
+    s.record(10, 1500, true);
+    t += 4000;
+  }
+  s.record(10, 5000, false);
+  s.record_missed_ticks(2);
+
+  CHECK(s.samples() == 99);
+  CHECK(s.jobs() == 101);
+  CHECK(s.deadline_misses() == 1);
+  CHECK(s.missed_ticks() == 2);
+  CHECK(s.max_exec_us() == 5000);
+
+  LatencyHistogram dt, exec;
+  s.read_window(dt, exec);
+  CHECK(dt.total() == 99);
+  CHECK(exec.total() == 101);
+  CHECK(dt.max() == 4000);
+  CHECK(exec.percentile(50.0f) <= 1500 + 1500 / 32);
+
+  // Window was reset; next one only sees new samples
+  s.tick(t);
+  s.record(10, 700, true);
+  s.read_window(dt, exec);
+  CHECK(dt.total() == 1);
+  CHECK(exec.total() == 1);
+  CHECK(exec.max() == 700);
+
+  // And the bank it flipped back to was cleared
+  s.read_window(dt, exec);
+  CHECK(dt.total() == 0);
+  CHECK(exec.total() == 0);
+}
+
+int main() {
+  test_bucket_layout();
+  test_percentiles();
+  test_dump_roundtrip();
+  test_loop_stats_window();
+  return TEST_RESULT();
+}
@@ -0,0 +1,190 @@
+// Host tests for the non-blocking PMW3901 motion burst (Pmw3901Async)
+// against a fake SPI device that checks the datasheet timing on a virtual
+// microsecond clock.
+#include <string.h>
+
+#include "test_check.h"
+#include "sensors/flow/pmw3901_async.h"
+
+// Fake PMW3901 on a 1 MHz bus: every byte takes 8 us of virtual time.
+// Flags a burst read that starts less than tSRAD_MOTBR after the address
+// byte, a CS low less than tBEXIT after the last CS high, and bytes
+// clocked with CS high.
+class FakeFlow : public Pmw3901Bus {
+ public:
+  static constexpr uint32_t BYTE_US = 8;
+
+  uint32_t now = 1000;
+  uint8_t burst[PMW3901_BURST_BYTES] = {};
+
+  bool cs = false;
+  bool addressed = false;
+  uint32_t t_addr = 0;
+  uint32_t t_cs_high = 0;
+  bool ever_high = false;
+
+  uint32_t violations = 0;
+  uint32_t selects = 0;
+  uint32_t bursts = 0;
+  uint8_t last_addr = 0;
+
+  void select() override
+  {
+    if (ever_high && (uint32_t)(now - t_cs_high) < PMW3901_T_BEXIT_US) violations++;
+    if (cs) violations++;
+    cs = true;
+    addressed = false;
+    selects++;
+  }
+
+  void deselect() override
+  {
+    cs = false;
+    ever_high = true;
+    t_cs_high = now;
+  }
+
+  void transfer(const uint8_t* tx, uint8_t* rx, uint32_t n) override
+  {
+    if (!cs) violations++;
+    if (!addressed) {
+      // First byte of the window is the address
+      last_addr = tx ? tx[0] : 0;
+      now += BYTE_US;
+      t_addr = now;
+      addressed = true;
+      if (n != 1) violations++;
+      return;
+    }
+    if ((uint32_t)(now - t_addr) < PMW3901_T_SRAD_MOTBR_US) violations++;
+    if (n != PMW3901_BURST_BYTES || last_addr != PMW3901_MOTION_BURST) violations++;
+    if (rx) memcpy(rx, burst, n);
+    now += BYTE_US * n;
+    bursts++;
+  }
+
+  uint32_t now_us() override { return now; }
+  void delay_us(uint32_t us) override { now += us; }
+};
+
+static void fill_burst(FakeFlow& f, int16_t dx, int16_t dy)
+{
+  const uint8_t b[PMW3901_BURST_BYTES] = {
+    0x80, 0, (uint8_t)(dx & 0xFF), (uint8_t)((uint16_t)dx >> 8),
+    (uint8_t)(dy & 0xFF), (uint8_t)((uint16_t)dy >> 8), 90, 0, 0, 0, 0x02, 0x10,
+  };
+  memcpy(f.burst, b, sizeof(b));
+}
+
+static void test_completes_after_gap()
+{
+  FakeFlow f;
+  Pmw3901Async a(f);
+  fill_burst(f, -5, 300);
+
+  CHECK(a.start());
+  CHECK(a.busy());
+  CHECK(f.cs);
+  CHECK(f.last_addr == PMW3901_MOTION_BURST);
+  CHECK(a.started_us() == 1000);
+
+  Pmw3901Burst b;
+  CHECK(!a.poll(b));                      // right after the address byte
+  CHECK(a.early_polls() == 1);
+  CHECK(a.wait_us() > PMW3901_T_SRAD_MOTBR_US - 1);
+  CHECK(f.cs);                            // nothing clocked, CS still low
+
+  f.now += 20;                            // "other work"
+  CHECK(!a.poll(b));
+  CHECK(a.wait_us() > 0 && a.wait_us() <= PMW3901_T_SRAD_MOTBR_US - 19);
+
+  f.now += a.wait_us();
+  CHECK(a.poll(b));
+  CHECK(!a.busy());
+  CHECK(!f.cs);
+  CHECK(b.dx == -5 && b.dy == 300 && b.squal == 90 && b.shutter == 0x0210);
+  CHECK(a.bursts() == 1);
+  CHECK(f.bursts == 1);
+  CHECK(f.violations == 0);
+}
+
+// The gap counts from the end of the address byte, not from start()
+static void test_gap_counts_from_address_byte()
+{
+  FakeFlow f;
+  Pmw3901Async a(f);
+  CHECK(a.start());
+  f.now += PMW3901_T_SRAD_MOTBR_US - FakeFlow::BYTE_US;   // 35 us after start() began
+  Pmw3901Burst b;
+  CHECK(!a.poll(b));
+  f.now += FakeFlow::BYTE_US + 1;
+  CHECK(a.poll(b));
+  CHECK(f.violations == 0);
+}
+
+static void test_busy_and_bexit()
+{
+  FakeFlow f;
+  Pmw3901Async a(f);
+  Pmw3901Burst b;
+
+  CHECK(!a.poll(b));                      // idle: nothing to finish
+  CHECK(a.start());
+  CHECK(!a.start());                      // burst already open
+  CHECK(f.selects == 1);
+
+  f.now += 100;
+  CHECK(a.poll(b));
+  CHECK(!a.start());                      // same microsecond as CS high
+  f.now += PMW3901_T_BEXIT_US;
+  CHECK(a.start());
+  f.now += 100;
+  CHECK(a.poll(b));
+  CHECK(f.violations == 0);
+}
+
+// Back-to-back reads as the fast loop does them, across a micros() wrap
+static void test_many_reads_across_wrap()
+{
+  FakeFlow f;
+  f.now = 0xFFFFF000u;
+  Pmw3901Async a(f);
+  uint32_t done = 0;
+  for (int i = 0; i < 2000; i++) {
+    fill_burst(f, (int16_t)i, (int16_t)-i);
+    CHECK(a.start());
+    Pmw3901Burst b;
+    // Caller polls every 7 us while doing other work
+    while (!a.poll(b)) f.now += 7;
+    if (b.dx == (int16_t)i && b.dy == (int16_t)-i) done++;
+    f.now += 5000 - 150;                  // next 200 Hz tick
+  }
+  CHECK(done == 2000);
+  CHECK(f.violations == 0);
+  CHECK(a.early_polls() > 0);
+}
+
+// The fake really catches a driver that reads without the gap
+static void test_fake_flags_violations()
+{
+  FakeFlow f;
+  const uint8_t addr = PMW3901_MOTION_BURST;
+  uint8_t buf[PMW3901_BURST_BYTES];
+  f.select();
+  f.transfer(&addr, nullptr, 1);
+  f.transfer(nullptr, buf, PMW3901_BURST_BYTES);   // no tSRAD wait
+  f.deselect();
+  CHECK(f.violations == 1);
+  f.select();                                      // no tBEXIT
+  CHECK(f.violations == 2);
+}
+
+int main()
+{
+  test_completes_after_gap();
+  test_gap_counts_from_address_byte();
+  test_busy_and_bexit();
+  test_many_reads_across_wrap();
+  test_fake_flags_violations();
+  return TEST_RESULT();
+}
@@ -0,0 +1,50 @@
+// Host tests for the PMW3901 motion burst decode (pmw3901_burst.h).
+#include "test_check.h"
+#include "sensors/flow/pmw3901_burst.h"
+
+static void test_field_order()
+{
+  const uint8_t b[PMW3901_BURST_BYTES] = {
+    0xB0,        // Motion: MOT set
+    0x3F,        // Observation
+    0x34, 0x12,  // Delta_X = 0x1234
+    0xFE, 0xFF,  // Delta_Y = -2
+    0x64,        // SQUAL
+    0x55, 0x77, 0x11,
+    0x01, 0x9A,  // Shutter upper, lower = 0x019A
+  };
+  Pmw3901Burst m;
+  pmw3901_parse_burst(b, m);
+  CHECK(m.motion == 0xB0);
+  CHECK((m.motion & PMW3901_MOTION_MOT) != 0);
+  CHECK(m.observation == 0x3F);
+  CHECK(m.dx == 0x1234);
+  CHECK(m.dy == -2);
+  CHECK(m.squal == 0x64);
+  CHECK(m.raw_sum == 0x55 && m.raw_max == 0x77 && m.raw_min == 0x11);
+  CHECK(m.shutter == 0x019A);
+}
+
+// Same values the per-register path decoded: Delta_X_H:L, Delta_Y_H:L
+static void test_matches_register_decode()
+{
+  for (int32_t v = -32768; v <= 32767; v += 7) {
+    const uint8_t lo = (uint8_t)(v & 0xFF), hi = (uint8_t)((v >> 8) & 0xFF);
+    const uint8_t b[PMW3901_BURST_BYTES] = { 0x80, 0, lo, hi, hi, lo, 0, 0, 0, 0, 0, 0 };
+    Pmw3901Burst m;
+    pmw3901_parse_burst(b, m);
+    const int16_t ref_dx = (int16_t)((uint16_t(hi) << 8) | lo);
+    const int16_t ref_dy = (int16_t)((uint16_t(lo) << 8) | hi);
+    if (m.dx != ref_dx || m.dy != ref_dy) {
+      CHECK(false);
+      break;
+    }
+  }
+}
+
+int main()
+{
+  test_field_order();
+  test_matches_register_decode();
+  return TEST_RESULT();
+}
@@ -0,0 +1,104 @@
+// Host tests for the PMW3901 frame grab decode and the frame wire format.
+#include <string.h>
+
+#include "test_check.h"
+#include "sensors/flow/pmw3901_frame.h"
+
+static_assert(sizeof(FlowFrameHeader) == 16, "wire header layout");
+
+// The two RawData_Grab reads the sensor returns for one pixel
+static uint8_t hi_read(uint8_t p) { return (uint8_t)(0x40 | (p >> 2)); }
+static uint8_t lo_read(uint8_t p) { return (uint8_t)(0x80 | ((p & 0x03) << 2) | 0x01); }  // bit 0 is junk
+
+static void test_assembler()
+{
+  uint8_t want[PMW3901_FRAME_PIXELS];
+  for (int i = 0; i < PMW3901_FRAME_PIXELS; i++) want[i] = (uint8_t)(i * 37 + (i >> 3));
+
+  uint8_t px[PMW3901_FRAME_PIXELS];
+  memset(px, 0xAA, sizeof(px));
+  Pmw3901FrameAssembler a(px);
+  uint32_t reads = 0;
+  bool done = false;
+  for (int i = 0; i < PMW3901_FRAME_PIXELS; i++) {
+    // Not-ready reads (status 00 and 11) sprinkled in
+    if (i % 7 == 0) { CHECK(!a.push(0x00)); reads++; }
+    if (i % 11 == 0) { CHECK(!a.push(0xFF)); reads++; }
+    CHECK(!a.push(hi_read(want[i])));
+    done = a.push(lo_read(want[i]));
+    reads += 2;
+  }
+  CHECK(done && a.done());
+  CHECK(a.pixels() == PMW3901_FRAME_PIXELS);
+  CHECK(memcmp(px, want, sizeof(px)) == 0);
+  CHECK(a.not_ready() == reads - 2u * PMW3901_FRAME_PIXELS);
+  CHECK(a.out_of_order() == 0);
+
+  // Further reads change nothing
+  CHECK(a.push(hi_read(0)));
+  CHECK(px[0] == want[0]);
+}
+
+static void test_assembler_out_of_order()
+{
+  uint8_t px[PMW3901_FRAME_PIXELS] = {};
+  Pmw3901FrameAssembler a(px);
+  CHECK(!a.push(lo_read(3)));            // low half first: skipped
+  CHECK(a.out_of_order() == 1 && a.pixels() == 0);
+  a.push(hi_read(0xFF));
+  a.push(hi_read(0x80));                 // second high half replaces the first
+  a.push(lo_read(0x80));
+  CHECK(a.pixels() == 1 && px[0] == 0x80);
+  CHECK(!a.done());
+}
+
+static void test_crc()
+{
+  // CRC-16/CCITT-FALSE check value
+  const char* s = "123456789";
+  CHECK(flow_frame_crc16((const uint8_t*)s, 9) == 0x29B1);
+}
+
+static void test_encode_decode()
+{
+  static FlowFrame f, g;
+  f.seq = 513;
+  f.t_us = 0xDEADBEEF;
+  f.grab_us = 160000;
+  f.squal = 42;
+  f.shutter = 0x1234;
+  for (int i = 0; i < PMW3901_FRAME_PIXELS; i++) f.px[i] = (uint8_t)(255 - i);
+
+  uint8_t buf[FLOW_FRAME_PACKET_MAX + 8];
+  CHECK(flow_frame_encode(f, buf, FLOW_FRAME_PACKET_MAX - 1) == 0);
+  const size_t n = flow_frame_encode(f, buf, sizeof(buf));
+  CHECK(n == FLOW_FRAME_PACKET_MAX);
+  CHECK(buf[0] == 'P' && buf[1] == 'F' && buf[2] == FLOW_FRAME_VERSION);
+
+  CHECK(flow_frame_decode(buf, n, g));
+  CHECK(g.seq == 513 && g.t_us == 0xDEADBEEF && g.grab_us == 160000);
+  CHECK(g.squal == 42 && g.shutter == 0x1234);
+  CHECK(memcmp(g.px, f.px, PMW3901_FRAME_PIXELS) == 0);
+
+  // Truncated, corrupted pixel, corrupted CRC, other version
+  CHECK(!flow_frame_decode(buf, n - 1, g));
+  buf[100] ^= 0x01;
+  CHECK(!flow_frame_decode(buf, n, g));
+  buf[100] ^= 0x01;
+  buf[n - 1] ^= 0x80;
+  CHECK(!flow_frame_decode(buf, n, g));
+  buf[n - 1] ^= 0x80;
+  buf[2] = FLOW_FRAME_VERSION + 1;
+  CHECK(!flow_frame_decode(buf, n, g));
+  buf[2] = FLOW_FRAME_VERSION;
+  CHECK(flow_frame_decode(buf, n, g));
+}
+
+int main()
+{
+  test_assembler();
+  test_assembler_out_of_order();
+  test_crc();
+  test_encode_decode();
+  return TEST_RESULT();
+}
@@ -0,0 +1,246 @@
+// Host tests for the table-driven PMW3901 init (pmw3901_load) against a
+// recording fake SPI device on a virtual microsecond clock: the register
+// sequence, the datasheet spacing, bank read-back (reported, not fatal) and
+// the init report.
+#include <string.h>
+
+#include "test_check.h"
+#include "sensors/flow/pmw3901_init.h"
+
+// Fake PMW3901 on a 1 MHz bus (8 us a byte). Banked register file, reads
+// return what was written (IDs preset). Records every access and flags
+// spacing below the datasheet minimums.
+class RecordingFlow : public Pmw3901Bus {
+ public:
+  static constexpr uint32_t BYTE_US = 8;
+  struct Access {
+    bool write;
+    uint8_t bank, reg, val;
+    uint32_t t_end;
+  };
+
+  uint32_t now = 5000;
+  uint8_t regs[32][128] = {};
+  Access log[256];
+  int n = 0;
+  uint32_t violations = 0;
+
+  int drop_bank_writes = 0;   // next N bank selects are lost
+  bool bank_reads_zero = false;   // 0x7F is write-only
+  uint8_t id = 0x49;
+
+  uint8_t bank() const { return regs[0][0x7F] & 31; }
+
+  void select() override
+  {
+    cs_ = true;
+    nbytes_ = 0;
+  }
+
+  void deselect() override
+  {
+    if (wr_ && (uint32_t)(now - t_last_bit_) < PMW3901_T_SCLK_NCS_W_US) violations++;
+    cs_ = false;
+    if (nbytes_ == 0) return;
+    record_();
+  }
+
+  void transfer(const uint8_t* tx, uint8_t* rx, uint32_t k) override
+  {
+    if (!cs_) violations++;
+    for (uint32_t i = 0; i < k; i++) {
+      const uint8_t b = tx ? tx[i] : 0;
+      if (nbytes_ == 0) {
+        // Spacing from the end of the previous access
+        wr_ = (b & 0x80) != 0;
+        reg_ = b & 0x7F;
+        if (n > 0) {
+          const Access& p = log[n - 1];
+          const uint32_t gap = p.write ? (wr_ ? PMW3901_T_SWW_US : PMW3901_T_SWR_US)
+                                       : (wr_ ? PMW3901_T_SRW_US : PMW3901_T_SRR_US);
+          if ((uint32_t)(now - p.t_end) < gap) violations++;
+          min_gap_seen = (now - p.t_end) < min_gap_seen ? (now - p.t_end) : min_gap_seen;
+        }
+        now += BYTE_US;
+        t_addr_ = now;
+      } else {
+        if (!wr_ && (uint32_t)(now - t_addr_) < PMW3901_T_SRAD_US) violations++;
+        now += BYTE_US;
+        if (wr_) {
+          val_ = b;
+        } else {
+          val_ = reg_value_(reg_);
+          if (rx) rx[i] = val_;
+        }
+      }
+      t_last_bit_ = now;
+      nbytes_++;
+    }
+  }
+
+  uint32_t now_us() override { return now; }
+  void delay_us(uint32_t us) override { now += us; }
+
+  uint32_t min_gap_seen = 0xFFFFFFFF;
+
+  int writes() const
+  {
+    int w = 0;
+    for (int i = 0; i < n; i++) w += log[i].write;
+    return w;
+  }
+
+ private:
+  uint8_t reg_value_(uint8_t reg) const
+  {
+    if (bank() == 0 && reg == 0x00) return id;
+    if (bank() == 0 && reg == 0x5F) return (uint8_t)~id;
+    if (reg == 0x7F) return bank_reads_zero ? 0 : regs[0][0x7F];
+    return regs[bank()][reg];
+  }
+
+  void record_()
+  {
+    const uint8_t b = bank();
+    if (wr_) {
+      if (reg_ == 0x7F) {
+        if (drop_bank_writes > 0) drop_bank_writes--;
+        else regs[0][0x7F] = val_;
+      } else {
+        regs[b][reg_] = val_;
+      }
+    }
+    if (n < 256) log[n++] = { wr_, b, reg_, val_, t_last_bit_ };
+  }
+
+  bool cs_ = false;
+  bool wr_ = false;
+  uint8_t reg_ = 0, val_ = 0;
+  uint32_t nbytes_ = 0;
+  uint32_t t_addr_ = 0, t_last_bit_ = 0;
+};
+
+// The hand-written initRegisters() this table replaced, in order
+static const uint8_t OLD_SCRIPT[][2] = {
+  {0x7F, 0x00}, {0x61, 0xAD}, {0x7F, 0x03}, {0x40, 0x00}, {0x7F, 0x05}, {0x41, 0xB3},
+  {0x43, 0xF1}, {0x45, 0x14}, {0x5B, 0x32}, {0x5F, 0x34}, {0x7B, 0x08}, {0x7F, 0x06},
+  {0x44, 0x1B}, {0x40, 0xBF}, {0x4E, 0x3F}, {0x7F, 0x08}, {0x65, 0x20}, {0x6A, 0x18},
+  {0x7F, 0x09}, {0x4F, 0xAF}, {0x5F, 0x40}, {0x48, 0x80}, {0x49, 0x80}, {0x57, 0x77},
+  {0x60, 0x78}, {0x61, 0x78}, {0x62, 0x08}, {0x63, 0x50}, {0x7F, 0x0A}, {0x45, 0x60},
+  {0x7F, 0x00}, {0x4D, 0x11}, {0x55, 0x80}, {0x74, 0x1F}, {0x75, 0x1F}, {0x4A, 0x78},
+  {0x4B, 0x78}, {0x44, 0x08}, {0x45, 0x50}, {0x64, 0xFF}, {0x65, 0x1F}, {0x7F, 0x14},
+  {0x65, 0x60}, {0x66, 0x08}, {0x63, 0x78}, {0x7F, 0x15}, {0x48, 0x58}, {0x7F, 0x07},
+  {0x41, 0x0D}, {0x43, 0x14}, {0x4B, 0x0E}, {0x45, 0x0F}, {0x44, 0x42}, {0x4C, 0x80},
+  {0x7F, 0x10}, {0x5B, 0x02}, {0x7F, 0x07}, {0x40, 0x41}, {0x70, 0x00},
+  // delay(100)
+  {0x32, 0x44}, {0x7F, 0x07}, {0x40, 0x40}, {0x7F, 0x06}, {0x62, 0xF0}, {0x63, 0x00},
+  {0x7F, 0x0D}, {0x48, 0xC0}, {0x6F, 0xD5}, {0x7F, 0x00}, {0x5B, 0xA0}, {0x4E, 0xA8},
+  {0x5A, 0x50}, {0x40, 0x80},
+};
+static const int OLD_WRITES = sizeof(OLD_SCRIPT) / sizeof(OLD_SCRIPT[0]);
+
+static void test_sequence_and_timing()
+{
+  static RecordingFlow f;
+  Pmw3901RegIo io(f);
+  Pmw3901InitReport rep;
+  CHECK(pmw3901_load(io, PMW3901_INIT, PMW3901_INIT_STEPS, rep));
+  CHECK(rep.ok && rep.id_ok);
+  CHECK(f.violations == 0);
+
+  // POR, then exactly the old script's writes in the old order
+  CHECK(f.log[0].write && f.log[0].reg == 0x3A && f.log[0].val == 0x5A);
+  int w = 0;
+  bool same = true;
+  for (int i = 1; i < f.n; i++) {
+    if (!f.log[i].write) continue;
+    if (w >= OLD_WRITES || f.log[i].reg != OLD_SCRIPT[w][0] || f.log[i].val != OLD_SCRIPT[w][1]) same = false;
+    w++;
+  }
+  CHECK(same && w == OLD_WRITES);
+  CHECK(rep.writes == OLD_WRITES + 1);
+  CHECK(rep.steps == PMW3901_INIT_STEPS);
+
+  // Every bank select read back
+  int banks = 0;
+  for (int i = 0; i < OLD_WRITES; i++) banks += OLD_SCRIPT[i][0] == 0x7F;
+  CHECK(rep.verified == banks && rep.retries == 0 && rep.mismatches == 0);
+
+  // Register file ends up as the script left it
+  CHECK(f.regs[0][0x40] == 0x80 && f.regs[0x0D][0x6F] == 0xD5 && f.regs[0x15][0x48] == 0x58);
+
+  // Spacing is the minimum, not padding: the tightest gap is tSRR/tSRW + 1
+  CHECK(f.min_gap_seen == PMW3901_T_SRR_US + 1);
+
+  // Timing: the fixed waits dominate; the SPI part is a few ms
+  // (the old script: ~80 x ~330 us = ~26 ms on top of the waits)
+  CHECK(rep.wait_us == 106000);
+  CHECK(rep.total_us >= rep.wait_us);
+  CHECK(rep.total_us - rep.wait_us < 10000);
+  printf("  init: %u steps, %u writes, %u verified, %lu us (%lu us SPI)\n",
+         (unsigned)rep.steps, (unsigned)rep.writes, (unsigned)rep.verified,
+         (unsigned long)rep.total_us, (unsigned long)(rep.total_us - rep.wait_us));
+}
+
+static void test_wrong_id_stops()
+{
+  static RecordingFlow f;
+  f.id = 0x12;
+  Pmw3901RegIo io(f);
+  Pmw3901InitReport rep;
+  CHECK(!pmw3901_load(io, PMW3901_INIT, PMW3901_INIT_STEPS, rep));
+  CHECK(!rep.ok && !rep.id_ok);
+  CHECK(rep.bad_reg == 0x00 && rep.bad_want == 0x49 && rep.bad_got == 0x12);
+  CHECK(f.writes() == 1);           // the reset only
+  CHECK(rep.steps == 3);
+}
+
+static void test_bank_verify_retry()
+{
+  // One lost bank select: caught by the read-back, rewritten, fine
+  static RecordingFlow f;
+  f.drop_bank_writes = 1;
+  f.regs[0][0x7F] = 0x20;   // reads back wrong, still bank 0
+  Pmw3901RegIo io(f);
+  Pmw3901InitReport rep;
+  CHECK(pmw3901_load(io, PMW3901_INIT, PMW3901_INIT_STEPS, rep));
+  CHECK(rep.retries == 1 && rep.mismatches == 0);
+  CHECK(f.regs[0][0x61] == 0xAD);   // landed in bank 0 after the retry
+
+  // Bank selects that never read back right: counted, not fatal (0x7F is
+  // undocumented), sequence still runs
+  static RecordingFlow g;
+  g.drop_bank_writes = 1000;
+  g.regs[0][0x7F] = 0x20;   // reads back wrong, still bank 0
+  Pmw3901RegIo io2(g);
+  CHECK(pmw3901_load(io2, PMW3901_INIT, PMW3901_INIT_STEPS, rep));
+  CHECK(rep.id_ok && rep.ok);
+  CHECK(rep.unconfirmed == rep.verified && rep.retries == rep.verified);
+  CHECK(rep.mismatches == 0);
+  CHECK(g.violations == 0);
+}
+
+static void test_bank_write_only()
+{
+  // A part whose bank register is write-only (reads 0): every select
+  // lands, the read-back says otherwise; init goes on and the script ends
+  // up where it should
+  static RecordingFlow f;
+  f.bank_reads_zero = true;
+  Pmw3901RegIo io(f);
+  Pmw3901InitReport rep;
+  CHECK(pmw3901_load(io, PMW3901_INIT, PMW3901_INIT_STEPS, rep));
+  CHECK(rep.ok && rep.mismatches == 0);
+  CHECK(rep.unconfirmed > 0 && rep.unconfirmed < rep.verified);   // bank 0 selects do "match"
+  CHECK(f.regs[0][0x40] == 0x80 && f.regs[0x0D][0x6F] == 0xD5 && f.regs[0x15][0x48] == 0x58);
+  CHECK(f.violations == 0);
+}
+
+int main()
+{
+  test_sequence_and_timing();
+  test_wrong_id_stops();
+  test_bank_verify_retry();
+  test_bank_write_only();
+  return TEST_RESULT();
+}
@@ -0,0 +1,130 @@
+// Host test: rate-group table from config/rate_groups.h on the virtual clock.
+#include "test_check.h"
+
+#include "config/rate_groups.h"
+#include "utils/rate_scheduler_sim.h"
+
+// Execution-time models (us)
+static uint32_t exec_fixed(uint32_t, void* ctx) { return *static_cast<uint32_t*>(ctx); }
+
+// Report group: ~30 ms of Serial.printf + I2C, the case that used to delay fast_read
+static uint32_t exec_report(uint32_t, void*) { return 30000; }
+
+// Slow group with an occasional 6 ms I2C stall (ToF clock stretching)
+static uint32_t exec_slow(uint32_t job, void*) { return (job % 10 == 9) ? 6000 : 800; }
+
+static void test_fast_not_delayed_by_slower_groups() {
+  // Put every group on one core to force preemption
+  RateGroupDef fast = RG_FAST, slow = RG_SLOW, report = RG_REPORT;
+  slow.core = fast.core;
+  report.core = fast.core;
+
+  uint32_t fast_exec = 1500;
+  LoopStats fast_dt;
+  fast_dt.reset();
+
+  RateSchedulerSim sim;
+  CHECK(sim.add(fast, exec_fixed, &fast_exec, &fast_dt));
+  CHECK(sim.add(slow, exec_slow));
+  CHECK(sim.add(report, exec_report));
+  sim.run_for(5 * 1000000);
+
+  const RateGroupStats& f = sim.stats(0);
+  CHECK(f.runs >= 5 * FAST_HZ - 1);
+  CHECK(f.overruns == 0);
+  CHECK(f.deadline_misses == 0);
+  CHECK(f.max_start_lat_us == 0);  // highest priority always starts on release
+  CHECK(fast_dt.min_dt_us() == FAST_PERIOD_US);
+  CHECK(fast_dt.max_dt_us() == FAST_PERIOD_US);
+  CHECK(fast_dt.jobs() == f.runs);
+  CHECK(fast_dt.max_wake_lat_us() == 0);
+  CHECK(fast_dt.avg_exec_us() == fast_exec);
+  CHECK(fast_dt.deadline_misses() == 0);
+  CHECK(fast_dt.missed_ticks() == 0);
+
+  // Lower groups absorb the preemption instead
+  CHECK(sim.preemptions(2) > 0);
+  CHECK(sim.stats(2).max_response_us > 30000);
+  CHECK(sim.stats(1).deadline_misses == 0);
+}
+
+static void test_cores_are_independent() {
+  uint32_t fast_exec = 1500;
+  RateSchedulerSim sim;
+  CHECK(sim.add(RG_FAST, exec_fixed, &fast_exec));
+  CHECK(sim.add(RG_REPORT, exec_report));  // core 0 in the table
+  sim.run_for(2 * 1000000);
+
+  CHECK(sim.preemptions(1) == 0);
+  CHECK(sim.stats(1).max_response_us == 30000);
+}
+
+static void test_overrun_accounting() {
+  // Job 1 ms longer than the period: every job misses its deadline, and
+  // the release backlog is bounded (no catch-up burst).
+  uint32_t exec = FAST_PERIOD_US + 1000;
+  LoopStats dt;
+  dt.reset();
+  RateSchedulerSim sim;
+  CHECK(sim.add(RG_FAST, exec_fixed, &exec, &dt));
+  sim.run_for(1000000);
+
+  const RateGroupStats& f = sim.stats(0);
+  CHECK(f.runs == 1000000 / exec);  // back to back
+  CHECK(f.deadline_misses == f.runs);
+  CHECK(f.overruns > 0);
+  CHECK(dt.deadline_misses() == f.deadline_misses);
+  CHECK(dt.missed_ticks() == f.overruns);
+  CHECK(f.releases() * FAST_PERIOD_US <= 1000000 + FAST_PERIOD_US);
+  CHECK(f.max_response_us < 2 * FAST_PERIOD_US + exec);
+}
+
+static void test_flow_group_on_control_core() {
+  // Core 1 as configured: fast (IMU), flow (PMW3901 burst + gyro pairing)
+  // and slow (ToF, with its I2C stalls)
+  uint32_t fast_exec = 1500, flow_exec = 250;
+  RateSchedulerSim sim;
+  CHECK(sim.add(RG_FAST, exec_fixed, &fast_exec));
+  CHECK(sim.add(RG_FLOW, exec_fixed, &flow_exec));
+  CHECK(sim.add(RG_SLOW, exec_slow));
+  sim.run_for(5 * 1000000);
+
+  CHECK(RG_FLOW.core == RG_FAST.core && RG_FLOW.priority < RG_FAST.priority);
+  CHECK(RG_FLOW.priority > RG_SLOW.priority);
+
+  // Fast untouched, flow late by at most one fast job, never by a ToF stall
+  CHECK(sim.stats(0).max_start_lat_us == 0);
+  CHECK(sim.stats(0).deadline_misses == 0);
+  const RateGroupStats& fl = sim.stats(1);
+  CHECK(fl.runs >= 5 * FLOW_HZ - 1);
+  CHECK(fl.deadline_misses == 0 && fl.overruns == 0);
+  CHECK(fl.max_start_lat_us <= fast_exec);
+  CHECK(sim.stats(2).deadline_misses == 0);
+}
+
+static void test_jitter_from_preemption() {
+  // Equal-period groups on one core: the lower one starts late by the
+  // higher one's execution time every period.
+  RateGroupDef hi = RG_FAST, lo = RG_FAST;
+  lo.priority = hi.priority - 1;
+  uint32_t hi_exec = 700, lo_exec = 300;
+
+  RateSchedulerSim sim;
+  CHECK(sim.add(hi, exec_fixed, &hi_exec));
+  CHECK(sim.add(lo, exec_fixed, &lo_exec));
+  sim.run_for(100000);
+
+  CHECK(sim.stats(0).max_start_lat_us == 0);
+  CHECK(sim.stats(1).max_start_lat_us == hi_exec);
+  CHECK(sim.stats(1).max_response_us == hi_exec + lo_exec);
+  CHECK(sim.preemptions(1) == 0);  // never started before hi was done
+}
+
+int main() {
+  test_fast_not_delayed_by_slower_groups();
+  test_cores_are_independent();
+  test_overrun_accounting();
+  test_flow_group_on_control_core();
+  test_jitter_from_preemption();
+  return TEST_RESULT();
+}
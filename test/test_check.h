@@ -0,0 +1,29 @@
+#pragma once
+#include <stdio.h>
+
+// Minimal check helpers for the host tests (no framework dependency).
+// Each test binary returns non-zero if any CHECK failed.
+
+static int g_check_failures = 0;
+
+#define CHECK(cond)                                                        \
+  do {                                                                     \
+    if (!(cond)) {                                                         \
+      printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);               \
+      g_check_failures++;                                                  \
+    }                                                                      \
+  } while (0)
+
+#define CHECK_NEAR(a, b, tol)                                              \
+  do {                                                                     \
+    const double _a = (double)(a), _b = (double)(b);                       \
+    if (!(_a - _b <= (tol) && _b - _a <= (tol))) {                         \
+      printf("FAIL %s:%d: %s=%g vs %s=%g (tol %g)\n", __FILE__, __LINE__,  \
+             #a, _a, #b, _b, (double)(tol));                               \
+      g_check_failures++;                                                  \
+    }                                                                      \
+  } while (0)
+
+#define TEST_RESULT()                                                      \
+  (printf("%s: %s\n", __FILE__, g_check_failures ? "FAILED" : "OK"),       \
+   g_check_failures ? 1 : 0)
@@ -0,0 +1,89 @@
+// Host tests for TofProfileSelector with the firmware's profile table:
+// climbing and descending through the near/far boundary, no flapping
+// inside the hysteresis band, stepping out when short mode loses the floor.
+#include "test_check.h"
+#include "config/tof_config.h"
+
+static const int NEAR = 0, FAR = 1;
+
+static void test_table()
+{
+  CHECK(TOF_PROFILE_COUNT == 2);
+  CHECK(TOF_PROFILES[NEAR].mode == TofDistanceMode::SHORT);
+  CHECK(TOF_PROFILES[FAR].mode == TofDistanceMode::LONG);
+  // Hysteresis: step out above near.max, back in below far.min < near.max
+  CHECK(TOF_PROFILES[FAR].min_mm < TOF_PROFILES[NEAR].max_mm);
+  CHECK(TOF_PROFILES[NEAR].slots == 1);
+}
+
+static void test_climb_and_descend()
+{
+  TofProfileSelector s(TOF_PROFILES, TOF_PROFILE_COUNT);
+  CHECK(s.current() == NEAR);
+
+  // Climb 0.2 -> 3 m at 20 mm a result
+  int out_at = -1;
+  for (int mm = 200; mm <= 3000; mm += 20) {
+    if (s.update(true, (uint16_t)mm)) {
+      CHECK(out_at < 0);
+      out_at = mm;
+    }
+  }
+  CHECK(s.current() == FAR && s.switches() == 1);
+  // Third result above max_mm (1120, 1140, 1160)
+  CHECK(out_at == TOF_PROFILES[NEAR].max_mm + 3 * 20);
+
+  // And back down
+  int in_at = -1;
+  for (int mm = 3000; mm >= 200; mm -= 20) {
+    if (s.update(true, (uint16_t)mm)) in_at = mm;
+  }
+  CHECK(s.current() == NEAR && s.switches() == 2);
+  CHECK(in_at == TOF_PROFILES[FAR].min_mm - 3 * 20);
+}
+
+static void test_no_flapping_in_band()
+{
+  // Hovering at 1 m with +-80 mm of noise: stays where it is
+  TofProfileSelector s(TOF_PROFILES, TOF_PROFILE_COUNT);
+  uint32_t x = 12345;
+  for (int i = 0; i < 2000; i++) {
+    x = x * 1103515245u + 12345u;
+    const int mm = 1000 + (int)((x >> 16) % 161) - 80;
+    s.update(true, (uint16_t)mm);
+  }
+  CHECK(s.switches() == 0 && s.current() == NEAR);
+
+  // Single spikes past the edges don't count either
+  for (int i = 0; i < 100; i++) {
+    s.update(true, (i % 3 == 0) ? 1500 : 1000);
+  }
+  CHECK(s.switches() == 0);
+}
+
+static void test_lost_target_steps_out()
+{
+  TofProfileSelector s(TOF_PROFILES, TOF_PROFILE_COUNT);
+  s.update(true, 900);
+  for (int i = 0; i < TofProfileSelector::NO_TARGET - 1; i++) CHECK(!s.update(false, 0));
+  CHECK(s.update(false, 0));
+  CHECK(s.current() == FAR);
+
+  // Nothing in long mode either: stays on far
+  for (int i = 0; i < 50; i++) CHECK(!s.update(false, 0));
+  CHECK(s.current() == FAR && s.switches() == 1);
+
+  // A valid result resets the count
+  TofProfileSelector t(TOF_PROFILES, TOF_PROFILE_COUNT);
+  for (int i = 0; i < 20; i++) t.update(i % 4 != 0, 500);
+  CHECK(t.current() == NEAR);
+}
+
+int main()
+{
+  test_table();
+  test_climb_and_descend();
+  test_no_flapping_in_band();
+  test_lost_target_steps_out();
+  return TEST_RESULT();
+}
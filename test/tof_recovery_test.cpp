@@ -0,0 +1,263 @@
+// Host tests for TofRecovery: a fake VL53L3 that boots (or doesn't) after
+// XSHUT goes high, stepped once per 25 ms slow tick the way
+// TofVl53L3::read() steps it. Then two of them sharing the bus and the
+// default address.
+#include "test_check.h"
+#include "sensors/tof/tof_recovery.h"
+
+static const uint32_t TICK = 25000;     // slow group at 40 Hz
+
+struct FakeTof : TofRecoveryIo {
+  bool high = true;
+  uint32_t now = 0;
+  uint32_t high_at = 0;
+  int dead_attempts = 0;        // power-ups that never answer
+  bool init_fails = false;
+  int io_calls = 0;             // I2C work done in the current step
+  int powerups = 0;
+  uint32_t powerup_us[16] = {};
+
+  void xshut(bool h) override
+  {
+    if (h && !high) {
+      high_at = now;
+      if (powerups < 16) powerup_us[powerups] = now;
+      powerups++;
+    }
+    high = h;
+  }
+  bool boot_and_address() override
+  {
+    io_calls++;
+    // tBOOT 1.2 ms, and only once the dead attempts are used up
+    return high && powerups > dead_attempts && now - high_at >= 1200;
+  }
+  bool data_init() override { io_calls++; return !init_fails; }
+  bool configure() override { io_calls++; return true; }
+};
+
+// Steps until recovered or ticks run out; returns the tick it finished on
+static int run(TofRecovery& r, FakeTof& f, uint32_t t0, int ticks, int& max_io)
+{
+  max_io = 0;
+  for (int k = 1; k <= ticks; k++) {
+    f.now = t0 + (uint32_t)k * TICK;
+    f.io_calls = 0;
+    const bool done = r.step(f, f.now);
+    if (f.io_calls > max_io) max_io = f.io_calls;
+    if (done) return k;
+  }
+  return -1;
+}
+
+static void test_recovers_in_a_few_ticks()
+{
+  TofRecovery r;
+  FakeTof f;
+  const uint32_t t0 = 4294000000u;    // across the micros() wrap
+  f.now = t0;
+  r.start(f, t0);
+  CHECK(r.active() && !f.high && r.state() == TofRecState::RESET);
+
+  int max_io;
+  const int k = run(r, f, t0, 100, max_io);
+  // reset -> boot -> init -> config: one tick each
+  CHECK(k == 4);
+  CHECK(!r.active() && f.high);
+  CHECK(max_io <= 1);                 // one bounded exchange per tick
+  CHECK(r.stats().started == 1 && r.stats().recovered == 1);
+  CHECK(r.stats().failed_attempts == 0);
+  CHECK(r.stats().last_us == 4 * TICK && r.stats().max_us == 4 * TICK);
+
+  // Idle again: steps do nothing, a second start works the same way
+  CHECK(!r.step(f, f.now + TICK));
+  f.now += 2 * TICK;
+  r.start(f, f.now);
+  CHECK(run(r, f, f.now, 100, max_io) == 4);
+  CHECK(r.stats().started == 2 && r.stats().recovered == 2);
+}
+
+static void test_dead_sensor_backs_off()
+{
+  TofRecovery r;
+  FakeTof f;
+  f.dead_attempts = 100;
+  f.now = 1000;
+  r.start(f, f.now);
+
+  int max_io;
+  CHECK(run(r, f, 1000, 40 * 30, max_io) == -1);    // 30 s
+  CHECK(r.active() && max_io <= 1);
+  CHECK(r.stats().recovered == 0);
+
+  // Power-ups 1 s, 2 s, 4 s, 8 s, 8 s ... apart (plus the attempt itself)
+  CHECK(f.powerups >= 5 && f.powerups <= 7);
+  const uint32_t expect[] = { 1000000, 2000000, 4000000, 8000000, 8000000 };
+  for (int i = 0; i + 1 < f.powerups && i < 5; i++) {
+    const uint32_t gap = f.powerup_us[i + 1] - f.powerup_us[i];
+    CHECK(gap >= expect[i] && gap <= expect[i] + 10 * TICK);
+  }
+  CHECK(r.stats().failed_attempts >= 5);
+  CHECK(r.stats().boot_polls == r.stats().failed_attempts * TofRecovery::BOOT_TRIES);
+  CHECK(r.backoff_us() == TofRecovery::BACKOFF_MAX_US);
+
+  // Held in reset between attempts
+  if (r.state() == TofRecState::BACKOFF) CHECK(!f.high);
+}
+
+static void test_comes_back_later()
+{
+  TofRecovery r;
+  FakeTof f;
+  f.dead_attempts = 2;
+  f.now = 1000;
+  r.start(f, f.now);
+
+  int max_io;
+  const int k = run(r, f, 1000, 40 * 10, max_io);
+  CHECK(k > 0 && !r.active() && f.high);
+  CHECK(r.stats().failed_attempts == 2 && r.stats().recovered == 1);
+  // Two attempts and 1 s + 2 s of backoff before it answered
+  CHECK(r.stats().last_us >= 3000000 && r.stats().last_us < 3500000);
+
+  // Backoff starts over for the next stuck episode
+  f.now += TICK;
+  r.start(f, f.now);
+  CHECK(r.backoff_us() == TofRecovery::BACKOFF_US);
+}
+
+static void test_init_failure_retries()
+{
+  TofRecovery r;
+  FakeTof f;
+  f.init_fails = true;
+  f.now = 1000;
+  r.start(f, f.now);
+
+  int max_io;
+  CHECK(run(r, f, 1000, 8, max_io) == -1);
+  CHECK(r.state() == TofRecState::BACKOFF && !f.high);
+  CHECK(r.stats().failed_attempts == 1);
+
+  f.init_fails = false;
+  CHECK(run(r, f, f.now, 80, max_io) > 0);
+  CHECK(r.stats().recovered == 1);
+}
+
+// Two sensors on one bus, both 0x29 out of reset. peer_clear() does what
+// TofVl53L3 does: fine if the peer is in reset or on its own address,
+// otherwise puts it into reset and starts its recovery.
+struct PairTof : TofRecoveryIo {
+  bool high = true;
+  bool addressed = true;        // answering on its own address
+  uint32_t now = 0;
+  uint32_t high_at = 0;
+  int* collisions = nullptr;
+  PairTof* peer = nullptr;
+  TofRecovery* rec = nullptr;
+
+  bool at_default() const { return high && !addressed; }
+
+  void xshut(bool h) override
+  {
+    if (h && !high) high_at = now;
+    high = h;
+    addressed = false;
+  }
+  bool boot_and_address() override
+  {
+    if (!high || now - high_at < 1200) return false;
+    // SetDeviceAddress() goes to whoever sits on 0x29
+    if (peer->at_default()) (*collisions)++;
+    addressed = true;
+    return true;
+  }
+  bool data_init() override { return true; }
+  bool configure() override { return true; }
+  bool peer_clear() override
+  {
+    if (!peer->high || peer->addressed) return true;
+    peer->xshut(false);
+    peer->rec->start(*peer, now);
+    return true;
+  }
+};
+
+struct Pair {
+  TofRecoveryToken token;
+  TofRecovery rec[2];
+  PairTof tof[2];
+  int collisions = 0;
+  int both_default = 0;         // ticks that ended with both on 0x29
+
+  Pair()
+  {
+    for (int i = 0; i < 2; i++) {
+      rec[i].set_token(&token);
+      tof[i].collisions = &collisions;
+      tof[i].peer = &tof[1 - i];
+      tof[i].rec = &rec[i];
+    }
+  }
+  void tick(uint32_t now)
+  {
+    for (int i = 0; i < 2; i++) {
+      tof[i].now = now;
+      rec[i].step(tof[i], now);
+    }
+    if (tof[0].at_default() && tof[1].at_default()) both_default++;
+  }
+};
+
+static void test_two_sensors_take_turns()
+{
+  Pair p;
+  const uint32_t t0 = 1000;
+  for (int i = 0; i < 2; i++) {
+    p.tof[i].now = t0;
+    p.rec[i].start(p.tof[i], t0);
+  }
+
+  for (int k = 1; k <= 20; k++) p.tick(t0 + (uint32_t)k * TICK);
+  CHECK(p.collisions == 0 && p.both_default == 0);
+  for (int i = 0; i < 2; i++) {
+    CHECK(!p.rec[i].active() && p.tof[i].addressed);
+    CHECK(p.rec[i].stats().recovered == 1 && p.rec[i].stats().failed_attempts == 0);
+  }
+  // The second one waited for the first to reach its own address
+  CHECK(p.rec[0].stats().waits + p.rec[1].stats().waits > 0);
+  CHECK(p.token.owner() == nullptr);
+}
+
+static void test_brownout_peer_held_in_reset()
+{
+  Pair p;
+  // Both back on 0x29 after a brown-out; only one notices it's stuck
+  for (int i = 0; i < 2; i++) {
+    p.tof[i].high = true;
+    p.tof[i].addressed = false;
+  }
+  p.tof[0].now = 1000;
+  p.rec[0].start(p.tof[0], 1000);
+
+  for (int k = 1; k <= 20; k++) p.tick(1000 + (uint32_t)k * TICK);
+  CHECK(p.collisions == 0);
+  // The peer went into reset and came back through its own recovery
+  CHECK(p.rec[1].stats().started == 1);
+  for (int i = 0; i < 2; i++) {
+    CHECK(!p.rec[i].active() && p.tof[i].addressed);
+    CHECK(p.rec[i].stats().recovered == 1);
+  }
+  CHECK(p.token.owner() == nullptr);
+}
+
+int main()
+{
+  test_recovers_in_a_few_ticks();
+  test_dead_sensor_backs_off();
+  test_comes_back_later();
+  test_init_failure_retries();
+  test_two_sensors_take_turns();
+  test_brownout_peer_held_in_reset();
+  return TEST_RESULT();
+}
@@ -0,0 +1,131 @@
+// Host tests for TofStagger: two simulated VL53L3s driven the way
+// Sensors::slow_read() drives them (fetch what finished, then kick the
+// slot owner), checking rates, latency and that the ranges never overlap.
+#include "test_check.h"
+#include "sensors/tof/tof_stagger.h"
+
+static const uint32_t SLOT = 25000;     // slow group at 40 Hz
+static const uint32_t STUCK = 200000;
+
+// A sensor whose result is ready range_us after a kick; range_us = 0
+// never finishes (stuck)
+struct FakeTof {
+  uint32_t range_us;
+  bool ranging = false;
+  uint32_t ready_us = 0;
+
+  FakeTof(uint32_t r) : range_us(r) {}
+
+  void kick(uint32_t t) { ranging = true; ready_us = t + range_us; }
+  bool fetch(uint32_t now, uint32_t& ready)
+  {
+    if (!ranging || range_us == 0 || (int32_t)(now - ready_us) < 0) return false;
+    ranging = false;
+    ready = ready_us;
+    return true;
+  }
+};
+
+static void run(TofStagger& s, FakeTof* tof, int n, uint32_t t0, int ticks)
+{
+  for (int k = 0; k < ticks; k++) {
+    const uint32_t now = t0 + (uint32_t)k * SLOT;
+    for (int i = 0; i < n; i++) {
+      uint32_t ready;
+      if (s.enabled(i) && tof[i].fetch(now, ready)) s.fetched(i, ready, now + 300);
+    }
+    bool kick = false;
+    const int slot = s.tick(now + 300, kick);
+    if (kick) {
+      tof[slot].kick(now + 600);
+      s.kicked(slot, now + 600);
+    }
+  }
+}
+
+static void test_two_sensors_alternate()
+{
+  TofStagger s(2, STUCK);
+  FakeTof tof[2] = { {21000}, {21500} };
+  run(s, tof, 2, 4000000000u, 400);   // 10 s, across the micros() wrap
+
+  for (int i = 0; i < 2; i++) {
+    const TofChannelStats& st = s.stats(i);
+    CHECK(st.kicks >= 199 && st.results >= 199);
+    CHECK_NEAR(st.rate_hz(), 20.0, 0.01);           // 1 / (2 x 25 ms)
+    CHECK(st.overlaps == 0 && st.slot_missed == 0 && st.timeouts == 0);
+    CHECK(st.max_lat_us <= SLOT - tof[i].range_us); // fetched the next tick
+    CHECK(st.last_range_us == tof[i].range_us);
+  }
+}
+
+static void test_one_sensor_takes_every_slot()
+{
+  // Front failed begin(): down ranges every tick, twice the rate
+  TofStagger s(2, STUCK);
+  s.enable(1, false);
+  FakeTof tof[2] = { {21000}, {21000} };
+  run(s, tof, 2, 1000, 200);
+  CHECK_NEAR(s.stats(0).rate_hz(), 40.0, 0.01);
+  CHECK(s.stats(1).kicks == 0 && s.stats(1).results == 0);
+  CHECK(s.stats(0).overlaps == 0);
+}
+
+static void test_two_slot_profile()
+{
+  // Down on the far profile (41 ms budget, two slots): it holds two slots
+  // a turn, both sensors at 1 / 75 ms, still no overlap
+  TofStagger s(2, STUCK);
+  s.set_slots(0, 2);
+  FakeTof tof[2] = { {46000}, {21000} };
+  run(s, tof, 2, 1000, 600);
+  CHECK_NEAR(s.stats(0).rate_hz(), 1e6 / 75000.0, 0.01);
+  CHECK_NEAR(s.stats(1).rate_hz(), 1e6 / 75000.0, 0.01);
+  CHECK(s.stats(0).overlaps == 0 && s.stats(1).overlaps == 0);
+  CHECK(s.stats(0).slot_missed == 0 && s.stats(1).slot_missed == 0);
+  CHECK(s.stats(0).max_lat_us <= 2 * SLOT - 46000);
+
+  // Back to near (as Sensors::slow_read() does it: budget and slots
+  // together); takes effect from the next turn
+  s.set_slots(0, 1);
+  tof[0].range_us = 21000;
+  run(s, tof, 2, 1000 + 600 * SLOT, 400);
+  CHECK_NEAR(s.stats(0).rate_hz(), 20.0, 0.05);
+  CHECK(s.stats(0).overlaps == 0 && s.stats(1).overlaps == 0);
+}
+
+static void test_budget_too_long()
+{
+  // Range longer than a slot: the owner is still busy when its slot comes
+  // back after the other sensor's, so it skips turns; ranges overlap
+  TofStagger s(2, STUCK);
+  FakeTof tof[2] = { {60000}, {21000} };
+  run(s, tof, 2, 1000, 400);
+  CHECK(s.stats(0).slot_missed > 0);
+  CHECK(s.stats(0).overlaps > 0 || s.stats(1).overlaps > 0);
+  CHECK(s.stats(0).rate_hz() < 20.0f);
+}
+
+static void test_stuck_sensor_is_rekicked()
+{
+  TofStagger s(2, STUCK);
+  FakeTof tof[2] = { {0}, {21000} };
+  run(s, tof, 2, 1000, 400);
+  // Down gives no result: its slot is missed until STUCK, then kicked again
+  CHECK(s.stats(0).results == 0);
+  CHECK(s.stats(0).timeouts >= 38 && s.stats(0).timeouts <= 40);   // every 250 ms (next slot after 200 ms)
+  CHECK(s.stats(0).slot_missed > 0);
+  // Front keeps its own rate
+  CHECK_NEAR(s.stats(1).rate_hz(), 20.0, 0.01);
+  CHECK(s.stats(1).overlaps > 0);   // down is "ranging" the whole time
+}
+
+int main()
+{
+  test_two_sensors_alternate();
+  test_one_sensor_takes_every_slot();
+  test_two_slot_profile();
+  test_budget_too_long();
+  test_stuck_sensor_is_rekicked();
+  return TEST_RESULT();
+}
@@ -0,0 +1,97 @@
+// Host tests for the VL53L3 multi-target selector with the firmware's
+// down/front rules: glass, props, floor echo, noise.
+#include "test_check.h"
+#include "config/tof_config.h"
+
+static TofTarget tgt(uint16_t mm, float mcps, float sigma = 5.0f, uint8_t status = 0)
+{
+  TofTarget t;
+  t.range_mm = mm;
+  t.signal_mcps = mcps;
+  t.sigma_mm = sigma;
+  t.status = status;
+  return t;
+}
+
+static void test_single_target_like_before()
+{
+  // Old gating: status 0, 20..4000 mm
+  const TofTargetRules old_rules = {20, 4000, 0.0f, 1e6f, 0, 0, 0.0f};
+  TofTarget t[1] = { tgt(850, 3.0f) };
+  CHECK(tof_select_target(t, 1, old_rules) == 0);
+  t[0] = tgt(850, 3.0f, 5.0f, 4);
+  CHECK(tof_select_target(t, 1, old_rules) == -1 && t[0].reject == TofTargetReject::STATUS);
+  t[0] = tgt(15, 3.0f);
+  CHECK(tof_select_target(t, 1, old_rules) == -1 && t[0].reject == TofTargetReject::GLASS);
+  t[0] = tgt(8191, 3.0f);
+  CHECK(tof_select_target(t, 1, old_rules) == -1 && t[0].reject == TofTargetReject::FAR);
+  CHECK(tof_select_target(t, 0, old_rules) == -1);
+}
+
+static void test_glass_and_floor()
+{
+  // Smudged cover: strong return at 8 mm, floor at 600
+  TofTarget t[2] = { tgt(8, 20.0f), tgt(600, 4.0f) };
+  CHECK(tof_select_target(t, 2, TOF_TARGETS_DOWN) == 1);
+  CHECK(t[0].reject == TofTargetReject::GLASS && t[1].reject == TofTargetReject::NONE);
+}
+
+static void test_floor_echo()
+{
+  // Low hover over a shiny floor: floor at 180, its second bounce at ~365
+  TofTarget t[2] = { tgt(180, 12.0f), tgt(365, 1.5f) };
+  CHECK(tof_select_target(t, 2, TOF_TARGETS_DOWN) == 0);
+  CHECK(t[1].reject == TofTargetReject::ECHO);
+
+  // Echo listed first still loses to the real floor
+  TofTarget u[2] = { tgt(365, 1.5f), tgt(180, 12.0f) };
+  CHECK(tof_select_target(u, 2, TOF_TARGETS_DOWN) == 1);
+  CHECK(u[0].reject == TofTargetReject::ECHO);
+
+  // A table edge at 1.3x, or a stronger far target, is not an echo
+  TofTarget v[2] = { tgt(180, 12.0f), tgt(240, 2.0f) };
+  CHECK(tof_select_target(v, 2, TOF_TARGETS_DOWN) == 0);
+  CHECK(v[1].reject == TofTargetReject::NONE);
+  TofTarget w[2] = { tgt(180, 2.0f), tgt(360, 9.0f) };
+  tof_select_target(w, 2, TOF_TARGETS_DOWN);
+  CHECK(w[1].reject == TofTargetReject::NONE);
+}
+
+static void test_props()
+{
+  // Front: blade tip at 60 mm, wall at 1.4 m -> the wall
+  TofTarget t[2] = { tgt(60, 2.0f), tgt(1400, 0.8f) };
+  CHECK(tof_select_target(t, 2, TOF_TARGETS_FRONT) == 1);
+  CHECK(t[0].reject == TofTargetReject::PROP);
+
+  // Only something in the prop band: could be a real obstacle, kept
+  TofTarget u[1] = { tgt(60, 2.0f) };
+  CHECK(tof_select_target(u, 1, TOF_TARGETS_FRONT) == 0);
+
+  // Down has no prop band: 60 mm is the floor (landing)
+  TofTarget v[2] = { tgt(60, 2.0f), tgt(1400, 0.8f) };
+  CHECK(tof_select_target(v, 2, TOF_TARGETS_DOWN) == 0);
+}
+
+static void test_noise()
+{
+  TofTarget t[3] = { tgt(300, 0.02f), tgt(450, 1.0f, 90.0f), tgt(900, 1.0f) };
+  CHECK(tof_select_target(t, 3, TOF_TARGETS_DOWN) == 2);
+  CHECK(t[0].reject == TofTargetReject::WEAK);
+  CHECK(t[1].reject == TofTargetReject::SIGMA);
+
+  // Nearest survivor wins regardless of order
+  TofTarget u[3] = { tgt(2000, 0.5f), tgt(900, 1.0f, 5.0f, 7), tgt(1200, 2.0f) };
+  CHECK(tof_select_target(u, 3, TOF_TARGETS_DOWN) == 2);
+  CHECK(u[1].reject == TofTargetReject::STATUS);
+}
+
+int main()
+{
+  test_single_target_like_before();
+  test_glass_and_floor();
+  test_floor_echo();
+  test_props();
+  test_noise();
+  return TEST_RESULT();
+}
@@ -0,0 +1,171 @@
+#!/usr/bin/env python3
+"""Decode PMW3901 raw frames streamed by the firmware (FLOW_FRAME_CAPTURE).
+
+Wire format: src/sensors/flow/pmw3901_frame.h. Packets arrive on the serial
+console between the text lines (send 'f' for one frame, 'F' to toggle one
+per second), or one per UDP datagram.
+
+  flow_frame_view.py --serial /dev/ttyACM0 --stream --out frames/
+  flow_frame_view.py --udp 14560 --out frames/
+  flow_frame_view.py --file capture.bin          # raw serial log
+
+Each frame is printed as a coarse ASCII preview plus stats, and with --out
+saved as an 8-bit PGM (viewable almost anywhere). Text lines from the
+firmware are echoed unless --quiet.
+"""
+import argparse
+import os
+import socket
+import struct
+import sys
+
+MAGIC = b"PF"
+VERSION = 1
+HEADER = struct.Struct("<2sBBBBHIHH")   # FlowFrameHeader, 16 bytes
+W = 35
+PIXELS = W * W
+PACKET = HEADER.size + PIXELS + 2
+
+
+def crc16(data, crc=0xFFFF):
+    """CRC-16/CCITT-FALSE, same as flow_frame_crc16()."""
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def decode(pkt):
+    """One packet -> dict, or None if it doesn't check out."""
+    if len(pkt) < PACKET:
+        return None
+    magic, ver, w, h, squal, seq, t_us, shutter, grab8 = HEADER.unpack_from(pkt)
+    if magic != MAGIC or ver != VERSION or w != W or h != W:
+        return None
+    body = HEADER.size + PIXELS
+    if crc16(pkt[:body]) != (pkt[body] | pkt[body + 1] << 8):
+        return None
+    return dict(seq=seq, t_us=t_us, squal=squal, shutter=shutter,
+                grab_us=grab8 * 8, px=bytes(pkt[HEADER.size:body]))
+
+
+class StreamSplitter:
+    """Separates frame packets from text in a serial byte stream."""
+
+    def __init__(self, on_frame, on_text):
+        self.buf = bytearray()
+        self.on_frame = on_frame
+        self.on_text = on_text
+        self.bad = 0
+
+    def feed(self, data):
+        self.buf += data
+        while True:
+            i = self.buf.find(MAGIC)
+            text_end = i if i >= 0 else max(len(self.buf) - 1, 0)
+            self._text(self.buf[:text_end])
+            del self.buf[:text_end]
+            if i < 0 or len(self.buf) < PACKET:
+                return
+            f = decode(self.buf[:PACKET])
+            if f is None:
+                # "PF" inside text, or a damaged packet: skip the magic
+                self.bad += 1
+                self._text(self.buf[:2])
+                del self.buf[:2]
+                continue
+            self.on_frame(f)
+            del self.buf[:PACKET]
+
+    def _text(self, b):
+        if b:
+            self.on_text(bytes(b))
+
+
+RAMP = " .:-=+*#%@"
+
+
+def preview(f):
+    px = f["px"]
+    lo, hi = min(px), max(px)
+    span = max(hi - lo, 1)
+    mean = sum(px) / PIXELS
+    print(f"[frame {f['seq']}] t={f['t_us']}us squal={f['squal']} shutter={f['shutter']} "
+          f"grab={f['grab_us'] / 1000:.1f}ms min={lo} max={hi} mean={mean:.1f}")
+    for y in range(W):
+        row = px[y * W:(y + 1) * W]
+        print("  " + "".join(RAMP[(v - lo) * (len(RAMP) - 1) // span] * 2 for v in row))
+
+
+def save_pgm(f, out_dir):
+    os.makedirs(out_dir, exist_ok=True)
+    path = os.path.join(out_dir, f"flow_{f['seq']:05d}_{f['t_us']}.pgm")
+    with open(path, "wb") as fh:
+        fh.write(b"P5\n%d %d\n255\n" % (W, W))
+        fh.write(f["px"])
+    return path
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    src = ap.add_mutually_exclusive_group(required=True)
+    src.add_argument("--serial", help="serial port")
+    src.add_argument("--udp", type=int, help="UDP port to listen on")
+    src.add_argument("--file", help="raw serial log to decode")
+    ap.add_argument("--baud", type=int, default=115200)
+    ap.add_argument("--stream", action="store_true", help="serial: ask for a frame every second ('F')")
+    ap.add_argument("--count", type=int, default=0, help="stop after N frames")
+    ap.add_argument("--out", help="directory for PGM files")
+    ap.add_argument("--no-preview", action="store_true")
+    ap.add_argument("--quiet", action="store_true", help="don't echo firmware text")
+    args = ap.parse_args()
+
+    frames = [0]
+
+    def on_frame(f):
+        frames[0] += 1
+        if not args.no_preview:
+            preview(f)
+        if args.out:
+            print(f"  -> {save_pgm(f, args.out)}")
+
+    def on_text(b):
+        if not args.quiet:
+            sys.stdout.write(b.decode("utf-8", "replace"))
+
+    done = lambda: args.count and frames[0] >= args.count
+    split = StreamSplitter(on_frame, on_text)
+
+    if args.file:
+        with open(args.file, "rb") as fh:
+            split.feed(fh.read())
+    elif args.udp is not None:
+        sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        sock.bind(("", args.udp))
+        while not done():
+            pkt, _ = sock.recvfrom(2048)
+            f = decode(pkt)
+            if f:
+                on_frame(f)
+            else:
+                split.bad += 1
+    else:
+        import serial  # pyserial
+        port = serial.Serial(args.serial, args.baud, timeout=0.2)
+        port.write(b"F" if args.stream else b"f")
+        try:
+            while not done():
+                split.feed(port.read(4096))
+        except KeyboardInterrupt:
+            pass
+        finally:
+            if args.stream:
+                port.write(b"F")
+
+    print(f"\n{frames[0]} frames, {split.bad} bad packets", file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()